@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+/**
+ * Micro-benchmark comparing the generic Matrix4::transformXY/XY0 templates
+ * with the SIMD overloads used for Vector2 sources, and with
+ * transformXYStrided for an interleaved sprite vertex layout. Build from the repository
+ * root with something like:
+ *
+ *   c++ -std=c++17 -O2 -Isrc extra/benchmarks/matrix_transform.cpp src/common/Matrix.cpp -o matrix_transform
+ **/
+
+#include "common/Matrix.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace love;
+
+// Same layout as graphics::XYf_STf_RGBAub.
+struct SpriteVertex
+{
+	float x, y;
+	float s, t;
+	unsigned int color;
+};
+
+template <typename F>
+static double timeMS(int iterations, F func)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++)
+		func();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char **argv)
+{
+	int count = argc > 1 ? atoi(argv[1]) : 4096;
+	int iterations = argc > 2 ? atoi(argv[2]) : 20000;
+
+	Matrix4 m(10.0f, 20.0f, 0.3f, 1.5f, 0.75f, 4.0f, 2.0f, 0.1f, 0.0f);
+
+	std::vector<Vector2> src(count);
+	for (int i = 0; i < count; i++)
+		src[i] = Vector2((float) (i % 640), (float) (i / 640));
+
+	std::vector<Vector2> dst2a(count), dst2b(count);
+	std::vector<Vector3> dst3a(count), dst3b(count);
+	std::vector<SpriteVertex> dstsa(count), dstsb(count);
+
+	// Warm up and verify the results match before timing anything.
+	m.transformXY<Vector2, Vector2>(dst2a.data(), src.data(), count);
+	m.transformXY(dst2b.data(), src.data(), count);
+	m.transformXY0<Vector3, Vector2>(dst3a.data(), src.data(), count);
+	m.transformXY0(dst3b.data(), src.data(), count);
+	m.transformXY<SpriteVertex, Vector2>(dstsa.data(), src.data(), count);
+	m.transformXYStrided(dstsb.data(), sizeof(SpriteVertex), src.data(), sizeof(Vector2), count);
+
+	for (int i = 0; i < count; i++)
+	{
+		if (dst2a[i].x != dst2b[i].x || dst2a[i].y != dst2b[i].y || dst3a[i].x != dst3b[i].x || dst3a[i].y != dst3b[i].y || dst3a[i].z != dst3b[i].z || dstsa[i].x != dstsb[i].x || dstsa[i].y != dstsb[i].y)
+		{
+			printf("Mismatch at vertex %d\n", i);
+			return 1;
+		}
+	}
+
+	double xyGeneric = timeMS(iterations, [&]() { m.transformXY<Vector2, Vector2>(dst2a.data(), src.data(), count); });
+	double xySIMD = timeMS(iterations, [&]() { m.transformXY(dst2b.data(), src.data(), count); });
+	double xy0Generic = timeMS(iterations, [&]() { m.transformXY0<Vector3, Vector2>(dst3a.data(), src.data(), count); });
+	double xy0SIMD = timeMS(iterations, [&]() { m.transformXY0(dst3b.data(), src.data(), count); });
+	double stridedGeneric = timeMS(iterations, [&]() { m.transformXY<SpriteVertex, Vector2>(dstsa.data(), src.data(), count); });
+	double stridedSIMD = timeMS(iterations, [&]() { m.transformXYStrided(dstsb.data(), sizeof(SpriteVertex), src.data(), sizeof(Vector2), count); });
+
+	// Keep the optimizer from discarding the work.
+	volatile float sink = dst2a[count / 2].x + dst2b[count / 3].y + dst3a[count / 4].z + dst3b[count / 5].x + dstsa[count / 6].x + dstsb[count / 7].y;
+	(void) sink;
+
+	printf("%d vertices x %d iterations\n", count, iterations);
+	printf("transformXY   generic: %8.2f ms  simd: %8.2f ms  (%.2fx)\n", xyGeneric, xySIMD, xyGeneric / xySIMD);
+	printf("transformXY0  generic: %8.2f ms  simd: %8.2f ms  (%.2fx)\n", xy0Generic, xy0SIMD, xy0Generic / xy0SIMD);
+	printf("strided       generic: %8.2f ms  simd: %8.2f ms  (%.2fx)\n", stridedGeneric, stridedSIMD, stridedGeneric / stridedSIMD);
+
+	return 0;
+}
@@ -20,6 +20,7 @@
 
 #include "Matrix.h"
 #include "common/config.h"
+#include "common/int.h"
 
 // STD
 #include <cstring> // memcpy
@@ -45,6 +46,75 @@ namespace love
 // | e2 e6 e10 e14 |
 // | e3 e7 e11 e15 |
 
+// Shared by Matrix4 and Matrix3: x' = a*x + c*y + tx, y' = b*x + d*y + ty for
+// the leading two floats of each vertex in an interleaved array.
+static void transformXYStrided(float a, float b, float c, float d, float tx, float ty, void *dst, size_t dststride, const void *src, size_t srcstride, int size)
+{
+	uint8 *dstbytes = (uint8 *) dst;
+	const uint8 *srcbytes = (const uint8 *) src;
+
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	// Two vertices per iteration: [x0 y0 x1 y1]. Both are loaded before
+	// anything is stored, so src and dst may be the same.
+	const __m128 col0 = _mm_setr_ps(a, b, a, b);
+	const __m128 col1 = _mm_setr_ps(c, d, c, d);
+	const __m128 col3 = _mm_setr_ps(tx, ty, tx, ty);
+
+	for (; i + 2 <= size; i += 2)
+	{
+		const uint8 *sp = srcbytes + srcstride * i;
+		uint8 *dp = dstbytes + dststride * i;
+
+		__m128 v = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *) sp);
+		v = _mm_loadh_pi(v, (const __m64 *) (sp + srcstride));
+		__m128 xs = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+		__m128 ys = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+
+		__m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col0, xs), _mm_mul_ps(col1, ys)), col3);
+		_mm_storel_pi((__m64 *) dp, r);
+		_mm_storeh_pi((__m64 *) (dp + dststride), r);
+	}
+
+#elif defined(LOVE_SIMD_NEON)
+
+	const float col0v[4] = {a, b, a, b};
+	const float col1v[4] = {c, d, c, d};
+	const float col3v[4] = {tx, ty, tx, ty};
+	const float32x4_t col0 = vld1q_f32(col0v);
+	const float32x4_t col1 = vld1q_f32(col1v);
+	const float32x4_t col3 = vld1q_f32(col3v);
+
+	for (; i + 2 <= size; i += 2)
+	{
+		const uint8 *sp = srcbytes + srcstride * i;
+		uint8 *dp = dstbytes + dststride * i;
+
+		float32x4_t v = vcombine_f32(vld1_f32((const float *) sp), vld1_f32((const float *) (sp + srcstride)));
+		float32x4x2_t t = vtrnq_f32(v, v);
+
+		float32x4_t r = vaddq_f32(vaddq_f32(vmulq_f32(col0, t.val[0]), vmulq_f32(col1, t.val[1])), col3);
+		vst1_f32((float *) dp, vget_low_f32(r));
+		vst1_f32((float *) (dp + dststride), vget_high_f32(r));
+	}
+
+#endif
+
+	for (; i < size; i++)
+	{
+		const float *sv = (const float *) (srcbytes + srcstride * i);
+		float *dv = (float *) (dstbytes + dststride * i);
+
+		float x = (a*sv[0]) + (c*sv[1]) + (tx);
+		float y = (b*sv[0]) + (d*sv[1]) + (ty);
+
+		dv[0] = x;
+		dv[1] = y;
+	}
+}
+
 void Matrix4::multiply(const Matrix4 &a, const Matrix4 &b, float t[16])
 {
 #if defined(LOVE_SIMD_SSE)
@@ -309,6 +379,120 @@ void Matrix4::shear(float kx, float ky)
 	this->operator *=(t);
 }
 
+void Matrix4::transformXY(Vector2 *dst, const Vector2 *src, int size) const
+{
+	static_assert(sizeof(Vector2) == sizeof(float) * 2, "Vector2 must be tightly packed");
+
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	// Two vertices per iteration: [x0 y0 x1 y1]. Both are loaded before
+	// anything is stored, so src and dst may be the same.
+	const __m128 col0 = _mm_setr_ps(e[0], e[1], e[0], e[1]);
+	const __m128 col1 = _mm_setr_ps(e[4], e[5], e[4], e[5]);
+	const __m128 col3 = _mm_setr_ps(e[12], e[13], e[12], e[13]);
+
+	for (; i + 2 <= size; i += 2)
+	{
+		__m128 v = _mm_loadu_ps(&src[i].x);
+		__m128 xs = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+		__m128 ys = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+
+		__m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col0, xs), _mm_mul_ps(col1, ys)), col3);
+		_mm_storeu_ps(&dst[i].x, r);
+	}
+
+#elif defined(LOVE_SIMD_NEON)
+
+	// Four vertices per iteration, deinterleaved into x and y registers.
+	for (; i + 4 <= size; i += 4)
+	{
+		float32x4x2_t v = vld2q_f32(&src[i].x);
+
+		float32x4x2_t r;
+		r.val[0] = vaddq_f32(vaddq_f32(vmulq_n_f32(v.val[0], e[0]), vmulq_n_f32(v.val[1], e[4])), vdupq_n_f32(e[12]));
+		r.val[1] = vaddq_f32(vaddq_f32(vmulq_n_f32(v.val[0], e[1]), vmulq_n_f32(v.val[1], e[5])), vdupq_n_f32(e[13]));
+
+		vst2q_f32(&dst[i].x, r);
+	}
+
+#endif
+
+	for (; i < size; i++)
+	{
+		float x = (e[0]*src[i].x) + (e[4]*src[i].y) + (e[12]);
+		float y = (e[1]*src[i].x) + (e[5]*src[i].y) + (e[13]);
+
+		dst[i].x = x;
+		dst[i].y = y;
+	}
+}
+
+void Matrix4::transformXY0(Vector3 *dst, const Vector2 *src, int size) const
+{
+	static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3 must be tightly packed");
+
+	int i = 0;
+
+#if defined(LOVE_SIMD_SSE)
+
+	const __m128 col0 = _mm_setr_ps(e[0], e[1], e[2], 0.0f);
+	const __m128 col1 = _mm_setr_ps(e[4], e[5], e[6], 0.0f);
+	const __m128 col3 = _mm_setr_ps(e[12], e[13], e[14], 0.0f);
+
+	// Two vertices per iteration. The first result is stored as 4 floats, the
+	// last of which is overwritten by the second result's x.
+	for (; i + 2 <= size; i += 2)
+	{
+		__m128 v = _mm_loadu_ps(&src[i].x);
+
+		__m128 r0 = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(col0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0))),
+			_mm_mul_ps(col1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)))), col3);
+
+		__m128 r1 = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(col0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))),
+			_mm_mul_ps(col1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)))), col3);
+
+		_mm_storeu_ps(&dst[i].x, r0);
+		_mm_storel_pi((__m64 *) &dst[i + 1].x, r1);
+		_mm_store_ss(&dst[i + 1].z, _mm_movehl_ps(r1, r1));
+	}
+
+#elif defined(LOVE_SIMD_NEON)
+
+	for (; i + 4 <= size; i += 4)
+	{
+		float32x4x2_t v = vld2q_f32(&src[i].x);
+
+		float32x4x3_t r;
+		r.val[0] = vaddq_f32(vaddq_f32(vmulq_n_f32(v.val[0], e[0]), vmulq_n_f32(v.val[1], e[4])), vdupq_n_f32(e[12]));
+		r.val[1] = vaddq_f32(vaddq_f32(vmulq_n_f32(v.val[0], e[1]), vmulq_n_f32(v.val[1], e[5])), vdupq_n_f32(e[13]));
+		r.val[2] = vaddq_f32(vaddq_f32(vmulq_n_f32(v.val[0], e[2]), vmulq_n_f32(v.val[1], e[6])), vdupq_n_f32(e[14]));
+
+		vst3q_f32(&dst[i].x, r);
+	}
+
+#endif
+
+	for (; i < size; i++)
+	{
+		float x = (e[0]*src[i].x) + (e[4]*src[i].y) + (e[12]);
+		float y = (e[1]*src[i].x) + (e[5]*src[i].y) + (e[13]);
+		float z = (e[2]*src[i].x) + (e[6]*src[i].y) + (e[14]);
+
+		dst[i].x = x;
+		dst[i].y = y;
+		dst[i].z = z;
+	}
+}
+
+void Matrix4::transformXYStrided(void *dst, size_t dststride, const void *src, size_t srcstride, int size) const
+{
+	love::transformXYStrided(e[0], e[1], e[4], e[5], e[12], e[13], dst, dststride, src, srcstride, size);
+}
+
 bool Matrix4::isAffine2DTransform() const
 {
 	return fabsf(e[2] + e[3] + e[6] + e[7] + e[8] + e[9] + e[11] + e[14]) < 0.00001f
@@ -594,4 +778,9 @@ void Matrix3::setTransformation(float x, float y, float angle, float sx, float s
 	e[8] = 1.0f;
 }
 
+void Matrix3::transformXYStrided(void *dst, size_t dststride, const void *src, size_t srcstride, int size) const
+{
+	love::transformXYStrided(e[0], e[1], e[3], e[4], e[6], e[7], dst, dststride, src, srcstride, size);
+}
+
 } // love
@@ -211,6 +211,20 @@ class Matrix4
 	template <typename Vdst, typename Vsrc>
 	void transformXYZ(Vdst *dst, const Vsrc *src, int size) const;
 
+	/**
+	 * Overloads of the above for the common position-only vertex layouts,
+	 * which use SSE or NEON where available.
+	 **/
+	void transformXY(Vector2 *dst, const Vector2 *src, int size) const;
+	void transformXY0(Vector3 *dst, const Vector2 *src, int size) const;
+
+	/**
+	 * Transforms the leading float x, y pair of each vertex in an interleaved
+	 * array, using SSE or NEON where available. The strides are in bytes. The
+	 * source and destination arrays may be the same if their strides match.
+	 **/
+	void transformXYStrided(void *dst, size_t dststride, const void *src, size_t srcstride, int size) const;
+
 	/**
 	 * Gets whether this matrix is an affine 2D transform (if the only non-
 	 * identity elements are the upper-left 2x2 and 2 translation values in the
@@ -303,6 +317,12 @@ class Matrix3
 	template <typename Vdst, typename Vsrc>
 	void transformXY(Vdst *dst, const Vsrc *src, int size) const;
 
+	/**
+	 * Transforms the leading float x, y pair of each vertex in an interleaved
+	 * array. See Matrix4::transformXYStrided.
+	 **/
+	void transformXYStrided(void *dst, size_t dststride, const void *src, size_t srcstride, int size) const;
+
 private:
 
 	/**
@@ -87,6 +87,53 @@ void Audio::setPlaybackDevice(const char */*name*/)
 	throw love::Exception("Re-setting output device is not supported.");
 }
 
+void Audio::getRefillLatencyHistogram(std::vector<double> &limits, std::vector<uint64> &counts) const
+{
+	limits.clear();
+	counts.clear();
+}
+
+void Audio::resetRefillLatencyHistogram()
+{
+}
+
+int Audio::getVirtualSourceCount() const
+{
+	return 0;
+}
+
+int Audio::getMixBusSourceCount() const
+{
+	return 0;
+}
+
+void Audio::setMixBusEnabled(bool /*enable*/)
+{
+}
+
+bool Audio::isMixBusEnabled() const
+{
+	return false;
+}
+
+void Audio::setSourceTransforms(const std::vector<Source*> &sources, const float *transforms)
+{
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		float position[3];
+		float velocity[3];
+
+		for (int j = 0; j < 3; j++)
+		{
+			position[j] = transforms[i * 6 + j];
+			velocity[j] = transforms[i * 6 + 3 + j];
+		}
+
+		sources[i]->setPosition(position);
+		sources[i]->setVelocity(velocity);
+	}
+}
+
 StringMap<Audio::DistanceModel, Audio::DISTANCE_MAX_ENUM>::Entry Audio::distanceModelEntries[] =
 {
 	{"none", Audio::DISTANCE_NONE},
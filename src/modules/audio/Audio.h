@@ -27,6 +27,7 @@
 // LOVE
 #include "common/Module.h"
 #include "common/StringMap.h"
+#include "common/int.h"
 #include "Source.h"
 #include "Effect.h"
 #include "RecordingDevice.h"
@@ -309,6 +310,39 @@ class Audio : public Module
 	 */
 	virtual void setPlaybackDevice(const char *name);
 
+	/**
+	 * Gets how long streaming Sources waited to be refilled after one of their
+	 * buffers finished playing. Each count is for latencies up to the limit
+	 * (in seconds) at the same index, and the last count has no limit.
+	 */
+	virtual void getRefillLatencyHistogram(std::vector<double> &limits, std::vector<uint64> &counts) const;
+	virtual void resetRefillLatencyHistogram();
+
+	/**
+	 * Gets how many playing Sources are virtual: they keep track of their
+	 * position, but don't have a voice because more important Sources are
+	 * using all of them.
+	 */
+	virtual int getVirtualSourceCount() const;
+
+	/**
+	 * Gets how many virtual Sources are currently mixed on the mix bus.
+	 */
+	virtual int getMixBusSourceCount() const;
+
+	/**
+	 * Enables or disables a software bus which mixes quiet virtual Sources
+	 * into a single voice, so they can still be heard.
+	 */
+	virtual void setMixBusEnabled(bool enable);
+	virtual bool isMixBusEnabled() const;
+
+	/**
+	 * Sets the position and velocity of many Sources at once. The transforms
+	 * have 6 floats per Source: its position, followed by its velocity.
+	 */
+	virtual void setSourceTransforms(const std::vector<Source*> &sources, const float *transforms);
+
 protected:
 
 	Audio(const char *name);
@@ -109,6 +109,11 @@ class Source : public Object
 
 	virtual int getChannelCount() const = 0;
 
+	// Sources with a higher priority keep their voice over more audible ones
+	// with a lower priority, when there are more playing Sources than voices.
+	virtual void setPriority(float priority) = 0;
+	virtual float getPriority() const = 0;
+
 	virtual bool setFilter(const std::map<Filter::Parameter, float> &params) = 0;
 	virtual bool setFilter() = 0;
 	virtual bool getFilter(std::map<Filter::Parameter, float> &params) = 0;
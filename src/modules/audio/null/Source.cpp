@@ -164,6 +164,16 @@ bool Source::isLooping() const
 	return looping;
 }
 
+void Source::setPriority(float priority)
+{
+	this->priority = priority;
+}
+
+float Source::getPriority() const
+{
+	return priority;
+}
+
 void Source::setMinVolume(float volume)
 {
 	this->minVolume = volume;
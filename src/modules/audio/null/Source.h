@@ -65,6 +65,8 @@ class Source : public love::audio::Source
 	virtual bool isRelative() const;
 	void setLooping(bool looping);
 	bool isLooping() const;
+	virtual void setPriority(float priority);
+	virtual float getPriority() const;
 	virtual void setMinVolume(float volume);
 	virtual float getMinVolume() const;
 	virtual void setMaxVolume(float volume);
@@ -102,6 +104,7 @@ class Source : public love::audio::Source
 	float coneOuterHighGain;
 	bool relative;
 	bool looping;
+	float priority = 0.0f;
 	float minVolume;
 	float maxVolume;
 	float referenceDistance;
@@ -61,15 +61,21 @@ void Audio::PoolThread::threadFunction()
 			}
 		}
 
-		pool->update();
-		sleep(5);
+		// Sleep until a streaming Source needs more data or a Source is due to
+		// finish, instead of polling.
+		double delay = pool->update();
+		pool->waitForUpdate(delay);
 	}
 }
 
 void Audio::PoolThread::setFinish()
 {
-	thread::Lock lock(mutex);
-	finish = true;
+	{
+		thread::Lock lock(mutex);
+		finish = true;
+	}
+
+	pool->wake();
 }
 
 ALenum Audio::getFormat(int bitDepth, int channels)
@@ -360,6 +366,8 @@ void Audio::resumeContext()
 	if (context && alcGetCurrentContext() != context)
 		alcMakeContextCurrent(context);
 #endif
+
+	pool->wake();
 }
 
 std::string Audio::getPlaybackDevice()
@@ -408,6 +416,41 @@ void Audio::setPlaybackDevice(const char* name)
 		throw love::Exception("Cannot set output device: %s", alcGetString(device, alcGetError(device)));
 }
 
+void Audio::getRefillLatencyHistogram(std::vector<double> &limits, std::vector<uint64> &counts) const
+{
+	pool->getRefillLatencyHistogram(limits, counts);
+}
+
+void Audio::resetRefillLatencyHistogram()
+{
+	pool->resetRefillLatencyHistogram();
+}
+
+int Audio::getVirtualSourceCount() const
+{
+	return pool->getVirtualSourceCount();
+}
+
+int Audio::getMixBusSourceCount() const
+{
+	return pool->getMixBusSourceCount();
+}
+
+void Audio::setMixBusEnabled(bool enable)
+{
+	pool->setMixBusEnabled(enable);
+}
+
+bool Audio::isMixBusEnabled() const
+{
+	return pool->isMixBusEnabled();
+}
+
+void Audio::setSourceTransforms(const std::vector<love::audio::Source*> &sources, const float *transforms)
+{
+	Source::setTransforms(sources, transforms);
+}
+
 void Audio::setVolume(float volume)
 {
 	alListenerf(AL_GAIN, volume);
@@ -128,6 +128,15 @@ class Audio : public love::audio::Audio
 	void getPlaybackDevices(std::vector<std::string> &list);
 	void setPlaybackDevice(const char *name);
 
+	void getRefillLatencyHistogram(std::vector<double> &limits, std::vector<uint64> &counts) const override;
+	void resetRefillLatencyHistogram() override;
+
+	int getVirtualSourceCount() const override;
+	int getMixBusSourceCount() const override;
+	void setMixBusEnabled(bool enable) override;
+	bool isMixBusEnabled() const override;
+	void setSourceTransforms(const std::vector<love::audio::Source*> &sources, const float *transforms) override;
+
 private:
 	void initializeEFX();
 	// The OpenAL device.
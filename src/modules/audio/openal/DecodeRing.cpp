@@ -0,0 +1,298 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "DecodeRing.h"
+#include "common/Exception.h"
+
+// STD
+#include <algorithm>
+#include <cstring>
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+DecodeRing::DecodeRing(love::sound::Decoder *decoder, int chunkcount, const std::function<void()> &onready)
+	: decoder(decoder)
+	, chunks(std::max(chunkcount, 1))
+	, readIndex(0)
+	, writeIndex(0)
+	, generation(1)
+	, finishedGeneration(0)
+	, looping(false)
+	, scheduled(false)
+	, onReady(onready)
+	, consumerWaiting(false)
+	, decodeGeneration(1)
+	, resetPending(false)
+	, resetPosition(0.0)
+{
+	for (Chunk &chunk : chunks)
+		chunk.data.resize(decoder->getSize());
+}
+
+DecodeRing::~DecodeRing()
+{
+}
+
+const DecodeRing::Chunk *DecodeRing::peek()
+{
+	if (const Chunk *chunk = findChunk())
+		return chunk;
+
+	// The flag is set before checking again, so a chunk which is published
+	// after the second check sees it and calls onReady. Both this and the
+	// producer's writeIndex store are sequentially consistent.
+	consumerWaiting.store(true);
+	return findChunk();
+}
+
+const DecodeRing::Chunk *DecodeRing::findChunk()
+{
+	uint32 gen = generation.load();
+	uint64 read = readIndex.load(std::memory_order_relaxed);
+	uint64 write = writeIndex.load();
+
+	for (; read != write; read++)
+	{
+		const Chunk &chunk = chunks[read % chunks.size()];
+		if (chunk.generation == gen)
+		{
+			readIndex.store(read, std::memory_order_release);
+			return &chunk;
+		}
+	}
+
+	readIndex.store(read, std::memory_order_release);
+	return nullptr;
+}
+
+void DecodeRing::pop()
+{
+	readIndex.store(readIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+bool DecodeRing::hasChunks() const
+{
+	return readIndex.load() != writeIndex.load(std::memory_order_acquire);
+}
+
+bool DecodeRing::isFinished() const
+{
+	if (finishedGeneration.load(std::memory_order_acquire) != generation.load())
+		return false;
+
+	return readIndex.load() == writeIndex.load(std::memory_order_acquire);
+}
+
+void DecodeRing::requestReset(double seekposition)
+{
+	{
+		thread::Lock lock(requestMutex);
+		resetPending = true;
+		resetPosition = seekposition;
+		generation++;
+	}
+
+	// Everything decoded so far is stale now, so make room for new chunks.
+	readIndex.store(writeIndex.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+void DecodeRing::rewind()
+{
+	requestReset(-1.0);
+}
+
+void DecodeRing::seek(double seconds)
+{
+	requestReset(std::max(seconds, 0.0));
+}
+
+void DecodeRing::setLooping(bool looping)
+{
+	this->looping = looping;
+}
+
+bool DecodeRing::decodeChunk()
+{
+	// The decode mutex must be held by the caller.
+	bool reset = false;
+	double position = 0.0;
+
+	{
+		thread::Lock lock(requestMutex);
+		if (resetPending)
+		{
+			reset = true;
+			position = resetPosition;
+			resetPending = false;
+			decodeGeneration = generation.load();
+		}
+	}
+
+	if (reset)
+	{
+		if (position >= 0.0)
+			decoder->seek(position);
+		else
+			decoder->rewind();
+	}
+
+	if (finishedGeneration.load() == decodeGeneration)
+	{
+		// Looping might have been enabled after the end was reached.
+		if (!looping)
+			return false;
+
+		decoder->rewind();
+		finishedGeneration = 0;
+	}
+
+	uint64 write = writeIndex.load(std::memory_order_relaxed);
+	if (write - readIndex.load(std::memory_order_acquire) >= chunks.size())
+		return false;
+
+	Chunk &chunk = chunks[write % chunks.size()];
+
+	int decoded = std::max(decoder->decode(), 0);
+	if (decoded > (int) chunk.data.size())
+		chunk.data.resize(decoded);
+
+	if (decoded > 0)
+		memcpy(chunk.data.data(), decoder->getBuffer(), decoded);
+
+	chunk.size = decoded;
+	chunk.loopPoint = false;
+	chunk.generation = decodeGeneration;
+
+	bool finished = false;
+	if (decoder->isFinished())
+	{
+		if (looping)
+		{
+			decoder->rewind();
+			chunk.loopPoint = true;
+		}
+		else
+			finished = true;
+	}
+	else if (decoded == 0)
+		finished = true;
+
+	if (decoded > 0 || chunk.loopPoint)
+		writeIndex.store(write + 1);
+
+	if (finished)
+		finishedGeneration.store(decodeGeneration);
+
+	if ((decoded > 0 || chunk.loopPoint || finished) && consumerWaiting.exchange(false) && onReady)
+		onReady();
+
+	return !finished;
+}
+
+bool DecodeRing::needsDecode()
+{
+	{
+		thread::Lock lock(requestMutex);
+		if (resetPending)
+			return true;
+	}
+
+	if (finishedGeneration.load() == generation.load() && !looping)
+		return false;
+
+	return writeIndex.load() - readIndex.load() < chunks.size();
+}
+
+void DecodeRing::prime()
+{
+	while (peek() == nullptr)
+	{
+		thread::Lock lock(decodeMutex);
+		if (!decodeChunk())
+			break;
+	}
+}
+
+void DecodeRing::schedule(love::thread::WorkerPool *workers)
+{
+	if (!needsDecode() || scheduled.exchange(true))
+		return;
+
+	StrongRef<DecodeRing> ring(this);
+	workers->submit([ring, workers]() { ring->decodeJob(workers); });
+}
+
+void DecodeRing::decodeJob(love::thread::WorkerPool *workers)
+{
+	bool failed = false;
+
+	while (true)
+	{
+		thread::Lock lock(decodeMutex);
+
+		try
+		{
+			if (!decodeChunk())
+				break;
+		}
+		catch (...)
+		{
+			// Treat a broken stream (or any other failure, such as running
+			// out of memory for a chunk) as if it ended here. Nothing may
+			// escape this job, or scheduled would never be cleared.
+			finishedGeneration = decodeGeneration;
+			failed = true;
+			break;
+		}
+	}
+
+	scheduled = false;
+
+	// A consumer waiting for data has to find out that there won't be any.
+	if (failed && consumerWaiting.exchange(false) && onReady)
+		onReady();
+
+	// The consumer may have made room after the last decodeChunk call but
+	// before the flag was cleared, in which case its schedule call was
+	// ignored.
+	if (!failed)
+		schedule(workers);
+}
+
+double DecodeRing::getDuration()
+{
+	thread::Lock lock(decodeMutex);
+	return decoder->getDuration();
+}
+
+love::sound::Decoder *DecodeRing::cloneDecoder()
+{
+	thread::Lock lock(decodeMutex);
+	return decoder->clone();
+}
+
+} // openal
+} // audio
+} // love
@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_OPENAL_DECODE_RING_H
+#define LOVE_AUDIO_OPENAL_DECODE_RING_H
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "common/int.h"
+#include "sound/Decoder.h"
+#include "thread/threads.h"
+#include "thread/WorkerPool.h"
+
+// STD
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+/**
+ * Decodes a streaming Source's audio ahead of time on a worker thread, into a
+ * fixed number of chunks. One thread at a time (the one holding the Pool lock)
+ * consumes chunks without locking, so the decoder never runs while the Pool is
+ * locked except when a Source starts playing with nothing decoded yet.
+ **/
+class DecodeRing : public love::Object
+{
+public:
+
+	struct Chunk
+	{
+		std::vector<uint8> data;
+		int size = 0;
+
+		// The decoder reached the end of the stream and was rewound after
+		// this chunk, because the Source is looping.
+		bool loopPoint = false;
+
+		uint32 generation = 0;
+	};
+
+	/**
+	 * The callback is called on the decode thread when a chunk is ready after
+	 * the consumer found none.
+	 **/
+	DecodeRing(love::sound::Decoder *decoder, int chunkcount, const std::function<void()> &onready);
+	virtual ~DecodeRing();
+
+	/**
+	 * Gets the oldest decoded chunk, or null if none are ready. Must be called
+	 * with the Pool locked, like every other consumer method.
+	 **/
+	const Chunk *peek();
+	void pop();
+
+	/**
+	 * Whether any chunks are waiting to be consumed. They may still be from
+	 * before the last rewind or seek.
+	 **/
+	bool hasChunks() const;
+
+	/**
+	 * Whether every chunk up to the end of the stream has been consumed.
+	 **/
+	bool isFinished() const;
+
+	/**
+	 * Discard decoded chunks, and make the decoder restart from the beginning
+	 * or from the given position. The decoder is moved on the decode thread.
+	 **/
+	void rewind();
+	void seek(double seconds);
+
+	void setLooping(bool looping);
+
+	/**
+	 * Decodes on the calling thread until a chunk is ready, for when a Source
+	 * starts playing before the worker has caught up.
+	 **/
+	void prime();
+
+	/**
+	 * Queues a job to fill the ring on the given worker pool, unless one is
+	 * already queued or running.
+	 **/
+	void schedule(love::thread::WorkerPool *workers);
+
+	double getDuration();
+	love::sound::Decoder *cloneDecoder();
+
+private:
+
+	const Chunk *findChunk();
+	void decodeJob(love::thread::WorkerPool *workers);
+	bool decodeChunk();
+	bool needsDecode();
+	void requestReset(double seekposition);
+
+	StrongRef<love::sound::Decoder> decoder;
+
+	std::vector<Chunk> chunks;
+
+	// Both only ever increase. The consumer owns readIndex and the producer
+	// owns writeIndex.
+	std::atomic<uint64> readIndex;
+	std::atomic<uint64> writeIndex;
+
+	// Chunks from an older generation were decoded before the last rewind or
+	// seek, and are skipped.
+	std::atomic<uint32> generation;
+	std::atomic<uint32> finishedGeneration;
+
+	std::atomic<bool> looping;
+	std::atomic<bool> scheduled;
+
+	std::function<void()> onReady;
+	std::atomic<bool> consumerWaiting;
+
+	// Held while decoding, by whichever thread is producing chunks.
+	love::thread::MutexRef decodeMutex;
+	uint32 decodeGeneration;
+
+	// Guards the pending rewind or seek request. Never held while decoding.
+	love::thread::MutexRef requestMutex;
+	bool resetPending;
+	double resetPosition;
+
+}; // DecodeRing
+
+} // openal
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_OPENAL_DECODE_RING_H
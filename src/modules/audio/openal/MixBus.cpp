@@ -0,0 +1,152 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#include "MixBus.h"
+#include "Source.h"
+
+// STD
+#include <algorithm>
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+MixBus::MixBus(ALuint source, int sampleRate)
+	: source(source)
+	, sampleRate(sampleRate)
+	, mixBuffer(BUFFER_FRAMES * 2)
+	, outBuffer(BUFFER_FRAMES * 2)
+{
+	alGenBuffers(BUFFERS, buffers);
+	for (int i = 0; i < BUFFERS; i++)
+		unusedBuffers.push(buffers[i]);
+
+	// The mix is already attenuated, so it's played back unchanged.
+	float zero[3] = {0.0f, 0.0f, 0.0f};
+
+	alSourcei(source, AL_BUFFER, AL_NONE);
+	alSourcefv(source, AL_POSITION, zero);
+	alSourcefv(source, AL_VELOCITY, zero);
+	alSourcei(source, AL_SOURCE_RELATIVE, AL_TRUE);
+	alSourcei(source, AL_LOOPING, AL_FALSE);
+	alSourcef(source, AL_PITCH, 1.0f);
+	alSourcef(source, AL_GAIN, 1.0f);
+	alSourcef(source, AL_MIN_GAIN, 0.0f);
+	alSourcef(source, AL_MAX_GAIN, 1.0f);
+	alSourcef(source, AL_ROLLOFF_FACTOR, 0.0f);
+#ifdef ALC_EXT_EFX
+	alSourcei(source, AL_DIRECT_FILTER, AL_FILTER_NULL);
+#endif
+}
+
+MixBus::~MixBus()
+{
+	alSourceStop(source);
+	alSourcei(source, AL_BUFFER, AL_NONE);
+	alDeleteBuffers(BUFFERS, buffers);
+}
+
+double MixBus::update(const std::vector<std::pair<Source *, float>> &sources, std::vector<Source *> &finished)
+{
+	ALint processed = 0;
+	alGetSourcei(source, AL_BUFFERS_PROCESSED, &processed);
+
+	while (processed-- > 0)
+	{
+		ALuint buffer;
+		alSourceUnqueueBuffers(source, 1, &buffer);
+		unusedBuffers.push(buffer);
+		queuedSources.erase(buffer);
+	}
+
+	std::vector<std::pair<Source *, float>> active = sources;
+
+	while (!unusedBuffers.empty() && !active.empty())
+	{
+		std::fill(mixBuffer.begin(), mixBuffer.end(), 0.0f);
+
+		ALuint buffer = unusedBuffers.top();
+		unusedBuffers.pop();
+
+		std::vector<Source *> &mixed = queuedSources[buffer];
+		mixed.clear();
+		for (const auto &s : active)
+			mixed.push_back(s.first);
+
+		auto end = std::remove_if(active.begin(), active.end(), [&](const std::pair<Source *, float> &s)
+		{
+			if (s.first->mixAtomic(mixBuffer.data(), BUFFER_FRAMES, sampleRate, s.second))
+				return false;
+
+			finished.push_back(s.first);
+			return true;
+		});
+		active.erase(end, active.end());
+
+		for (size_t i = 0; i < mixBuffer.size(); i++)
+		{
+			float sample = std::min(std::max(mixBuffer[i], -1.0f), 1.0f);
+			outBuffer[i] = (int16) (sample * 32767.0f);
+		}
+
+		alBufferData(buffer, AL_FORMAT_STEREO16, outBuffer.data(), (ALsizei) (outBuffer.size() * sizeof(int16)), sampleRate);
+		alSourceQueueBuffers(source, 1, &buffer);
+	}
+
+	if ((int) unusedBuffers.size() == BUFFERS)
+		return -1.0;
+
+	ALint state;
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+	if (state != AL_PLAYING)
+		alSourcePlay(source);
+
+	// Refill as soon as the oldest buffer is done.
+	ALint offset = 0;
+	alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+	return std::max(BUFFER_FRAMES - offset, 0) / (double) sampleRate;
+}
+
+bool MixBus::isQueued(Source *s) const
+{
+	for (const auto &queued : queuedSources)
+	{
+		if (std::find(queued.second.begin(), queued.second.end(), s) != queued.second.end())
+			return true;
+	}
+
+	return false;
+}
+
+void MixBus::removeSource(Source *s)
+{
+	for (auto &queued : queuedSources)
+	{
+		auto &sources = queued.second;
+		sources.erase(std::remove(sources.begin(), sources.end(), s), sources.end());
+	}
+}
+
+} // openal
+} // audio
+} // love
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#ifndef LOVE_AUDIO_OPENAL_MIX_BUS_H
+#define LOVE_AUDIO_OPENAL_MIX_BUS_H
+
+// LOVE
+#include "common/config.h"
+#include "common/int.h"
+
+// STD
+#include <stack>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// OpenAL
+#ifdef LOVE_APPLE_USE_FRAMEWORKS
+#ifdef LOVE_IOS
+#include <OpenAL/alc.h>
+#include <OpenAL/al.h>
+#else
+#include <OpenAL-Soft/alc.h>
+#include <OpenAL-Soft/al.h>
+#endif
+#else
+#include <alc.h>
+#include <al.h>
+#endif
+
+namespace love
+{
+namespace audio
+{
+namespace openal
+{
+
+class Source;
+
+/**
+ * Mixes virtual Sources in software into a single streaming OpenAL source, so
+ * many quiet one-shot sounds can be heard while only using one voice. Mixed
+ * Sources aren't spatialized beyond their distance attenuation, and their
+ * filters and effects don't apply. Must only be used with the Pool locked.
+ **/
+class MixBus
+{
+public:
+
+	MixBus(ALuint source, int sampleRate);
+	~MixBus();
+
+	ALuint getSource() const { return source; }
+
+	/**
+	 * Mixes the given Sources (with their gain) into any free buffers, and
+	 * adds the ones which reached their end to the finished list. Returns how
+	 * many seconds can pass before the next update is needed, or a negative
+	 * value if the bus is idle.
+	 **/
+	double update(const std::vector<std::pair<Source *, float>> &sources, std::vector<Source *> &finished);
+
+	/**
+	 * Whether audio of the Source is mixed into buffers which haven't finished
+	 * playing yet. The bus mixes ahead, so such a Source's position is past
+	 * what can be heard of it.
+	 **/
+	bool isQueued(Source *s) const;
+
+	/**
+	 * Forgets a Source which stopped being virtual.
+	 **/
+	void removeSource(Source *s);
+
+private:
+
+	static const int BUFFERS = 4;
+	static const int BUFFER_FRAMES = 1024;
+
+	ALuint source;
+	int sampleRate;
+
+	ALuint buffers[BUFFERS];
+	std::stack<ALuint> unusedBuffers;
+
+	// The Sources mixed into each queued buffer.
+	std::unordered_map<ALuint, std::vector<Source *>> queuedSources;
+
+	std::vector<float> mixBuffer;
+	std::vector<int16> outBuffer;
+
+}; // MixBus
+
+} // openal
+} // audio
+} // love
+
+#endif // LOVE_AUDIO_OPENAL_MIX_BUS_H
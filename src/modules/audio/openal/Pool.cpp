@@ -21,8 +21,12 @@
 #include "Pool.h"
 
 #include "event/Event.h"
+#include "timer/Timer.h"
 #include "Source.h"
 
+// STD
+#include <algorithm>
+
 namespace love
 {
 namespace audio
@@ -40,11 +44,37 @@ static Variant::SharedTable *putSourcesAsSharedTable(std::vector<audio::Source *
 	return table;
 }
 
+static void getListener(float *position, ALint &distanceModel)
+{
+	alGetListenerfv(AL_POSITION, position);
+	distanceModel = alGetInteger(AL_DISTANCE_MODEL);
+}
+
+// Whether Source a should have a voice rather than Source b. Priority comes
+// first, then how loud they are.
+static bool outranks(Source *a, float audibilityA, Source *b, float audibilityB, float ratio)
+{
+	if (a->getPriority() != b->getPriority())
+		return a->getPriority() > b->getPriority();
+
+	return audibilityA > audibilityB * ratio;
+}
+
+static float getPlayingAudibility(Source *source, const float *listener, ALint distanceModel)
+{
+	// Paused Sources are the first to give up their voice.
+	return source->isPlaying() ? source->getAudibility(listener, distanceModel) : 0.0f;
+}
+
 Pool::Pool(ALCdevice *device)
 	: device(device)
 	, sources()
 	, disconnectNotified(false)
 	, totalSources(0)
+	, mixBusSampleRate(44100)
+	, mixBusSourceCount(0)
+	, wakeRequested(false)
+	, refillLatencyCounts()
 {
 	// Clear errors.
 	alGetError();
@@ -82,12 +112,24 @@ Pool::Pool(ALCdevice *device)
 
 		available.push(sources[i]);
 	}
+
+	ALCint frequency = 0;
+	alcGetIntegerv(device, ALC_FREQUENCY, 1, &frequency);
+	if (frequency > 0)
+		mixBusSampleRate = frequency;
+
+	decodeWorkers.set(new thread::WorkerPool(DECODE_THREADS), Acquire::NORETAIN);
 }
 
 Pool::~Pool()
 {
 	Source::stop(this);
 
+	// Finishes any decode jobs that are still queued.
+	decodeWorkers.set(nullptr);
+
+	mixBus.reset();
+
 	// Free all sources.
 	alDeleteSources(totalSources, sources);
 }
@@ -107,12 +149,12 @@ bool Pool::isPlaying(Source *s)
 	bool p = false;
 	{
 		thread::Lock lock(mutex);
-		p = (playing.find(s) != playing.end());
+		p = (playing.find(s) != playing.end()) || isVirtual(s);
 	}
 	return p;
 }
 
-void Pool::update()
+double Pool::update()
 {
 #ifndef ALC_CONNECTED
 	constexpr ALCenum ALC_CONNECTED = 0x313;
@@ -120,11 +162,15 @@ void Pool::update()
 
 	thread::Lock lock(mutex);
 
+	double delay = -1.0;
+
 	static bool disconnectExtSupported = alcIsExtensionPresent(device, "ALC_EXT_Disconnect") == ALC_TRUE;
 
 	// Device disconnection event
 	if (disconnectExtSupported)
 	{
+		delay = DISCONNECT_CHECK_INTERVAL;
+
 		auto eventModule = Module::getInstance<event::Event>(Module::M_EVENT);
 		if (eventModule)
 		{
@@ -156,16 +202,204 @@ void Pool::update()
 	for (const auto &i : playing)
 	{
 		if (!i.first->update())
+		{
 			torelease.push_back(i.first);
+			continue;
+		}
+
+		double sourcedelay = i.first->getNextUpdateDelay();
+		if (sourcedelay >= 0.0 && (delay < 0.0 || sourcedelay < delay))
+			delay = sourcedelay;
 	}
 
 	for (Source *s : torelease)
 		releaseSource(s);
+
+	double virtualdelay = updateVirtualSources();
+	if (virtualdelay >= 0.0 && (delay < 0.0 || virtualdelay < delay))
+		delay = virtualdelay;
+
+	if (delay >= 0.0)
+		delay = std::max(delay, MIN_UPDATE_INTERVAL);
+
+	return delay;
+}
+
+double Pool::updateVirtualSources()
+{
+	if (virtualSources.empty() && !mixBus)
+		return -1.0;
+
+	double now = love::timer::Timer::getTime();
+
+	float listener[3];
+	ALint distanceModel;
+	getListener(listener, distanceModel);
+
+	// The mix bus plays the loudest Sources it can mix, the others only keep
+	// track of their position.
+	std::vector<std::pair<Source *, float>> mixed;
+	if (mixBus)
+	{
+		for (Source *s : virtualSources)
+		{
+			if (s->isMixable() && drainingSources.find(s) == drainingSources.end())
+				mixed.emplace_back(s, s->getAudibility(listener, distanceModel));
+		}
+
+		if ((int) mixed.size() > MAX_MIX_BUS_SOURCES)
+		{
+			std::partial_sort(mixed.begin(), mixed.begin() + MAX_MIX_BUS_SOURCES, mixed.end(),
+				[](const std::pair<Source *, float> &a, const std::pair<Source *, float> &b)
+				{
+					return a.second > b.second;
+				});
+			mixed.resize(MAX_MIX_BUS_SOURCES);
+		}
+	}
+
+	// Sorted, so checking whether each virtual Source is mixed stays cheap.
+	std::vector<Source *> mixedsources;
+	mixedsources.reserve(mixed.size());
+	for (const auto &m : mixed)
+		mixedsources.push_back(m.first);
+	std::sort(mixedsources.begin(), mixedsources.end());
+
+	std::vector<Source *> torelease;
+
+	for (Source *s : virtualSources)
+	{
+		// Mixing moves a Source's position ahead by the audio it mixed. Until
+		// that audio has played, time passing doesn't move it any further.
+		bool ismixed = std::binary_search(mixedsources.begin(), mixedsources.end(), s)
+			|| (mixBus && mixBus->isQueued(s));
+		if (!s->updateVirtualAtomic(now, !ismixed))
+			torelease.push_back(s);
+	}
+
+	double delay = -1.0;
+	if (mixBus)
+	{
+		size_t releasecount = torelease.size();
+		delay = mixBus->update(mixed, torelease);
+		mixBusSourceCount = (int) (mixed.size() - (torelease.size() - releasecount));
+	}
+
+	for (Source *s : torelease)
+		releaseSource(s);
+
+	// Virtual Sources take the voices of playing Sources they outrank.
+	std::vector<std::pair<Source *, float>> candidates;
+	for (Source *s : virtualSources)
+	{
+		if (s->isPlaying())
+			candidates.emplace_back(s, s->getAudibility(listener, distanceModel));
+	}
+
+	std::sort(candidates.begin(), candidates.end(),
+		[](const std::pair<Source *, float> &a, const std::pair<Source *, float> &b)
+		{
+			return outranks(a.first, a.second, b.first, b.second, 1.0f);
+		});
+
+	drainingSources.clear();
+	size_t reserved = 0;
+
+	for (const auto &c : candidates)
+	{
+		// Its position is ahead of its mixed audio which hasn't played yet, so
+		// it would be heard twice. If it would get a voice, it stops being
+		// mixed and takes one once that audio has played.
+		if (mixBus && mixBus->isQueued(c.first))
+		{
+			if (available.size() > reserved)
+				reserved++;
+			else if (findVirtualizeVictim(c.first) == nullptr)
+				break;
+
+			drainingSources.insert(c.first);
+			continue;
+		}
+
+		if (available.size() <= reserved && !virtualizeSource(c.first))
+			break;
+
+		ALuint out = available.front();
+		available.pop();
+
+		virtualSources.erase(c.first);
+		playing.insert(std::make_pair(c.first, out));
+
+		// A Source which can't resume stops itself, which releases it and its
+		// voice. Our reference keeps it alive until that's been checked.
+		StrongRef<Source> source(c.first);
+		if (!source->devirtualizeAtomic(out))
+		{
+			ALuint s;
+			if (findSource(source, s))
+				releaseSource(source, false);
+		}
+	}
+
+	if (!virtualSources.empty() && (delay < 0.0 || delay > VIRTUAL_UPDATE_INTERVAL))
+		delay = VIRTUAL_UPDATE_INTERVAL;
+
+	return delay;
+}
+
+void Pool::waitForUpdate(double seconds)
+{
+	thread::Lock lock(wakeMutex);
+
+	if (!wakeRequested)
+	{
+		int timeout = seconds < 0.0 ? -1 : std::max((int) std::ceil(seconds * 1000.0), 1);
+		wakeCond->wait(wakeMutex, timeout);
+	}
+
+	wakeRequested = false;
+}
+
+void Pool::wake()
+{
+	thread::Lock lock(wakeMutex);
+	wakeRequested = true;
+	wakeCond->signal();
+}
+
+void Pool::recordRefillLatency(double seconds)
+{
+	double ms = seconds * 1000.0;
+
+	int bucket = 0;
+	while (bucket < REFILL_LATENCY_BUCKETS - 1 && ms > REFILL_LATENCY_LIMITS[bucket])
+		bucket++;
+
+	refillLatencyCounts[bucket]++;
+}
+
+void Pool::getRefillLatencyHistogram(std::vector<double> &limits, std::vector<uint64> &counts)
+{
+	thread::Lock lock(mutex);
+
+	limits.clear();
+	for (double limit : REFILL_LATENCY_LIMITS)
+		limits.push_back(limit / 1000.0);
+
+	counts.assign(refillLatencyCounts, refillLatencyCounts + REFILL_LATENCY_BUCKETS);
+}
+
+void Pool::resetRefillLatencyHistogram()
+{
+	thread::Lock lock(mutex);
+
+	for (uint64 &count : refillLatencyCounts)
+		count = 0;
 }
 
 int Pool::getActiveSourceCount() const
 {
-	return (int) playing.size();
+	return (int) (playing.size() + virtualSources.size());
 }
 
 int Pool::getMaxSources() const
@@ -173,23 +407,89 @@ int Pool::getMaxSources() const
 	return totalSources;
 }
 
+int Pool::getVirtualSourceCount() const
+{
+	return (int) virtualSources.size();
+}
+
+int Pool::getMixBusSourceCount() const
+{
+	return mixBusSourceCount;
+}
+
+void Pool::setMixBusEnabled(bool enable)
+{
+	thread::Lock lock(mutex);
+
+	if (enable == (mixBus.get() != nullptr))
+		return;
+
+	if (enable)
+	{
+		if (available.empty() && !virtualizeSource(nullptr))
+			throw love::Exception("Could not get an OpenAL source for the mix bus.");
+
+		ALuint out = available.front();
+		available.pop();
+
+		mixBus.reset(new MixBus(out, mixBusSampleRate));
+	}
+	else
+	{
+		ALuint out = mixBus->getSource();
+		mixBus.reset();
+		available.push(out);
+		drainingSources.clear();
+		mixBusSourceCount = 0;
+	}
+
+	wake();
+}
+
+bool Pool::isMixBusEnabled() const
+{
+	thread::Lock lock(mutex);
+	return mixBus.get() != nullptr;
+}
+
 bool Pool::assignSource(Source *source, ALuint &out, char &wasPlaying)
 {
 	out = 0;
 
 	if (findSource(source, out))
+	{
+		// A paused Source may be resumed.
+		wake();
 		return wasPlaying = true;
+	}
+
+	if (isVirtual(source))
+	{
+		// A paused virtual Source may be resumed.
+		wake();
+		return wasPlaying = true;
+	}
 
 	wasPlaying = false;
 
-	if (available.empty())
-		return false;
+	if (available.empty() && !virtualizeSource(source))
+	{
+		if (source->getType() == Source::TYPE_QUEUE)
+			return false;
+
+		virtualSources.insert(source);
+		source->retain();
+		source->startVirtualAtomic();
+		wake();
+		return true;
+	}
 
 	out = available.front();
 	available.pop();
 
 	playing.insert(std::make_pair(source, out));
 	source->retain();
+	wake();
 	return true;
 }
 
@@ -207,9 +507,86 @@ bool Pool::releaseSource(Source *source, bool stop)
 		return true;
 	}
 
+	if (virtualSources.erase(source) > 0)
+	{
+		drainingSources.erase(source);
+		if (mixBus)
+			mixBus->removeSource(source);
+		source->stopVirtualAtomic(stop);
+		source->release();
+		return true;
+	}
+
 	return false;
 }
 
+bool Pool::isVirtual(Source *source) const
+{
+	return virtualSources.find(source) != virtualSources.end();
+}
+
+Source *Pool::findVirtualizeVictim(Source *outranking)
+{
+	float listener[3];
+	ALint distanceModel;
+	getListener(listener, distanceModel);
+
+	Source *victim = nullptr;
+	float victimAudibility = 0.0f;
+
+	for (const auto &i : playing)
+	{
+		if (!i.first->canVirtualize())
+			continue;
+
+		float audibility = getPlayingAudibility(i.first, listener, distanceModel);
+		if (victim == nullptr || outranks(victim, victimAudibility, i.first, audibility, 1.0f))
+		{
+			victim = i.first;
+			victimAudibility = audibility;
+		}
+	}
+
+	if (victim == nullptr)
+		return nullptr;
+
+	if (outranking != nullptr)
+	{
+		bool wins = false;
+
+		// Queueable Sources can't be virtual, so they take a voice unless its
+		// Source has a higher priority.
+		if (outranking->getType() == Source::TYPE_QUEUE)
+			wins = outranking->getPriority() >= victim->getPriority();
+		else
+		{
+			float audibility = outranking->getAudibility(listener, distanceModel);
+			wins = outranks(outranking, audibility, victim, victimAudibility, VOICE_SWAP_RATIO);
+		}
+
+		if (!wins)
+			return nullptr;
+	}
+
+	return victim;
+}
+
+bool Pool::virtualizeSource(Source *outranking)
+{
+	Source *victim = findVirtualizeVictim(outranking);
+	if (victim == nullptr)
+		return false;
+
+	ALuint out = playing[victim];
+	playing.erase(victim);
+
+	victim->virtualizeAtomic();
+
+	available.push(out);
+	virtualSources.insert(victim);
+	return true;
+}
+
 bool Pool::findSource(Source *source, ALuint &out)
 {
 	std::map<Source *, ALuint>::const_iterator i = playing.find(source);
@@ -229,9 +606,11 @@ thread::Lock Pool::lock()
 std::vector<love::audio::Source*> Pool::getPlayingSources()
 {
 	std::vector<love::audio::Source*> sources;
-	sources.reserve(playing.size());
+	sources.reserve(playing.size() + virtualSources.size());
 	for (auto &i : playing)
 		sources.push_back(i.first);
+	for (Source *s : virtualSources)
+		sources.push_back(s);
 	return sources;
 }
 
@@ -24,14 +24,19 @@
 // STD
 #include <queue>
 #include <map>
+#include <memory>
+#include <unordered_set>
 #include <vector>
 #include <cmath>
 
 // LOVE
 #include "common/config.h"
 #include "common/Exception.h"
+#include "common/int.h"
 #include "thread/threads.h"
+#include "thread/WorkerPool.h"
 #include "audio/Source.h"
+#include "MixBus.h"
 
 // OpenAL
 #ifdef LOVE_APPLE_USE_FRAMEWORKS
@@ -78,10 +83,48 @@ class Pool
 	 **/
 	bool isPlaying(Source *s);
 
-	void update();
+	/**
+	 * Updates every playing Source, and returns how many seconds can pass
+	 * before the next update is needed, or a negative value if nothing needs
+	 * updating until wake is called.
+	 **/
+	double update();
+
+	/**
+	 * Blocks until the given number of seconds have passed (forever if it's
+	 * negative), or until wake is called.
+	 **/
+	void waitForUpdate(double seconds);
+
+	/**
+	 * Makes the pool thread update as soon as possible, for example because a
+	 * Source started playing or changed speed.
+	 **/
+	void wake();
+
+	/**
+	 * Records how long a streaming Source's finished buffer waited to be
+	 * refilled. Must be called with the Pool locked.
+	 **/
+	void recordRefillLatency(double seconds);
+
+	void getRefillLatencyHistogram(std::vector<double> &limits, std::vector<uint64> &counts);
+	void resetRefillLatencyHistogram();
 
 	int getActiveSourceCount() const;
 	int getMaxSources() const;
+	int getVirtualSourceCount() const;
+
+	/**
+	 * How many virtual Sources the mix bus mixed in its last update.
+	 **/
+	int getMixBusSourceCount() const;
+
+	/**
+	 * The mix bus takes one OpenAL source away from the pool while enabled.
+	 **/
+	void setMixBusEnabled(bool enable);
+	bool isMixBusEnabled() const;
 
 private:
 
@@ -95,12 +138,62 @@ class Pool
 	 **/
 	bool releaseSource(Source *source, bool stop = true);
 
+	/**
+	 * Gets an OpenAL source for the Source, or makes it virtual (and sets out
+	 * to 0) when every OpenAL source is used by a Source which outranks it.
+	 **/
 	bool assignSource(Source *source, ALuint &out, char &wasPlaying);
 	bool findSource(Source *source, ALuint &out);
+	bool isVirtual(Source *source) const;
+
+	/**
+	 * Gets the least important Source with an OpenAL source, if the given
+	 * Source outranks it (or the given Source is null).
+	 **/
+	Source *findVirtualizeVictim(Source *outranking);
+
+	/**
+	 * Makes the Source found by findVirtualizeVictim virtual. Its OpenAL
+	 * source is then available.
+	 **/
+	bool virtualizeSource(Source *outranking);
+
+	/**
+	 * Advances the virtual Sources, feeds the mix bus and gives OpenAL sources
+	 * to the virtual Sources which outrank playing ones. Returns how many
+	 * seconds can pass before the next update, or a negative value.
+	 **/
+	double updateVirtualSources();
+
+	love::thread::WorkerPool *getDecodeWorkers() const { return decodeWorkers; }
 
 	// Maximum possible number of OpenAL sources the pool attempts to generate.
 	static const int MAX_SOURCES = 64;
 
+	// Streaming Sources are decoded on this many dedicated threads, so a slow
+	// decode never holds the Pool lock.
+	static const int DECODE_THREADS = 2;
+
+	// How often device disconnection is checked when nothing else needs an
+	// update, and the shortest time the pool thread waits between updates.
+	static constexpr double DISCONNECT_CHECK_INTERVAL = 0.5;
+	static constexpr double MIN_UPDATE_INTERVAL = 0.001;
+
+	// How often virtual Sources are ranked against the playing ones, since
+	// listener and Source movement doesn't wake the pool thread.
+	static constexpr double VIRTUAL_UPDATE_INTERVAL = 0.05;
+
+	// A virtual Source of the same priority needs to be this much louder
+	// than a playing one to take its voice, so they don't keep swapping.
+	static constexpr float VOICE_SWAP_RATIO = 1.25f;
+
+	// Most Sources the mix bus mixes at once. Quieter ones stay silent.
+	static const int MAX_MIX_BUS_SOURCES = 128;
+
+	// Upper limits in milliseconds of the refill latency histogram buckets.
+	static constexpr double REFILL_LATENCY_LIMITS[] = {0.5, 1, 2, 4, 8, 16, 32, 64, 128, 256};
+	static constexpr int REFILL_LATENCY_BUCKETS = sizeof(REFILL_LATENCY_LIMITS) / sizeof(REFILL_LATENCY_LIMITS[0]) + 1;
+
 	// Current OpenAL device
 	ALCdevice *device;
 
@@ -119,10 +212,32 @@ class Pool
 	// A map of playing sources.
 	std::map<Source *, ALuint> playing;
 
+	// Playing Sources without an OpenAL source.
+	std::unordered_set<Source *> virtualSources;
+
+	std::unique_ptr<MixBus> mixBus;
+
+	// Mixed Sources waiting for their queued mix bus audio to play out before
+	// they take a voice. They aren't mixed anymore in the meantime.
+	std::unordered_set<Source *> drainingSources;
+
+	int mixBusSampleRate;
+	int mixBusSourceCount;
+
 	// Only one thread can access this object at the same time. This mutex will
 	// make sure of that.
 	love::thread::MutexRef mutex;
 
+	StrongRef<love::thread::WorkerPool> decodeWorkers;
+
+	// Signalled by wake. Separate from the Pool mutex, so waking never waits
+	// for an update to finish.
+	love::thread::MutexRef wakeMutex;
+	love::thread::ConditionalRef wakeCond;
+	bool wakeRequested;
+
+	uint64 refillLatencyCounts[REFILL_LATENCY_BUCKETS];
+
 }; // Pool
 
 } // openal
@@ -23,10 +23,12 @@
 #include "Pool.h"
 #include "Audio.h"
 #include "common/math.h"
+#include "timer/Timer.h"
 
 // STD
 #include <iostream>
 #include <algorithm>
+#include <cmath>
 
 #define audiomodule() (Module::getInstance<Audio>(Module::M_AUDIO))
 
@@ -131,6 +133,10 @@ Source::Source(Pool *pool, love::sound::SoundData *soundData)
 
 	staticBuffer.set(new StaticDataBuffer(fmt, soundData->getData(), (ALsizei) soundData->getSize(), sampleRate), Acquire::NORETAIN);
 
+	bool mixformat = channels <= 2 && (bitDepth == 8 || bitDepth == 16);
+	if (mixformat && soundData->getSize() <= MAX_MIX_DATA_SIZE && pool->isMixBusEnabled())
+		mixData.set(soundData);
+
 	float z[3] = {0, 0, 0};
 
 	setFloatv(position, z);
@@ -147,7 +153,6 @@ Source::Source(Pool *pool, love::sound::Decoder *decoder)
 	, sampleRate(decoder->getSampleRate())
 	, channels(decoder->getChannelCount())
 	, bitDepth(decoder->getBitDepth())
-	, decoder(decoder)
 	, buffers(DEFAULT_BUFFERS)
 {
 	if (Audio::getFormat(decoder->getBitDepth(), decoder->getChannelCount()) == AL_NONE)
@@ -166,6 +171,10 @@ Source::Source(Pool *pool, love::sound::Decoder *decoder)
 		}
 	}
 
+	// Start decoding right away, so there's audio ready when it's played.
+	decodeRing.set(new DecodeRing(decoder, buffers, [pool]() { pool->wake(); }), Acquire::NORETAIN);
+	decodeRing->schedule(pool->getDecodeWorkers());
+
 	float z[3] = {0, 0, 0};
 
 	setFloatv(position, z);
@@ -221,10 +230,12 @@ Source::Source(const Source &s)
 	, pool(s.pool)
 	, valid(false)
 	, staticBuffer(s.staticBuffer)
+	, mixData(s.mixData)
 	, pitch(s.pitch)
 	, volume(s.volume)
 	, relative(s.relative)
 	, looping(s.looping)
+	, priority(s.priority)
 	, minVolume(s.minVolume)
 	, maxVolume(s.maxVolume)
 	, referenceDistance(s.referenceDistance)
@@ -235,15 +246,9 @@ Source::Source(const Source &s)
 	, sampleRate(s.sampleRate)
 	, channels(s.channels)
 	, bitDepth(s.bitDepth)
-	, decoder(nullptr)
 	, toLoop(0)
 	, buffers(s.buffers)
 {
-	if (sourceType == TYPE_STREAM)
-	{
-		if (s.decoder.get())
-			decoder.set(s.decoder->clone(), Acquire::NORETAIN);
-	}
 	if (sourceType != TYPE_STATIC)
 	{
 		for (int i = 0; i < buffers; i++)
@@ -260,6 +265,15 @@ Source::Source(const Source &s)
 		}
 	}
 
+	if (sourceType == TYPE_STREAM && s.decodeRing.get())
+	{
+		Pool *p = pool;
+		StrongRef<love::sound::Decoder> decoder(s.decodeRing->cloneDecoder(), Acquire::NORETAIN);
+		decodeRing.set(new DecodeRing(decoder, buffers, [p]() { p->wake(); }), Acquire::NORETAIN);
+		decodeRing->setLooping(looping);
+		decodeRing->schedule(pool->getDecodeWorkers());
+	}
+
 	if (s.directfilter)
 		directfilter = s.directfilter->clone();
 
@@ -333,15 +347,25 @@ bool Source::play()
 		return valid = false;
 
 	if (!wasPlaying)
+	{
+		// Virtual Sources start playing once the Pool gives them a voice.
+		if (virtualized)
+			return true;
+
 		return valid = playAtomic(out);
+	}
 
 	resumeAtomic();
-	return valid = true;
+
+	if (!virtualized)
+		valid = true;
+
+	return true;
 }
 
 void Source::stop()
 {
-	if (!valid)
+	if (!valid && !virtualized)
 		return;
 
 	Lock l = pool->lock();
@@ -357,6 +381,12 @@ void Source::pause()
 
 bool Source::isPlaying() const
 {
+	// The Pool's thread can virtualize or devirtualize this Source meanwhile.
+	Lock l = pool->lock();
+
+	if (virtualized)
+		return !virtualPaused;
+
 	if (!valid)
 		return false;
 
@@ -370,7 +400,7 @@ bool Source::isFinished() const
 	if (!valid)
 		return false;
 
-	if (sourceType == TYPE_STREAM && (isLooping() || !decoder->isFinished()))
+	if (sourceType == TYPE_STREAM && (isLooping() || !decodeRing->isFinished()))
 		return false;
 
 	ALenum state;
@@ -419,24 +449,54 @@ bool Source::update()
 
 					offsetSamples += (curOffsetSamples - newOffsetSamples);
 
-					if (streamAtomic(buffer, decoder.get()) > 0)
+					ALint size;
+					alGetBufferi(buffer, AL_SIZE, &size);
+					bufferedBytes -= size;
+
+					// The playback position is now relative to the end of the
+					// buffer that was just unqueued.
+					double now = love::timer::Timer::getTime();
+					double finishtime = now - newOffsetSamples / (sampleRate * (pitch > 0.0f ? pitch : 1.0f));
+
+					if (streamAtomic(buffer) > 0)
+					{
 						alSourceQueueBuffers(source, 1, &buffer);
+						pool->recordRefillLatency(love::timer::Timer::getTime() - finishtime);
+					}
 					else
+					{
 						unusedBuffers.push(buffer);
+						bufferFinishTimes[buffer] = finishtime;
+					}
 				}
 
 				while (!unusedBuffers.empty())
 				{
 					ALuint b = unusedBuffers.top();
-					if (streamAtomic(b, decoder.get()) > 0)
+					if (streamAtomic(b) > 0)
 					{
 						alSourceQueueBuffers(source, 1, &b);
 						unusedBuffers.pop();
+
+						auto it = bufferFinishTimes.find(b);
+						if (it != bufferFinishTimes.end())
+						{
+							pool->recordRefillLatency(love::timer::Timer::getTime() - it->second);
+							bufferFinishTimes.erase(it);
+						}
 					}
 					else
 						break;
 				}
 
+				// If decoding fell behind, OpenAL stops the source once it
+				// runs out of queued buffers. Resume it when there's more.
+				ALint state;
+				alGetSourcei(source, AL_SOURCE_STATE, &state);
+				if (state == AL_STOPPED && (int) unusedBuffers.size() < buffers)
+					alSourcePlay(source);
+
+				decodeRing->schedule(pool->getDecodeWorkers());
 				return true;
 			}
 			return false;
@@ -464,10 +524,260 @@ bool Source::update()
 	return false;
 }
 
+double Source::getNextUpdateDelay() const
+{
+	if (!valid)
+		return -1.0;
+
+	// Paused Sources wait for play to wake the pool, and streaming Sources
+	// which ran out of data wait for the decode threads.
+	ALenum state;
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+	if (state == AL_PAUSED)
+		return -1.0;
+
+	if (state != AL_PLAYING)
+	{
+		// A stopped stream which already has more data, or which reached its
+		// end, won't get a wakeup from the decode threads.
+		if (sourceType == TYPE_STREAM && (decodeRing->hasChunks() || decodeRing->isFinished()))
+			return Pool::MIN_UPDATE_INTERVAL;
+		return -1.0;
+	}
+
+	ALint offset = 0;
+	alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+
+	int framesize = channels * (bitDepth / 8);
+	double rate = sampleRate * (pitch > 0.0f ? pitch : 1.0f);
+
+	if (sourceType == TYPE_STATIC)
+	{
+		// Only needs an update once it's due to finish.
+		if (isLooping())
+			return -1.0;
+
+		int frames = staticBuffer->getSize() / framesize;
+		return std::max(frames - offset, 0) / rate;
+	}
+
+	// Streaming and queueable Sources need an update when their oldest queued
+	// buffer finishes playing, so it can be refilled or reported as free.
+	ALint queued = 0;
+	alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
+	if (queued <= 0)
+		return -1.0;
+
+	double frames = (double) bufferedBytes / framesize / queued;
+	return std::max(frames - offset, 0.0) / rate;
+}
+
+float Source::getAudibility(const float *listener, ALint distanceModel) const
+{
+	float gain = volume;
+
+	// Only mono Sources are spatialized.
+	if (channels == 1 && distanceModel != AL_NONE)
+	{
+		float d[3];
+		for (int i = 0; i < 3; i++)
+			d[i] = position[i] - (relative ? 0.0f : listener[i]);
+
+		float distance = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+		gain *= getDistanceAttenuation(distance, distanceModel);
+	}
+
+	return std::min(std::max(gain, minVolume), maxVolume);
+}
+
+float Source::getDistanceAttenuation(float distance, ALint distanceModel) const
+{
+	// These follow the OpenAL specification's distance models.
+	switch (distanceModel)
+	{
+	case AL_INVERSE_DISTANCE_CLAMPED:
+	case AL_LINEAR_DISTANCE_CLAMPED:
+	case AL_EXPONENT_DISTANCE_CLAMPED:
+		distance = std::max(referenceDistance, std::min(distance, maxDistance));
+		break;
+	default:
+		break;
+	}
+
+	switch (distanceModel)
+	{
+	case AL_INVERSE_DISTANCE:
+	case AL_INVERSE_DISTANCE_CLAMPED:
+	{
+		float denom = referenceDistance + rolloffFactor * (distance - referenceDistance);
+		return denom > 0.0f ? referenceDistance / denom : 1.0f;
+	}
+	case AL_LINEAR_DISTANCE:
+	case AL_LINEAR_DISTANCE_CLAMPED:
+	{
+		if (maxDistance <= referenceDistance)
+			return 1.0f;
+
+		distance = std::min(distance, maxDistance);
+		float attenuation = 1.0f - rolloffFactor * (distance - referenceDistance) / (maxDistance - referenceDistance);
+		return std::max(attenuation, 0.0f);
+	}
+	case AL_EXPONENT_DISTANCE:
+	case AL_EXPONENT_DISTANCE_CLAMPED:
+		if (distance <= 0.0f || referenceDistance <= 0.0f)
+			return 1.0f;
+		return powf(distance / referenceDistance, -rolloffFactor);
+	default:
+		return 1.0f;
+	}
+}
+
+bool Source::canVirtualize() const
+{
+	// Sources which are about to start playing don't have a position yet.
+	return valid && sourceType != TYPE_QUEUE;
+}
+
+bool Source::isMixable() const
+{
+	return virtualized && !virtualPaused && mixData.get() != nullptr && !isLooping() && pitch > 0.0f;
+}
+
+double Source::getVirtualLength()
+{
+	switch (sourceType)
+	{
+	case TYPE_STATIC:
+		return staticBuffer->getSize() / (channels * (bitDepth / 8));
+	case TYPE_STREAM:
+	{
+		double duration = decodeRing->getDuration();
+		return duration > 0.0 ? duration * sampleRate : -1.0;
+	}
+	default:
+		return -1.0;
+	}
+}
+
+void Source::startVirtualAtomic()
+{
+	virtualized = true;
+	virtualPaused = false;
+	virtualOffset = offsetSamples;
+	virtualLength = getVirtualLength();
+	virtualTime = love::timer::Timer::getTime();
+}
+
+void Source::virtualizeAtomic()
+{
+	ALint offset = 0;
+	alGetSourcei(source, AL_SAMPLE_OFFSET, &offset);
+
+	ALenum state;
+	alGetSourcei(source, AL_SOURCE_STATE, &state);
+
+	double position = (double) offset + offsetSamples;
+
+	alSourceStop(source);
+	teardownAtomic();
+
+	startVirtualAtomic();
+	virtualPaused = state == AL_PAUSED;
+	virtualOffset = position;
+	offsetSamples = (int) position;
+}
+
+bool Source::devirtualizeAtomic(ALuint source)
+{
+	virtualized = false;
+	offsetSamples = (int) virtualOffset;
+
+	// Streaming Sources start decoding at their position instead.
+	if (sourceType == TYPE_STREAM)
+		decodeRing->seek(offsetSamples / (double) sampleRate);
+
+	// playAtomic only marks streaming Sources as valid itself.
+	return valid = playAtomic(source);
+}
+
+void Source::stopVirtualAtomic(bool rewind)
+{
+	if (virtualized && rewind)
+	{
+		offsetSamples = 0;
+		if (sourceType == TYPE_STREAM)
+			decodeRing->rewind();
+	}
+
+	virtualized = false;
+	virtualPaused = false;
+}
+
+bool Source::updateVirtualAtomic(double time, bool advance)
+{
+	double elapsed = time - virtualTime;
+	virtualTime = time;
+
+	if (!advance || virtualPaused)
+		return true;
+
+	virtualOffset += elapsed * sampleRate * std::max(pitch, 0.0f);
+
+	if (virtualLength > 0.0 && virtualOffset >= virtualLength)
+	{
+		if (!isLooping())
+			return false;
+
+		virtualOffset = fmod(virtualOffset, virtualLength);
+	}
+
+	offsetSamples = (int) virtualOffset;
+	return true;
+}
+
+static inline float getMixSample(const uint8 *data, int bitDepth, int index)
+{
+	if (bitDepth == 16)
+		return (float) ((const int16 *) data)[index] / (float) LOVE_INT16_MAX;
+	else
+		return ((float) data[index] - 128.0f) / 127.0f;
+}
+
+bool Source::mixAtomic(float *out, int frames, int outRate, float gain)
+{
+	const uint8 *data = (const uint8 *) mixData->getData();
+	int length = (int) (mixData->getSize() / (channels * (bitDepth / 8)));
+	double step = sampleRate * (double) pitch / outRate;
+
+	for (int i = 0; i < frames && virtualOffset < length; i++)
+	{
+		int frame = (int) virtualOffset;
+		int next = std::min(frame + 1, length - 1);
+		float t = (float) (virtualOffset - frame);
+
+		for (int c = 0; c < 2; c++)
+		{
+			// Mono Sources are mixed into both channels.
+			int channel = std::min(c, channels - 1);
+			float a = getMixSample(data, bitDepth, frame * channels + channel);
+			float b = getMixSample(data, bitDepth, next * channels + channel);
+			out[i * 2 + c] += (a + (b - a) * t) * gain;
+		}
+
+		virtualOffset += step;
+	}
+
+	offsetSamples = (int) virtualOffset;
+	return virtualOffset < length;
+}
+
 void Source::setPitch(float pitch)
 {
 	if (valid)
+	{
 		alSourcef(source, AL_PITCH, pitch);
+		pool->wake();
+	}
 
 	this->pitch = pitch;
 }
@@ -542,7 +852,7 @@ void Source::seek(double offset, Source::Unit unit)
 			if (valid)
 				stop();
 
-			decoder->seek(offsetSeconds);
+			decodeRing->seek(offsetSeconds);
 
 			if (wasPlaying)
 				play();
@@ -589,6 +899,12 @@ void Source::seek(double offset, Source::Unit unit)
 	}
 
 	this->offsetSamples = offsetSamples;
+
+	if (virtualized)
+		virtualOffset = offsetSamples;
+
+	if (valid || virtualized)
+		pool->wake();
 }
 
 double Source::tell(Source::Unit unit)
@@ -626,12 +942,12 @@ double Source::getDuration(Unit unit)
 	}
 	case TYPE_STREAM:
 	{
-		double seconds = decoder->getDuration();
+		double seconds = decodeRing->getDuration();
 
 		if (unit == UNIT_SECONDS)
 			return seconds;
 		else
-			return seconds * decoder->getSampleRate();
+			return seconds * sampleRate;
 	}
 	case TYPE_QUEUE:
 	{
@@ -773,7 +1089,13 @@ void Source::setLooping(bool enable)
 	if (valid && sourceType == TYPE_STATIC)
 		alSourcei(source, AL_LOOPING, enable ? AL_TRUE : AL_FALSE);
 
+	if (sourceType == TYPE_STREAM)
+		decodeRing->setLooping(enable);
+
 	looping = enable;
+
+	if (valid)
+		pool->wake();
 }
 
 bool Source::isLooping() const
@@ -781,6 +1103,19 @@ bool Source::isLooping() const
 	return looping;
 }
 
+void Source::setPriority(float priority)
+{
+	this->priority = priority;
+
+	if (valid || virtualized)
+		pool->wake();
+}
+
+float Source::getPriority() const
+{
+	return priority;
+}
+
 bool Source::queue(void *data, size_t length, int dataSampleRate, int dataBitDepth, int dataChannels)
 {
 	if (sourceType != TYPE_QUEUE)
@@ -806,7 +1141,10 @@ bool Source::queue(void *data, size_t length, int dataSampleRate, int dataBitDep
 	bufferedBytes += length;
 
 	if (valid)
+	{
 		alSourceQueueBuffers(source, 1, &buffer);
+		pool->wake();
+	}
 	else
 		streamBuffers.push(buffer);
 
@@ -842,18 +1180,22 @@ void Source::prepareAtomic()
 		alSourcei(source, AL_BUFFER, staticBuffer->getBuffer());
 		break;
 	case TYPE_STREAM:
+		decodeRing->prime();
+
 		while (!unusedBuffers.empty())
 		{
 			auto b = unusedBuffers.top();
-			if (streamAtomic(b, decoder.get()) == 0)
+			if (streamAtomic(b) == 0)
 				break;
 
 			alSourceQueueBuffers(source, 1, &b);
 			unusedBuffers.pop();
 
-			if (decoder->isFinished())
+			if (decodeRing->isFinished())
 				break;
 		}
+
+		decodeRing->schedule(pool->getDecodeWorkers());
 		break;
 	case TYPE_QUEUE:
 	{
@@ -868,8 +1210,10 @@ void Source::prepareAtomic()
 		break;
 	}
 
-	// Seek to the current/pending offset.
-	alSourcei(source, AL_SAMPLE_OFFSET, offsetSamples);
+	// Seek to the current/pending offset. Streaming Sources already started
+	// decoding there.
+	if (sourceType != TYPE_STREAM)
+		alSourcei(source, AL_SAMPLE_OFFSET, offsetSamples);
 }
 
 void Source::teardownAtomic()
@@ -884,7 +1228,7 @@ void Source::teardownAtomic()
 		ALuint buffers[MAX_BUFFERS];
 
 		// Some decoders (e.g. ModPlug) can rewind() more reliably than seek(0).
-		decoder->rewind();
+		decodeRing->rewind();
 
 		// Drain buffers.
 		// NOTE: The Apple implementation of OpenAL on iOS doesn't return
@@ -895,6 +1239,9 @@ void Source::teardownAtomic()
 
 		for (int i = 0; i < queued; i++)
 			unusedBuffers.push(buffers[i]);
+
+		bufferedBytes = 0;
+		bufferFinishTimes.clear();
 		break;
 	}
 	case TYPE_QUEUE:
@@ -954,6 +1301,12 @@ bool Source::playAtomic(ALuint source)
 
 void Source::stopAtomic()
 {
+	if (virtualized)
+	{
+		stopVirtualAtomic(true);
+		return;
+	}
+
 	if (!valid)
 		return;
 	alSourceStop(source);
@@ -962,12 +1315,21 @@ void Source::stopAtomic()
 
 void Source::pauseAtomic()
 {
-	if (valid)
+	if (virtualized)
+		virtualPaused = true;
+	else if (valid)
 		alSourcePause(source);
 }
 
 void Source::resumeAtomic()
 {
+	if (virtualized)
+	{
+		virtualPaused = false;
+		virtualTime = love::timer::Timer::getTime();
+		return;
+	}
+
 	if (valid && !isPlaying())
 	{
 		alSourcePlay(source);
@@ -978,6 +1340,62 @@ void Source::resumeAtomic()
 	}
 }
 
+void Source::setTransforms(const std::vector<love::audio::Source*> &sources, const float *transforms)
+{
+	if (sources.size() == 0)
+		return;
+
+#ifndef AL_SOFT_deferred_updates
+	typedef void (AL_APIENTRY*LPALDEFERUPDATESSOFT)(void);
+	typedef void (AL_APIENTRY*LPALPROCESSUPDATESSOFT)(void);
+#endif
+	static bool hasDeferredUpdates = alIsExtensionPresent("AL_SOFT_deferred_updates") == AL_TRUE;
+	static LPALDEFERUPDATESSOFT alDeferUpdatesSOFT = hasDeferredUpdates
+		? (LPALDEFERUPDATESSOFT) alGetProcAddress("alDeferUpdatesSOFT")
+		: nullptr;
+	static LPALPROCESSUPDATESSOFT alProcessUpdatesSOFT = hasDeferredUpdates
+		? (LPALPROCESSUPDATESSOFT) alGetProcAddress("alProcessUpdatesSOFT")
+		: nullptr;
+
+	// Don't change anything if one of the Sources can't be spatialized.
+	for (auto &_source : sources)
+	{
+		if (((Source*) _source)->channels > 1)
+			throw SpatialSupportException();
+	}
+
+	Pool *pool = ((Source*) sources[0])->pool;
+	Lock l = pool->lock();
+
+	// OpenAL Soft ignores context suspension, but it can defer updates.
+	bool deferred = alDeferUpdatesSOFT != nullptr && alProcessUpdatesSOFT != nullptr;
+	ALCcontext *context = alcGetCurrentContext();
+
+	if (deferred)
+		alDeferUpdatesSOFT();
+	else
+		alcSuspendContext(context);
+
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		Source *source = (Source*) sources[i];
+
+		source->setFloatv(source->position, &transforms[i * 6]);
+		source->setFloatv(source->velocity, &transforms[i * 6 + 3]);
+
+		if (source->valid)
+		{
+			alSourcefv(source->source, AL_POSITION, source->position);
+			alSourcefv(source->source, AL_VELOCITY, source->velocity);
+		}
+	}
+
+	if (deferred)
+		alProcessUpdatesSOFT();
+	else
+		alcProcessContext(context);
+}
+
 bool Source::play(const std::vector<love::audio::Source*> &sources)
 {
 	if (sources.size() == 0)
@@ -1006,6 +1424,15 @@ bool Source::play(const std::vector<love::audio::Source*> &sources)
 	toPlay.reserve(sources.size());
 	for (size_t i = 0; i < sources.size(); i++)
 	{
+		Source *source = (Source*) sources[i];
+
+		// Virtual Sources play once the Pool gives them a voice.
+		if (source->virtualized)
+		{
+			source->resumeAtomic();
+			continue;
+		}
+
 		// If the source was paused, wasPlaying[i] will be true but we still
 		// want to resume it. We don't want to call alSourcePlay on sources
 		// that are actually playing though.
@@ -1014,7 +1441,6 @@ bool Source::play(const std::vector<love::audio::Source*> &sources)
 
 		if (!wasPlaying[i])
 		{
-			Source *source = (Source*) sources[i];
 			source->source = ids[i];
 			source->prepareAtomic();
 		}
@@ -1023,12 +1449,16 @@ bool Source::play(const std::vector<love::audio::Source*> &sources)
 	}
 
 	alGetError();
-	alSourcePlayv((ALsizei) toPlay.size(), &toPlay[0]);
+	if (!toPlay.empty())
+		alSourcePlayv((ALsizei) toPlay.size(), &toPlay[0]);
 	bool success = alGetError() == AL_NO_ERROR;
 
 	for (auto &_source : sources)
 	{
 		Source *source = (Source*) _source;
+		if (source->virtualized)
+			continue;
+
 		source->valid = source->valid || success;
 
 		if (success && source->sourceType != TYPE_STREAM)
@@ -1055,13 +1485,16 @@ void Source::stop(const std::vector<love::audio::Source*> &sources)
 			sourceIds.push_back(source->source);
 	}
 
-	alSourceStopv((ALsizei) sourceIds.size(), &sourceIds[0]);
+	if (!sourceIds.empty())
+		alSourceStopv((ALsizei) sourceIds.size(), &sourceIds[0]);
 
 	for (auto &_source : sources)
 	{
 		Source *source = (Source*) _source;
 		if (source->valid)
 			source->teardownAtomic();
+		else if (source->virtualized)
+			source->stopVirtualAtomic(true);
 		pool->releaseSource(source, false);
 	}
 }
@@ -1080,9 +1513,12 @@ void Source::pause(const std::vector<love::audio::Source*> &sources)
 		Source *source = (Source*) _source;
 		if (source->valid)
 			sourceIds.push_back(source->source);
+		else if (source->virtualized)
+			source->virtualPaused = true;
 	}
 
-	alSourcePausev((ALsizei) sourceIds.size(), &sourceIds[0]);
+	if (!sourceIds.empty())
+		alSourcePausev((ALsizei) sourceIds.size(), &sourceIds[0]);
 }
 
 std::vector<love::audio::Source*> Source::pause(Pool *pool)
@@ -1144,20 +1580,33 @@ void Source::setFloatv(float *dst, const float *src) const
 	dst[2] = src[2];
 }
 
-int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
+int Source::streamAtomic(ALuint buffer)
 {
-	// Get more sound data.
-	int decoded = std::max(d->decode(), 0);
+	// Get more sound data, if the decode threads have any ready.
+	int decoded = 0;
+	bool loopPoint = false;
 
-	// OpenAL implementations are allowed to ignore 0-size alBufferData calls.
-	if (decoded > 0)
+	const DecodeRing::Chunk *chunk = decodeRing->peek();
+	if (chunk != nullptr)
 	{
-		int fmt = Audio::getFormat(d->getBitDepth(), d->getChannelCount());
+		decoded = chunk->size;
+		loopPoint = chunk->loopPoint;
 
-		if (fmt != AL_NONE)
-			alBufferData(buffer, fmt, d->getBuffer(), decoded, d->getSampleRate());
-		else
-			decoded = 0;
+		// OpenAL implementations are allowed to ignore 0-size alBufferData calls.
+		if (decoded > 0)
+		{
+			int fmt = Audio::getFormat(bitDepth, channels);
+
+			if (fmt != AL_NONE)
+				alBufferData(buffer, fmt, chunk->data.data(), decoded, sampleRate);
+			else
+				decoded = 0;
+		}
+
+		// Callers queue the buffer whenever it has data.
+		bufferedBytes += decoded;
+
+		decodeRing->pop();
 	}
 
 	// This shouldn't run after toLoop is calculated in this streamAtomic call,
@@ -1173,7 +1622,8 @@ int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
 		}
 	}
 
-	if (decoder->isFinished() && isLooping())
+	// The decode thread already rewound the decoder after this chunk.
+	if (loopPoint && isLooping())
 	{
 		int queued, processed;
 		alGetSourcei(source, AL_BUFFERS_QUEUED, &queued);
@@ -1182,7 +1632,6 @@ int Source::streamAtomic(ALuint buffer, love::sound::Decoder *d)
 			toLoop = queued-processed;
 		else
 			toLoop = buffers-processed;
-		d->rewind();
 	}
 
 	return decoded;
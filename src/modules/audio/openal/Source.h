@@ -30,10 +30,12 @@
 #include "sound/Decoder.h"
 #include "Audio.h"
 #include "Filter.h"
+#include "DecodeRing.h"
 
 // STL
 #include <vector>
 #include <stack>
+#include <unordered_map>
 
 // C
 #include <float.h>
@@ -130,6 +132,8 @@ class Source : public love::audio::Source
 	virtual bool isRelative() const;
 	void setLooping(bool looping);
 	bool isLooping() const;
+	virtual void setPriority(float priority);
+	virtual float getPriority() const;
 	virtual void setMinVolume(float volume);
 	virtual float getMinVolume() const;
 	virtual void setMaxVolume(float volume);
@@ -160,11 +164,60 @@ class Source : public love::audio::Source
 	void prepareAtomic();
 	void teardownAtomic();
 
+	/**
+	 * Gets how many seconds can pass before this playing Source needs another
+	 * update, or a negative value if it doesn't need one until something
+	 * changes. Must be called with the Pool locked.
+	 **/
+	double getNextUpdateDelay() const;
+
+	/**
+	 * Gets how loud this Source is for the listener at the given position,
+	 * from its volume and distance attenuation, ignoring effects and cones.
+	 **/
+	float getAudibility(const float *listener, ALint distanceModel) const;
+
+	/**
+	 * Whether the Pool may take this Source's OpenAL source away and make it
+	 * virtual. Queueable Sources can't be virtual.
+	 **/
+	bool canVirtualize() const;
+
+	/**
+	 * Whether the Pool's mix bus can play this Source while it's virtual.
+	 **/
+	bool isMixable() const;
+
+	// Virtual Sources are playing without an OpenAL source. They keep track
+	// of their position until the Pool gives them one.
+	void startVirtualAtomic();
+	void virtualizeAtomic();
+	bool devirtualizeAtomic(ALuint source);
+	void stopVirtualAtomic(bool rewind);
+
+	/**
+	 * Advances a virtual Source's position to the given time, unless the mix
+	 * bus advances it. Returns false once it has finished.
+	 **/
+	bool updateVirtualAtomic(double time, bool advance);
+
+	/**
+	 * Adds frames of this virtual Source to the interleaved stereo mix, at the
+	 * mix's sample rate. Returns false once it has finished.
+	 **/
+	bool mixAtomic(float *out, int frames, int outRate, float gain);
+
 	bool playAtomic(ALuint source);
 	void stopAtomic();
 	void pauseAtomic();
 	void resumeAtomic();
 
+	/**
+	 * Sets the position and velocity (6 floats per Source) of many Sources,
+	 * while holding the Pool lock and deferring OpenAL's updates once.
+	 **/
+	static void setTransforms(const std::vector<love::audio::Source*> &sources, const float *transforms);
+
 	static bool play(const std::vector<love::audio::Source*> &sources);
 	static void stop(const std::vector<love::audio::Source*> &sources);
 	static void pause(const std::vector<love::audio::Source*> &sources);
@@ -178,7 +231,10 @@ class Source : public love::audio::Source
 
 	void setFloatv(float *dst, const float *src) const;
 
-	int streamAtomic(ALuint buffer, love::sound::Decoder *d);
+	float getDistanceAttenuation(float distance, ALint distanceModel) const;
+	double getVirtualLength();
+
+	int streamAtomic(ALuint buffer);
 
 	Pool *pool = nullptr;
 	ALuint source = 0;
@@ -186,10 +242,19 @@ class Source : public love::audio::Source
 
 	const static int DEFAULT_BUFFERS = 8;
 	const static int MAX_BUFFERS = 64;
+
+	// Static Sources keep the sample data for the mix bus if it's enabled
+	// when they're created, and they're at most this large.
+	const static size_t MAX_MIX_DATA_SIZE = 1024 * 1024;
 	std::queue<ALuint> streamBuffers;
 	std::stack<ALuint> unusedBuffers;
 
+	// When each streaming buffer in unusedBuffers finished playing, so its
+	// refill latency can be recorded once it's queued again.
+	std::unordered_map<ALuint, double> bufferFinishTimes;
+
 	StrongRef<StaticDataBuffer> staticBuffer;
+	StrongRef<love::sound::SoundData> mixData;
 
 	float pitch = 1.0f;
 	float volume = 1.0f;
@@ -198,6 +263,7 @@ class Source : public love::audio::Source
 	float direction[3];
 	bool relative = false;
 	bool looping = false;
+	float priority = 0.0f;
 	float minVolume = 0.0f;
 	float maxVolume = 1.0f;
 	float referenceDistance = 1.0f;
@@ -215,11 +281,18 @@ class Source : public love::audio::Source
 
 	int offsetSamples = 0;
 
+	bool virtualized = false;
+	bool virtualPaused = false;
+	double virtualOffset = 0.0;
+	double virtualLength = -1.0;
+	double virtualTime = 0.0;
+
 	int sampleRate = 0;
 	int channels = 0;
 	int bitDepth = 0;
 
-	StrongRef<love::sound::Decoder> decoder;
+	// Decoded audio for streaming Sources, filled on the Pool's decode threads.
+	StrongRef<DecodeRing> decodeRing;
 
 	unsigned int toLoop = 0;
 	ALsizei bufferedBytes = 0;
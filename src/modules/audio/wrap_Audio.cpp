@@ -592,6 +592,71 @@ int w_setPlaybackDevice(lua_State* L)
 	return 0;
 }
 
+int w_getRefillLatencyHistogram(lua_State *L)
+{
+	std::vector<double> limits;
+	std::vector<uint64> counts;
+	instance()->getRefillLatencyHistogram(limits, counts);
+
+	lua_createtable(L, (int) counts.size(), 0);
+
+	for (size_t i = 0; i < counts.size(); i++)
+	{
+		lua_createtable(L, 2, 0);
+
+		lua_pushnumber(L, i < limits.size() ? limits[i] : HUGE_VAL);
+		lua_rawseti(L, -2, 1);
+		lua_pushnumber(L, (lua_Number) counts[i]);
+		lua_rawseti(L, -2, 2);
+
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 1;
+}
+
+int w_resetRefillLatencyHistogram(lua_State *)
+{
+	instance()->resetRefillLatencyHistogram();
+	return 0;
+}
+
+int w_getVirtualSourceCount(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getVirtualSourceCount());
+	lua_pushinteger(L, instance()->getMixBusSourceCount());
+	return 2;
+}
+
+int w_setMixBusEnabled(lua_State *L)
+{
+	bool enable = luax_checkboolean(L, 1);
+	luax_catchexcept(L, [&]() { instance()->setMixBusEnabled(enable); });
+	return 0;
+}
+
+int w_isMixBusEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isMixBusEnabled());
+	return 1;
+}
+
+int w_setSourceTransforms(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	std::vector<Source*> sources = readSourceList(L, 1);
+	Data *data = luax_checktype<Data>(L, 2);
+
+	size_t needed = sources.size() * 6 * sizeof(float);
+	if (data->getSize() < needed)
+		return luaL_error(L, "Data is too small for %d Source transforms (needs %d bytes, has %d.)",
+			(int) sources.size(), (int) needed, (int) data->getSize());
+
+	const float *transforms = (const float *) data->getData();
+	luax_catchexcept(L, [&]() { instance()->setSourceTransforms(sources, transforms); });
+	return 0;
+}
+
 // List of functions to wrap.
 static const luaL_Reg functions[] =
 {
@@ -626,6 +691,12 @@ static const luaL_Reg functions[] =
 	{ "getPlaybackDevice", w_getPlaybackDevice },
 	{ "getPlaybackDevices", w_getPlaybackDevices },
 	{ "setPlaybackDevice", w_setPlaybackDevice },
+	{ "getRefillLatencyHistogram", w_getRefillLatencyHistogram },
+	{ "resetRefillLatencyHistogram", w_resetRefillLatencyHistogram },
+	{ "getVirtualSourceCount", w_getVirtualSourceCount },
+	{ "setMixBusEnabled", w_setMixBusEnabled },
+	{ "isMixBusEnabled", w_isMixBusEnabled },
+	{ "setSourceTransforms", w_setSourceTransforms },
 
 	{ 0, 0 }
 };
@@ -261,6 +261,20 @@ int w_Source_isLooping(lua_State *L)
 	return 1;
 }
 
+int w_Source_setPriority(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	t->setPriority((float) luaL_checknumber(L, 2));
+	return 0;
+}
+
+int w_Source_getPriority(lua_State *L)
+{
+	Source *t = luax_checksource(L, 1);
+	lua_pushnumber(L, t->getPriority());
+	return 1;
+}
+
 int w_Source_isPlaying(lua_State *L)
 {
 	Source *t = luax_checksource(L, 1);
@@ -631,6 +645,8 @@ static const luaL_Reg w_Source_functions[] =
 	{ "setLooping", w_Source_setLooping },
 	{ "isLooping", w_Source_isLooping },
 	{ "isPlaying", w_Source_isPlaying },
+	{ "setPriority", w_Source_setPriority },
+	{ "getPriority", w_Source_getPriority },
 
 	{ "setVolumeLimits", w_Source_setVolumeLimits },
 	{ "getVolumeLimits", w_Source_getVolumeLimits },
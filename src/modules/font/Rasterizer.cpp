@@ -112,5 +112,10 @@ float Rasterizer::getDPIScale() const
 	return dpiScale;
 }
 
+bool Rasterizer::isSDF() const
+{
+	return sdf;
+}
+
 } // font
 } // love
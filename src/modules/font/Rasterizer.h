@@ -143,11 +143,17 @@ class Rasterizer : public Object
 
 	float getDPIScale() const;
 
+	/**
+	 * Gets whether the glyphs contain signed distance fields (in their alpha
+	 * channel) instead of coverage.
+	 **/
+	bool isSDF() const;
+
 protected:
 
 	FontMetrics metrics;
 	float dpiScale;
-	bool sdf;
+	bool sdf = false;
 
 }; // Rasterizer
 
@@ -115,6 +115,8 @@ float TextShaper::getCombinedHeight() const
 
 void TextShaper::setLineHeight(float h)
 {
+	if (h != lineHeight)
+		clearShapeCache();
 	lineHeight = h;
 }
 
@@ -274,11 +276,113 @@ float TextShaper::getWidth(const std::string& str)
 	getCodepointsFromString(str, codepoints.cps);
 
 	TextInfo info;
-	computeGlyphPositions(codepoints, Range(), Vector2(0.0f, 0.0f), 0.0f, nullptr, nullptr, &info);
+	getGlyphPositions(codepoints, Range(), Vector2(0.0f, 0.0f), 0.0f, nullptr, nullptr, &info);
 
 	return info.width;
 }
 
+void TextShaper::computeShapeCacheHash(ShapeCacheKey &key)
+{
+	// 64 bit FNV-1a.
+	uint64 hash = 0xCBF29CE484222325ULL;
+
+	const auto hashbytes = [&](const void *data, size_t size)
+	{
+		const uint8 *bytes = (const uint8 *) data;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 0x100000001B3ULL;
+		}
+	};
+
+	if (!key.cps.empty())
+		hashbytes(key.cps.data(), key.cps.size() * sizeof(uint32));
+
+	for (const IndexedColor &c : key.colors)
+	{
+		hashbytes(&c.index, sizeof(int));
+		hashbytes(&c.color, sizeof(Colorf));
+	}
+
+	hashbytes(&key.range.first, sizeof(size_t));
+	hashbytes(&key.range.last, sizeof(size_t));
+	hashbytes(&key.param, sizeof(float));
+
+	key.hash = hash;
+}
+
+void TextShaper::getGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info)
+{
+	if (codepoints.cps.empty())
+		return computeGlyphPositions(codepoints, range, offset, extraspacing, positions, colors, info);
+
+	if (!range.isValid())
+		range = Range(0, codepoints.cps.size());
+
+	// The key is the range plus the surrounding codepoints the shaper may look
+	// at, so a cached run is identical to what shaping it again would produce.
+	size_t windowstart = range.first - std::min(range.first, SHAPE_CONTEXT_LENGTH);
+	size_t windowend = std::min(range.last + 1 + SHAPE_CONTEXT_LENGTH, codepoints.cps.size());
+
+	ShapeCacheKey key;
+	key.cps.assign(codepoints.cps.begin() + windowstart, codepoints.cps.begin() + windowend);
+	key.range = Range(range.first - windowstart, range.getSize());
+	key.param = extraspacing;
+
+	// Only the last color before the range and the colors inside it matter.
+	for (const IndexedColor &c : codepoints.colors)
+	{
+		if (c.index > (int) range.last)
+			break;
+
+		IndexedColor relative = {c.color, std::max(c.index - (int) range.first, -1)};
+		if (relative.index < 0 && !key.colors.empty())
+			key.colors.back() = relative;
+		else
+			key.colors.push_back(relative);
+	}
+
+	computeShapeCacheHash(key);
+
+	ShapedRun *run = shapedRuns.find(key);
+	if (run == nullptr)
+	{
+		run = &shapedRuns.insert(std::move(key));
+		computeGlyphPositions(codepoints, range, Vector2(0.0f, 0.0f), extraspacing, &run->positions, &run->colors, &run->info);
+	}
+
+	if (positions)
+	{
+		int startindex = (int) positions->size();
+
+		positions->reserve(positions->size() + run->positions.size());
+		for (GlyphPosition p : run->positions)
+		{
+			p.position += offset;
+			positions->push_back(p);
+		}
+
+		if (colors)
+		{
+			for (IndexedColor c : run->colors)
+			{
+				c.index += startindex;
+				colors->push_back(c);
+			}
+		}
+	}
+
+	if (info)
+		*info = run->info;
+}
+
+void TextShaper::clearShapeCache()
+{
+	shapedRuns.clear();
+	wrappedTexts.clear();
+}
+
 static size_t findNewline(const ColoredCodepoints &codepoints, size_t start)
 {
 	for (size_t i = start; i < codepoints.cps.size(); i++)
@@ -293,6 +397,27 @@ static size_t findNewline(const ColoredCodepoints &codepoints, size_t start)
 }
 
 void TextShaper::getWrap(const ColoredCodepoints &codepoints, float wraplimit, std::vector<Range> &lineranges, std::vector<float> *linewidths)
+{
+	// Word wrapping doesn't depend on colors, so only the codepoints and wrap
+	// limit are part of the key.
+	ShapeCacheKey key;
+	key.cps = codepoints.cps;
+	key.param = wraplimit;
+	computeShapeCacheHash(key);
+
+	WrappedText *wrapped = wrappedTexts.find(key);
+	if (wrapped == nullptr)
+	{
+		wrapped = &wrappedTexts.insert(std::move(key));
+		computeWrap(codepoints, wraplimit, wrapped->lineRanges, wrapped->lineWidths);
+	}
+
+	lineranges.insert(lineranges.end(), wrapped->lineRanges.begin(), wrapped->lineRanges.end());
+	if (linewidths)
+		linewidths->insert(linewidths->end(), wrapped->lineWidths.begin(), wrapped->lineWidths.end());
+}
+
+void TextShaper::computeWrap(const ColoredCodepoints &codepoints, float wraplimit, std::vector<Range> &lineranges, std::vector<float> &linewidths)
 {
 	size_t nextnewline = findNewline(codepoints, 0);
 
@@ -304,8 +429,7 @@ void TextShaper::getWrap(const ColoredCodepoints &codepoints, float wraplimit, s
 		if (nextnewline == i) // Empty line.
 		{
 			lineranges.push_back(Range());
-			if (linewidths)
-				linewidths->push_back(0);
+			linewidths.push_back(0);
 			i++;
 		}
 		else
@@ -330,8 +454,7 @@ void TextShaper::getWrap(const ColoredCodepoints &codepoints, float wraplimit, s
 				i++;
 
 			lineranges.push_back(r);
-			if (linewidths)
-				linewidths->push_back(width);
+			linewidths.push_back(width);
 		}
 	}
 }
@@ -377,6 +500,7 @@ void TextShaper::setFallbacks(const std::vector<Rasterizer*> &fallbacks)
 	// Clear caches.
 	kerning.clear();
 	glyphAdvances.clear();
+	clearShapeCache();
 
 	rasterizers.resize(1);
 	dpiScales.resize(1);
@@ -29,6 +29,8 @@
 
 #include <vector>
 #include <string>
+#include <list>
+#include <algorithm>
 #include <unordered_map>
 
 namespace love
@@ -126,6 +128,17 @@ class TextShaper : public Object
 	void getWrap(const std::vector<ColoredString> &text, float wraplimit, std::vector<std::string> &lines, std::vector<float> *linewidths = nullptr);
 	void getWrap(const ColoredCodepoints &codepoints, float wraplimit, std::vector<Range> &lineranges, std::vector<float> *linewidths = nullptr);
 
+	/**
+	 * Same as computeGlyphPositions, but the shaped run is kept in a bounded
+	 * LRU cache so text which is drawn repeatedly is only shaped once.
+	 **/
+	void getGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info);
+
+	/**
+	 * Discards all cached shaped runs and word-wrapped line ranges.
+	 **/
+	void clearShapeCache();
+
 	virtual void setFallbacks(const std::vector<Rasterizer *> &fallbacks);
 
 	virtual void computeGlyphPositions(const ColoredCodepoints &codepoints, Range range, Vector2 offset, float extraspacing, std::vector<GlyphPosition> *positions, std::vector<IndexedColor> *colors, TextInfo *info) = 0;
@@ -142,6 +155,99 @@ class TextShaper : public Object
 
 private:
 
+	// Maximum number of entries in each of the shape caches.
+	static constexpr size_t MAX_CACHED_RUNS = 1024;
+
+	// Number of codepoints on either side of a range which can influence how
+	// it's shaped. Harfbuzz uses at most 5 codepoints of context.
+	static constexpr size_t SHAPE_CONTEXT_LENGTH = 5;
+
+	struct ShapeCacheKey
+	{
+		std::vector<uint32> cps;
+		std::vector<IndexedColor> colors;
+		Range range;
+		float param;
+		uint64 hash;
+
+		bool operator == (const ShapeCacheKey &other) const
+		{
+			return hash == other.hash && range.first == other.range.first && range.last == other.range.last
+				&& param == other.param && cps == other.cps && colors.size() == other.colors.size()
+				&& std::equal(colors.begin(), colors.end(), other.colors.begin(), [](const IndexedColor &a, const IndexedColor &b)
+				{
+					return a.index == b.index && a.color == b.color;
+				});
+		}
+	};
+
+	struct ShapedRun
+	{
+		std::vector<GlyphPosition> positions;
+		std::vector<IndexedColor> colors;
+		TextInfo info;
+	};
+
+	struct WrappedText
+	{
+		std::vector<Range> lineRanges;
+		std::vector<float> lineWidths;
+	};
+
+	template <typename T>
+	class ShapeCache
+	{
+	public:
+
+		T *find(const ShapeCacheKey &key)
+		{
+			auto it = lookup.find(key.hash);
+			if (it == lookup.end() || !(it->second->first == key))
+				return nullptr;
+
+			// Move the entry to the front, so the back is always the least
+			// recently used.
+			entries.splice(entries.begin(), entries, it->second);
+			return &it->second->second;
+		}
+
+		T &insert(ShapeCacheKey &&key)
+		{
+			auto it = lookup.find(key.hash);
+			if (it != lookup.end())
+			{
+				entries.erase(it->second);
+				lookup.erase(it);
+			}
+			else if (entries.size() >= MAX_CACHED_RUNS)
+			{
+				lookup.erase(entries.back().first.hash);
+				entries.pop_back();
+			}
+
+			uint64 hash = key.hash;
+			entries.emplace_front(std::move(key), T());
+			lookup[hash] = entries.begin();
+			return entries.front().second;
+		}
+
+		void clear()
+		{
+			entries.clear();
+			lookup.clear();
+		}
+
+	private:
+
+		std::list<std::pair<ShapeCacheKey, T>> entries;
+		std::unordered_map<uint64, typename std::list<std::pair<ShapeCacheKey, T>>::iterator> lookup;
+
+	}; // ShapeCache
+
+	static void computeShapeCacheHash(ShapeCacheKey &key);
+
+	void computeWrap(const ColoredCodepoints &codepoints, float wraplimit, std::vector<Range> &lineranges, std::vector<float> &linewidths);
+
 	int height;
 	int pixelHeight;
 	float lineHeight;
@@ -154,6 +260,10 @@ class TextShaper : public Object
 	// map of left/right glyph pairs to horizontal kerning.
 	std::unordered_map<uint64, float> kerning;
 
+	// Shaped glyph runs and word-wrapped line ranges of recently used text.
+	ShapeCache<ShapedRun> shapedRuns;
+	ShapeCache<WrappedText> wrappedTexts;
+
 }; // TextShaper
 
 } // font
@@ -98,6 +98,13 @@ int w_Rasterizer_getGlyphCount(lua_State *L)
 	return 1;
 }
 
+int w_Rasterizer_isSDF(lua_State *L)
+{
+	Rasterizer *t = luax_checkrasterizer(L, 1);
+	luax_pushboolean(L, t->isSDF());
+	return 1;
+}
+
 int w_Rasterizer_hasGlyphs(lua_State *L)
 {
 	Rasterizer *t = luax_checkrasterizer(L, 1);
@@ -134,6 +141,7 @@ const luaL_Reg w_Rasterizer_functions[] =
 	{ "getGlyphData", w_Rasterizer_getGlyphData },
 	{ "getGlyphCount", w_Rasterizer_getGlyphCount },
 	{ "hasGlyphs", w_Rasterizer_hasGlyphs },
+	{ "isSDF", w_Rasterizer_isSDF },
 	{ 0, 0 }
 };
 
@@ -0,0 +1,198 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+
+// LOVE
+#include "AsyncShader.h"
+#include "Graphics.h"
+#include "thread/WorkerPool.h"
+#include "thread/threads.h"
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type AsyncShader::type("AsyncShader", &Object::type);
+
+// State shared with the worker thread. The AsyncShader can be destroyed
+// before the job runs, so the job owns a reference as well.
+struct AsyncShader::Job
+{
+	thread::MutexRef mutex;
+	thread::ConditionalRef finished;
+	bool done = false;
+
+	bool gles = false;
+	std::string glsl[SHADERSTAGE_MAX_ENUM];
+	Precompiler precompiler;
+
+	StrongRef<ShaderStage> stages[SHADERSTAGE_MAX_ENUM];
+	PrecompileFinisher precompileFinisher;
+	std::string error;
+
+	void run();
+};
+
+void AsyncShader::Job::run()
+{
+	StrongRef<ShaderStage> parsed[SHADERSTAGE_MAX_ENUM];
+	PrecompileFinisher finisher;
+	std::string err;
+
+	try
+	{
+		for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+		{
+			if (!glsl[i].empty())
+				parsed[i].set(new ShaderStageForValidation(nullptr, (ShaderStageType) i, glsl[i], gles), Acquire::NORETAIN);
+		}
+	}
+	catch (std::exception &e)
+	{
+		err = e.what();
+	}
+	catch (...)
+	{
+		err = "Unknown error while validating shader.";
+	}
+
+	// Backend errors here are reported again (with more context) when the
+	// Shader is created on the main thread.
+	if (err.empty() && precompiler)
+	{
+		try
+		{
+			finisher = precompiler(glsl);
+		}
+		catch (love::Exception &)
+		{
+		}
+		catch (std::exception &e)
+		{
+			err = e.what();
+		}
+		catch (...)
+		{
+			err = "Unknown error while precompiling shader.";
+		}
+	}
+
+	// Only moves happen below, so done is always set and wait() can't block
+	// forever.
+
+	thread::Lock lock(mutex);
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+		stages[i] = parsed[i];
+
+	precompileFinisher = std::move(finisher);
+	error = std::move(err);
+	done = true;
+
+	finished->broadcast();
+}
+
+AsyncShader::AsyncShader(thread::WorkerPool *pool, const std::vector<std::string> &stagessource, const Shader::CompileOptions &options, const std::string glsl[SHADERSTAGE_MAX_ENUM], bool gles, const Precompiler &precompiler, Shader *fallback)
+	: job(std::make_shared<Job>())
+	, stagesSource(stagessource)
+	, options(options)
+	, status(STATUS_COMPILING)
+	, fallback(fallback)
+{
+	job->gles = gles;
+	job->precompiler = precompiler;
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+		job->glsl[i] = glsl[i];
+
+	auto sharedjob = job;
+	pool->submit([sharedjob]() { sharedjob->run(); });
+}
+
+AsyncShader::~AsyncShader()
+{
+}
+
+void AsyncShader::update()
+{
+	if (status != STATUS_COMPILING)
+		return;
+
+	{
+		thread::Lock lock(job->mutex);
+		if (!job->done)
+			return;
+	}
+
+	finish();
+}
+
+void AsyncShader::wait()
+{
+	if (status != STATUS_COMPILING)
+		return;
+
+	{
+		thread::Lock lock(job->mutex);
+		while (!job->done)
+			job->finished->wait(job->mutex);
+	}
+
+	finish();
+}
+
+void AsyncShader::finish()
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	if (!job->error.empty())
+		error = job->error;
+	else if (gfx == nullptr)
+		error = "Cannot create a Shader without the love.graphics module.";
+	else
+	{
+		try
+		{
+			if (job->precompileFinisher)
+				job->precompileFinisher(gfx);
+
+			shader.set(gfx->newShader(stagesSource, options, job->stages), Acquire::NORETAIN);
+		}
+		catch (love::Exception &e)
+		{
+			error = e.what();
+		}
+	}
+
+	status = shader.get() != nullptr ? STATUS_COMPLETE : STATUS_ERROR;
+
+	job.reset();
+	stagesSource.clear();
+}
+
+Shader *AsyncShader::getActiveShader() const
+{
+	if (shader.get() != nullptr)
+		return shader.get();
+	return fallback.get();
+}
+
+} // graphics
+} // love
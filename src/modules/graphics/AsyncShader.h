@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "Shader.h"
+#include "ShaderStage.h"
+
+// C++
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace love
+{
+
+namespace thread
+{
+class WorkerPool;
+}
+
+namespace graphics
+{
+
+class Graphics;
+
+/**
+ * A Shader which is validated (and on some backends compiled) on a worker
+ * thread. Creating the final Shader object still happens on the main thread,
+ * the first time the AsyncShader is queried after the background work has
+ * finished.
+ **/
+class AsyncShader : public love::Object
+{
+public:
+
+	enum Status
+	{
+		STATUS_COMPILING,
+		STATUS_COMPLETE,
+		STATUS_ERROR,
+		STATUS_MAX_ENUM
+	};
+
+	// Applies the result of a Precompiler on the main thread.
+	typedef std::function<void(Graphics *gfx)> PrecompileFinisher;
+
+	// Optional backend work which runs on the worker thread after validation.
+	// It must not access the Graphics object.
+	typedef std::function<PrecompileFinisher(const std::string glsl[SHADERSTAGE_MAX_ENUM])> Precompiler;
+
+	static love::Type type;
+
+	AsyncShader(thread::WorkerPool *pool, const std::vector<std::string> &stagessource, const Shader::CompileOptions &options, const std::string glsl[SHADERSTAGE_MAX_ENUM], bool gles, const Precompiler &precompiler, Shader *fallback);
+	virtual ~AsyncShader();
+
+	/**
+	 * Creates the Shader if the background work has finished. Must be called
+	 * from the main thread.
+	 **/
+	void update();
+
+	/**
+	 * Blocks until the background work has finished, and creates the Shader.
+	 * Must be called from the main thread.
+	 **/
+	void wait();
+
+	Status getStatus() const { return status; }
+	bool isComplete() const { return status != STATUS_COMPILING; }
+	bool hasError() const { return status == STATUS_ERROR; }
+	const std::string &getError() const { return error; }
+
+	Shader *getShader() const { return shader.get(); }
+	Shader *getFallback() const { return fallback.get(); }
+
+	/**
+	 * Gets the compiled Shader if it's ready, or the fallback otherwise.
+	 **/
+	Shader *getActiveShader() const;
+
+private:
+
+	struct Job;
+
+	void finish();
+
+	std::shared_ptr<Job> job;
+
+	std::vector<std::string> stagesSource;
+	Shader::CompileOptions options;
+
+	Status status;
+	std::string error;
+
+	StrongRef<Shader> shader;
+	StrongRef<Shader> fallback;
+
+}; // AsyncShader
+
+} // graphics
+} // love
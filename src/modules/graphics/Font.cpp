@@ -61,12 +61,23 @@ Font::Font(love::font::Rasterizer *r, const SamplerState &s)
 	, textureHeight(128)
 	, samplerState()
 	, dpiScale(r->getDPIScale())
+	, sdf(r->isSDF())
 	, textureCacheID(0)
+	, currentFrame(0)
+	, atlasEvictions(0)
 {
 	samplerState.minFilter = s.minFilter;
 	samplerState.magFilter = s.magFilter;
 	samplerState.maxAnisotropy = s.maxAnisotropy;
 
+	// Distance fields only work well with linear filtering, since they're
+	// meant to be scaled.
+	if (sdf)
+	{
+		samplerState.minFilter = SamplerState::FILTER_LINEAR;
+		samplerState.magFilter = SamplerState::FILTER_LINEAR;
+	}
+
 	// Try to find the best texture size match for the font size. default to the
 	// largest texture size if no rough match is found.
 	while (true)
@@ -134,7 +145,7 @@ bool Font::loadVolatile()
 {
 	textureCacheID++;
 	glyphs.clear();
-	textures.clear();
+	pages.clear();
 	createTexture();
 	return true;
 }
@@ -152,11 +163,11 @@ void Font::createTexture()
 	// If we have an existing texture already, we'll try replacing it with a
 	// larger-sized one rather than creating a second one. Having a single
 	// texture reduces texture switches and draw calls when rendering.
-	if ((nextsize.width > size.width || nextsize.height > size.height) && !textures.empty())
+	if ((nextsize.width > size.width || nextsize.height > size.height) && !pages.empty())
 	{
 		recreatetexture = true;
 		size = nextsize;
-		textures.pop_back();
+		pages.pop_back();
 	}
 
 	Texture::Settings settings;
@@ -166,65 +177,60 @@ void Font::createTexture()
 	texture = gfx->newTexture(settings, nullptr);
 	texture->setSamplerState(samplerState);
 
-	{
-		size_t datasize = getPixelFormatSliceSize(pixelFormat, size.width, size.height);
-		size_t pixelcount = size.width * size.height;
-
-		// Initialize the texture with transparent white for truetype fonts
-		// (since we keep luminance constant and vary alpha in those glyphs),
-		// and transparent black otherwise.
-		std::vector<uint8> emptydata(datasize, 0);
-
-		if (shaper->getRasterizers()[0]->getDataType() == font::Rasterizer::DATA_TRUETYPE)
-		{
-			if (pixelFormat == PIXELFORMAT_LA8_UNORM)
-			{
-				for (size_t i = 0; i < pixelcount; i++)
-					emptydata[i * 2 + 0] = 255;
-			}
-			else if (pixelFormat == PIXELFORMAT_RGBA8_UNORM)
-			{
-				for (size_t i = 0; i < pixelcount; i++)
-				{
-					emptydata[i * 4 + 0] = 255;
-					emptydata[i * 4 + 1] = 255;
-					emptydata[i * 4 + 2] = 255;
-				}
-			}
-		}
-
-		Rect rect = {0, 0, size.width, size.height};
-		texture->replacePixels(emptydata.data(), emptydata.size(), 0, 0, rect, false);
-	}
-
-	textures.emplace_back(texture, Acquire::NORETAIN);
+	AtlasPage page;
+	page.texture.set(texture, Acquire::NORETAIN);
+	page.nextShelfY = TEXTURE_PADDING;
+	pages.push_back(std::move(page));
 
 	textureWidth  = size.width;
 	textureHeight = size.height;
 
-	rowHeight = textureX = textureY = TEXTURE_PADDING;
+	clearTextureRegion(texture, {0, 0, size.width, size.height});
 
-	// Re-add the old glyphs if we re-created the existing texture object.
+	// The glyphs in the old texture are added back as they're used, rather
+	// than all at once here.
 	if (recreatetexture)
 	{
 		textureCacheID++;
+		glyphs.clear();
+	}
+}
 
-		std::vector<love::font::TextShaper::GlyphIndex> glyphstoadd;
+void Font::clearTextureRegion(Texture *texture, const Rect &rect)
+{
+	size_t datasize = getPixelFormatSliceSize(pixelFormat, rect.w, rect.h);
+	size_t pixelcount = (size_t) rect.w * rect.h;
 
-		for (const auto &glyphpair : glyphs)
-			glyphstoadd.push_back(unpackGlyphIndex(glyphpair.first));
+	// Initialize the texture with transparent white for truetype fonts
+	// (since we keep luminance constant and vary alpha in those glyphs),
+	// and transparent black otherwise.
+	std::vector<uint8> emptydata(datasize, 0);
 
-		glyphs.clear();
-		
-		for (auto glyphindex : glyphstoadd)
-			addGlyph(glyphindex);
+	if (shaper->getRasterizers()[0]->getDataType() == font::Rasterizer::DATA_TRUETYPE)
+	{
+		if (pixelFormat == PIXELFORMAT_LA8_UNORM)
+		{
+			for (size_t i = 0; i < pixelcount; i++)
+				emptydata[i * 2 + 0] = 255;
+		}
+		else if (pixelFormat == PIXELFORMAT_RGBA8_UNORM)
+		{
+			for (size_t i = 0; i < pixelcount; i++)
+			{
+				emptydata[i * 4 + 0] = 255;
+				emptydata[i * 4 + 1] = 255;
+				emptydata[i * 4 + 2] = 255;
+			}
+		}
 	}
+
+	texture->replacePixels(emptydata.data(), emptydata.size(), 0, 0, rect, false);
 }
 
 void Font::unloadVolatile()
 {
 	glyphs.clear();
-	textures.clear();
+	pages.clear();
 }
 
 love::font::GlyphData *Font::getRasterizerGlyphData(love::font::TextShaper::GlyphIndex glyphindex, float &dpiscale)
@@ -234,44 +240,169 @@ love::font::GlyphData *Font::getRasterizerGlyphData(love::font::TextShaper::Glyp
 	return r->getGlyphDataForIndex(glyphindex.index);
 }
 
-const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
+bool Font::findGlyphSpace(int w, int h, int &page, int &shelf)
 {
-	float glyphdpiscale = getDPIScale();
-	StrongRef<love::font::GlyphData> gd(getRasterizerGlyphData(glyphindex, glyphdpiscale), Acquire::NORETAIN);
+	int paddedw = w + TEXTURE_PADDING;
+	int paddedh = h + TEXTURE_PADDING;
 
-	int w = gd->getWidth();
-	int h = gd->getHeight();
+	// Use the shortest shelf with enough room left, so glyphs of different
+	// heights don't leave gaps in each other's shelves.
+	int bestheight = std::numeric_limits<int>::max();
+	page = shelf = -1;
 
-	if (w + TEXTURE_PADDING * 2 < textureWidth && h + TEXTURE_PADDING * 2 < textureHeight)
+	for (int p = 0; p < (int) pages.size(); p++)
 	{
-		if (textureX + w + TEXTURE_PADDING > textureWidth)
+		const auto &shelves = pages[p].shelves;
+		for (int i = 0; i < (int) shelves.size(); i++)
 		{
-			// Out of space - new row!
-			textureX = TEXTURE_PADDING;
-			textureY += rowHeight;
-			rowHeight = TEXTURE_PADDING;
+			const Shelf &s = shelves[i];
+			if (s.height >= paddedh && s.height < bestheight && s.x + paddedw <= textureWidth)
+			{
+				bestheight = s.height;
+				page = p;
+				shelf = i;
+			}
 		}
+	}
 
-		if (textureY + h + TEXTURE_PADDING > textureHeight)
-		{
-			// Totally out of space - new texture!
-			createTexture();
+	if (page >= 0)
+		return true;
+
+	// Otherwise start a new shelf in the first texture with space left.
+	if (paddedw + TEXTURE_PADDING > textureWidth)
+		return false;
+
+	for (int p = 0; p < (int) pages.size(); p++)
+	{
+		AtlasPage &atlaspage = pages[p];
+		if (atlaspage.nextShelfY + paddedh > textureHeight)
+			continue;
+
+		Shelf s;
+		s.y = atlaspage.nextShelfY;
+		s.height = paddedh;
+		s.x = TEXTURE_PADDING;
+		s.usedArea = 0;
+		s.lastUsedFrame = currentFrame;
+
+		atlaspage.nextShelfY += paddedh;
+		atlaspage.shelves.push_back(s);
+
+		page = p;
+		shelf = (int) atlaspage.shelves.size() - 1;
+		return true;
+	}
+
+	return false;
+}
 
-			// Makes sure the above code for checking if the glyph can fit at
-			// the current position in the texture is run again for this glyph.
-			return addGlyph(glyphindex);
+bool Font::evictShelf(int h, int &page, int &shelf)
+{
+	int paddedh = h + TEXTURE_PADDING;
+	page = shelf = -1;
+
+	// Evict the least recently used shelf which is tall enough. Glyphs used
+	// in the current or previous frame are never evicted, since vertices
+	// referencing them may still be waiting to be drawn, and text drawn every
+	// frame (TextBatches, or print calls) would otherwise evict each other's
+	// glyphs every frame once the atlas is full.
+	uint64 oldestframe = currentFrame > 0 ? currentFrame - 1 : 0;
+
+	for (int p = 0; p < (int) pages.size(); p++)
+	{
+		const auto &shelves = pages[p].shelves;
+		for (int i = 0; i < (int) shelves.size(); i++)
+		{
+			const Shelf &s = shelves[i];
+			if (s.height >= paddedh && s.lastUsedFrame < oldestframe)
+			{
+				oldestframe = s.lastUsedFrame;
+				page = p;
+				shelf = i;
+			}
 		}
 	}
 
+	if (page < 0)
+		return false;
+
+	Shelf &s = pages[page].shelves[shelf];
+
+	for (uint64 packedindex : s.glyphs)
+		glyphs.erase(packedindex);
+
+	atlasEvictions += (int64) s.glyphs.size();
+
+	s.glyphs.clear();
+	s.x = TEXTURE_PADDING;
+	s.usedArea = 0;
+	s.lastUsedFrame = currentFrame;
+
+	// Only the evicted shelf is re-uploaded.
+	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+	gfx->flushBatchedDraws();
+	clearTextureRegion(pages[page].texture, {0, s.y, textureWidth, s.height});
+
+	// Existing vertices (in TextBatches for example) might use the evicted
+	// glyphs.
+	textureCacheID++;
+
+	return true;
+}
+
+void Font::allocateGlyphSpace(int w, int h, int &page, int &shelf)
+{
+	if (findGlyphSpace(w, h, page, shelf))
+		return;
+
+	// Grow the texture if possible. Otherwise evict old glyphs rather than
+	// adding more textures, unless every glyph is still in use.
+	TextureSize nextsize = getNextTextureSize();
+	bool cangrow = nextsize.width > textureWidth || nextsize.height > textureHeight;
+
+	if (cangrow)
+	{
+		createTexture();
+		return allocateGlyphSpace(w, h, page, shelf);
+	}
+
+	if (w + TEXTURE_PADDING * 2 > textureWidth || h + TEXTURE_PADDING * 2 > textureHeight)
+		throw love::Exception("Font glyph is too large to fit in a texture atlas.");
+
+	if (evictShelf(h, page, shelf))
+		return;
+
+	createTexture();
+	findGlyphSpace(w, h, page, shelf);
+}
+
+const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
+{
+	float glyphdpiscale = getDPIScale();
+	StrongRef<love::font::GlyphData> gd(getRasterizerGlyphData(glyphindex, glyphdpiscale), Acquire::NORETAIN);
+
+	int w = gd->getWidth();
+	int h = gd->getHeight();
+
 	Glyph g;
 
 	g.texture = nullptr;
 	memset(g.vertices, 0, sizeof(GlyphVertex) * 4);
+	g.page = -1;
+	g.shelf = -1;
+
+	uint64 packedindex = packGlyphIndex(glyphindex);
 
 	// Don't waste space for empty glyphs.
 	if (w > 0 && h > 0)
 	{
-		Texture *texture = textures.back();
+		allocateGlyphSpace(w, h, g.page, g.shelf);
+
+		Shelf &shelf = pages[g.page].shelves[g.shelf];
+		int textureX = shelf.x;
+		int textureY = shelf.y;
+
+		Texture *texture = pages[g.page].texture;
 		g.texture = texture;
 
 		Rect rect = {textureX, textureY, gd->getWidth(), gd->getHeight()};
@@ -333,11 +464,12 @@ const Font::Glyph &Font::addGlyph(love::font::TextShaper::GlyphIndex glyphindex)
 			g.vertices[i].y /= glyphdpiscale;
 		}
 
-		textureX += w + TEXTURE_PADDING;
-		rowHeight = std::max(rowHeight, h + TEXTURE_PADDING);
+		shelf.x += w + TEXTURE_PADDING;
+		shelf.usedArea += (int64) (w + TEXTURE_PADDING) * shelf.height;
+		shelf.lastUsedFrame = currentFrame;
+		shelf.glyphs.push_back(packedindex);
 	}
 
-	uint64 packedindex = packGlyphIndex(glyphindex);
 	glyphs[packedindex] = g;
 	return glyphs[packedindex];
 }
@@ -348,11 +480,33 @@ const Font::Glyph &Font::findGlyph(love::font::TextShaper::GlyphIndex glyphindex
 	const auto it = glyphs.find(packedindex);
 
 	if (it != glyphs.end())
-		return it->second;
+	{
+		const Glyph &g = it->second;
+		if (g.page >= 0)
+			pages[g.page].shelves[g.shelf].lastUsedFrame = currentFrame;
+		return g;
+	}
 
 	return addGlyph(glyphindex);
 }
 
+void Font::touchShelves(const std::vector<ShelfID> &shelves)
+{
+	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+	if (gfx == nullptr)
+		return;
+
+	uint64 frame = gfx->getFrameNumber();
+
+	for (ShelfID id : shelves)
+	{
+		size_t page = id >> 16;
+		size_t shelf = id & 0xFFFF;
+		if (page < pages.size() && shelf < pages[page].shelves.size())
+			pages[page].shelves[shelf].lastUsedFrame = frame;
+	}
+}
+
 float Font::getKerning(uint32 leftglyph, uint32 rightglyph)
 {
 	return shaper->getKerning(leftglyph, rightglyph);
@@ -368,15 +522,21 @@ float Font::getHeight() const
 	return shaper->getHeight();
 }
 
-std::vector<Font::DrawCommand> Font::generateVertices(const love::font::ColoredCodepoints &codepoints, Range range, const Colorf &constantcolor, std::vector<GlyphVertex> &vertices, float extra_spacing, Vector2 offset, love::font::TextShaper::TextInfo *info)
+std::vector<Font::DrawCommand> Font::generateVertices(const love::font::ColoredCodepoints &codepoints, Range range, const Colorf &constantcolor, std::vector<GlyphVertex> &vertices, float extra_spacing, Vector2 offset, love::font::TextShaper::TextInfo *info, std::vector<ShelfID> *shelves)
 {
 	std::vector<love::font::TextShaper::GlyphPosition> glyphpositions;
 	std::vector<love::font::IndexedColor> colors;
-	shaper->computeGlyphPositions(codepoints, range, offset, extra_spacing, &glyphpositions, &colors, info);
+	shaper->getGlyphPositions(codepoints, range, offset, extra_spacing, &glyphpositions, &colors, info);
+
+	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
+	if (gfx != nullptr)
+		currentFrame = gfx->getFrameNumber();
 
 	size_t vertstartsize = vertices.size();
 	vertices.reserve(vertstartsize + glyphpositions.size() * 4);
 
+	size_t shelfstartsize = shelves != nullptr ? shelves->size() : 0;
+
 	Colorf linearconstantcolor = gammaCorrectColor(constantcolor);
 	Color32 curcolor = toColor32(constantcolor);
 
@@ -400,6 +560,8 @@ std::vector<Font::DrawCommand> Font::generateVertices(const love::font::ColoredC
 			i = -1; // The next iteration will increment this to 0.
 			commands.clear();
 			vertices.resize(vertstartsize);
+			if (shelves != nullptr)
+				shelves->resize(shelfstartsize);
 			curcolori = 0;
 			curcolor = toColor32(constantcolor);
 			continue;
@@ -422,6 +584,13 @@ std::vector<Font::DrawCommand> Font::generateVertices(const love::font::ColoredC
 			curcolori++;
 		}
 
+		if (shelves != nullptr && glyph.page >= 0)
+		{
+			ShelfID id = ((ShelfID) glyph.page << 16) | (ShelfID) glyph.shelf;
+			if (shelves->size() == shelfstartsize || shelves->back() != id)
+				shelves->push_back(id);
+		}
+
 		if (glyph.texture != nullptr)
 		{
 			// Copy the vertices and set their colors and relative positions.
@@ -462,11 +631,12 @@ std::vector<Font::DrawCommand> Font::generateVertices(const love::font::ColoredC
 	return commands;
 }
 
-std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const love::font::ColoredCodepoints &text, const Colorf &constantcolor, float wrap, AlignMode align, std::vector<GlyphVertex> &vertices, love::font::TextShaper::TextInfo *info)
+std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const love::font::ColoredCodepoints &text, const Colorf &constantcolor, float wrap, AlignMode align, std::vector<GlyphVertex> &vertices, love::font::TextShaper::TextInfo *info, std::vector<ShelfID> *shelves)
 {
 	wrap = std::max(wrap, 0.0f);
 
 	uint32 cacheid = textureCacheID;
+	size_t shelfstartsize = shelves != nullptr ? shelves->size() : 0;
 
 	std::vector<DrawCommand> drawcommands;
 	vertices.reserve(text.cps.size() * 4);
@@ -518,7 +688,7 @@ std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const love::font:
 				break;
 		}
 
-		std::vector<DrawCommand> newcommands = generateVertices(text, range, constantcolor, vertices, extraspacing, offset);
+		std::vector<DrawCommand> newcommands = generateVertices(text, range, constantcolor, vertices, extraspacing, offset, nullptr, shelves);
 
 		if (!newcommands.empty())
 		{
@@ -553,7 +723,9 @@ std::vector<Font::DrawCommand> Font::generateVerticesFormatted(const love::font:
 	if (cacheid != textureCacheID)
 	{
 		vertices.clear();
-		drawcommands = generateVerticesFormatted(text, constantcolor, wrap, align, vertices);
+		if (shelves != nullptr)
+			shelves->resize(shelfstartsize);
+		drawcommands = generateVerticesFormatted(text, constantcolor, wrap, align, vertices, nullptr, shelves);
 	}
 
 	return drawcommands;
@@ -573,12 +745,13 @@ void Font::printv(graphics::Graphics *gfx, const Matrix4 &t, const std::vector<D
 		streamcmd.indexMode = TRIANGLEINDEX_QUADS;
 		streamcmd.vertexCount = cmd.vertexcount;
 		streamcmd.texture = cmd.texture;
+		streamcmd.standardShaderType = getStandardShaderType();
 
 		Graphics::BatchedVertexData data = gfx->requestBatchedDraw(streamcmd);
 		GlyphVertex *vertexdata = (GlyphVertex *) data.stream[0];
 
 		memcpy(vertexdata, &vertices[cmd.startvertex], sizeof(GlyphVertex) * cmd.vertexcount);
-		m.transformXY(vertexdata, &vertices[cmd.startvertex], cmd.vertexcount);
+		m.transformXYStrided(vertexdata, sizeof(GlyphVertex), &vertices[cmd.startvertex], sizeof(GlyphVertex), cmd.vertexcount);
 	}
 }
 
@@ -640,8 +813,8 @@ void Font::setSamplerState(const SamplerState &s)
 	samplerState.magFilter = s.magFilter;
 	samplerState.maxAnisotropy = s.maxAnisotropy;
 
-	for (const auto &texture : textures)
-		texture->setSamplerState(samplerState);
+	for (const auto &page : pages)
+		page.texture->setSamplerState(samplerState);
 }
 
 const SamplerState &Font::getSamplerState() const
@@ -678,17 +851,26 @@ void Font::setFallbacks(const std::vector<Font *> &fallbacks)
 {
 	std::vector<love::font::Rasterizer*> rasterizerfallbacks;
 	for (const Font* f : fallbacks)
+	{
+		// Every glyph in a Font is drawn with the same shader.
+		if (f->isSDF() != isSDF())
+			throw love::Exception("Fallback Fonts must use signed distance fields if the main Font does, and vice versa.");
 		rasterizerfallbacks.push_back(f->shaper->getRasterizers()[0]);
+	}
 
 	shaper->setFallbacks(rasterizerfallbacks);
 
 	// Invalidate existing textures.
 	textureCacheID++;
 	glyphs.clear();
-	while (textures.size() > 1)
-		textures.pop_back();
+	while (pages.size() > 1)
+		pages.pop_back();
 
-	rowHeight = textureX = textureY = TEXTURE_PADDING;
+	if (!pages.empty())
+	{
+		pages[0].shelves.clear();
+		pages[0].nextShelfY = TEXTURE_PADDING;
+	}
 }
 
 float Font::getDPIScale() const
@@ -696,11 +878,34 @@ float Font::getDPIScale() const
 	return dpiScale;
 }
 
+Shader::StandardShader Font::getStandardShaderType() const
+{
+	return sdf ? Shader::STANDARD_SDF_TEXT : Shader::STANDARD_DEFAULT;
+}
+
 uint32 Font::getTextureCacheID() const
 {
 	return textureCacheID;
 }
 
+Font::AtlasStats Font::getAtlasStats() const
+{
+	AtlasStats stats = {};
+
+	stats.textures = (int) pages.size();
+	stats.glyphs = (int) glyphs.size();
+	stats.totalArea = (int64) textureWidth * textureHeight * pages.size();
+	stats.evictions = atlasEvictions;
+
+	for (const AtlasPage &page : pages)
+	{
+		for (const Shelf &shelf : page.shelves)
+			stats.usedArea += shelf.usedArea;
+	}
+
+	return stats;
+}
+
 bool Font::getConstant(const char *in, AlignMode &out)
 {
 	return alignModes.find(in, out);
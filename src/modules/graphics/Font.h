@@ -35,6 +35,7 @@
 #include "font/Rasterizer.h"
 #include "font/TextShaper.h"
 #include "Texture.h"
+#include "Shader.h"
 #include "vertex.h"
 #include "Volatile.h"
 
@@ -73,15 +74,40 @@ class Font : public Object, public Volatile
 		int vertexcount;
 	};
 
+	struct AtlasStats
+	{
+		int textures;
+		int glyphs;
+		int64 usedArea; // In pixels, including padding.
+		int64 totalArea;
+		int64 evictions; // Number of glyphs evicted so far.
+	};
+
 	Font(love::font::Rasterizer *r, const SamplerState &samplerState);
 
 	virtual ~Font();
 
+	// Identifies a shelf in the glyph atlas: the texture page in the upper 16
+	// bits and the shelf index in the lower 16 bits.
+	typedef uint32 ShelfID;
+
+	/**
+	 * Generates vertices for the given text. If shelves is non-null, the IDs
+	 * of the atlas shelves holding the text's glyphs are appended to it (not
+	 * necessarily sorted or unique), for use with touchShelves.
+	 **/
 	std::vector<DrawCommand> generateVertices(const love::font::ColoredCodepoints &codepoints, Range range, const Colorf &constantColor, std::vector<GlyphVertex> &vertices,
-	                                          float extra_spacing = 0.0f, Vector2 offset = {}, love::font::TextShaper::TextInfo *info = nullptr);
+	                                          float extra_spacing = 0.0f, Vector2 offset = {}, love::font::TextShaper::TextInfo *info = nullptr, std::vector<ShelfID> *shelves = nullptr);
 
 	std::vector<DrawCommand> generateVerticesFormatted(const love::font::ColoredCodepoints &text, const Colorf &constantColor, float wrap, AlignMode align,
-	                                                   std::vector<GlyphVertex> &vertices, love::font::TextShaper::TextInfo *info = nullptr);
+	                                                   std::vector<GlyphVertex> &vertices, love::font::TextShaper::TextInfo *info = nullptr, std::vector<ShelfID> *shelves = nullptr);
+
+	/**
+	 * Marks the given atlas shelves as used in the current frame, so their
+	 * glyphs aren't evicted while vertices generated earlier (by a TextBatch
+	 * for example) still reference them.
+	 **/
+	void touchShelves(const std::vector<ShelfID> &shelves);
 
 	/**
 	 * Draws the specified text.
@@ -148,8 +174,17 @@ class Font : public Object, public Volatile
 
 	float getDPIScale() const;
 
+	/**
+	 * Whether the glyphs are signed distance fields, which are drawn with the
+	 * SDF text standard shader so they stay sharp at any scale.
+	 **/
+	bool isSDF() const { return sdf; }
+	Shader::StandardShader getStandardShaderType() const;
+
 	uint32 getTextureCacheID() const;
 
+	AtlasStats getAtlasStats() const;
+
 	VertexAttributesID getVertexAttributesID() const { return vertexAttributesID; }
 
 	// Implements Volatile.
@@ -168,6 +203,27 @@ class Font : public Object, public Volatile
 	{
 		Texture *texture;
 		GlyphVertex vertices[4];
+		int page; // -1 for glyphs which don't take up any space.
+		int shelf;
+	};
+
+	// A row of glyphs in an atlas texture. Glyphs are evicted a whole shelf
+	// at a time, once the atlas can't grow anymore.
+	struct Shelf
+	{
+		int y;
+		int height;
+		int x;
+		int64 usedArea;
+		uint64 lastUsedFrame;
+		std::vector<uint64> glyphs;
+	};
+
+	struct AtlasPage
+	{
+		StrongRef<Texture> texture;
+		std::vector<Shelf> shelves;
+		int nextShelfY;
 	};
 
 	struct TextureSize
@@ -177,6 +233,10 @@ class Font : public Object, public Volatile
 	};
 
 	void createTexture();
+	void clearTextureRegion(Texture *texture, const Rect &rect);
+	bool findGlyphSpace(int w, int h, int &page, int &shelf);
+	bool evictShelf(int h, int &page, int &shelf);
+	void allocateGlyphSpace(int w, int h, int &page, int &shelf);
 
 	TextureSize getNextTextureSize() const;
 	love::font::GlyphData *getRasterizerGlyphData(love::font::TextShaper::GlyphIndex glyphindex, float &dpiscale);
@@ -189,7 +249,7 @@ class Font : public Object, public Volatile
 	int textureWidth;
 	int textureHeight;
 
-	std::vector<StrongRef<Texture>> textures;
+	std::vector<AtlasPage> pages;
 
 	// maps packed glyph index values to glyph texture information
 	std::unordered_map<uint64, Glyph> glyphs;
@@ -200,12 +260,16 @@ class Font : public Object, public Volatile
 
 	float dpiScale;
 
-	int textureX, textureY;
-	int rowHeight;
+	bool sdf;
 
 	// ID which is incremented when the texture cache is invalidated.
 	uint32 textureCacheID;
 
+	// Graphics frame number of the generateVertices call in progress.
+	uint64 currentFrame;
+
+	int64 atlasEvictions;
+
 	VertexAttributesID vertexAttributesID;
 
 	// 1 pixel of transparent padding between glyphs (so quads won't pick up
@@ -31,8 +31,10 @@
 #include "Font.h"
 #include "Video.h"
 #include "TextBatch.h"
+#include "timer/Timer.h"
 #include "common/deprecation.h"
 #include "common/config.h"
+#include "common/memory.h"
 
 // C++
 #include <algorithm>
@@ -195,6 +197,7 @@ Graphics::Graphics(const char *name)
 	, renderTargetSwitchCount(0)
 	, drawCalls(0)
 	, drawCallsBatched(0)
+	, drawCallsBatchedUint32(0)
 	, quadIndexBuffer(nullptr)
 	, fanIndexBuffer(nullptr)
 	, capabilities()
@@ -202,6 +205,11 @@ Graphics::Graphics(const char *name)
 	, defaultTexelBuffers()
 	, defaultStorageBuffer(nullptr)
 	, cachedShaderStages()
+	, prevalidatedShaderStages(nullptr)
+	, frameNumber(0)
+	, frameTimingEnabled(false)
+	, frameTimingActive(false)
+	, hasFrameTimings(false)
 {
 	transformStack.reserve(16);
 	transformStack.push_back(Matrix4());
@@ -240,6 +248,15 @@ Graphics::~Graphics()
 		}
 	}
 
+	for (int i = 0; i < ParticleSystem::SIMULATION_PASS_MAX_ENUM; i++)
+	{
+		if (ParticleSystem::simulationShaders[i])
+		{
+			ParticleSystem::simulationShaders[i]->release();
+			ParticleSystem::simulationShaders[i] = nullptr;
+		}
+	}
+
 	states.clear();
 
 	defaultFont.set(nullptr);
@@ -250,11 +267,14 @@ Graphics::~Graphics()
 		batchedDrawState.vb[1]->release();
 	if (batchedDrawState.indexBuffer)
 		batchedDrawState.indexBuffer->release();
+	if (batchedDrawState.textureIndexBuffer)
+		batchedDrawState.textureIndexBuffer->release();
 
 	for (int i = 0; i < (int) SHADERSTAGE_MAX_ENUM; i++)
 		cachedShaderStages[i].clear();
 
 	pendingReadbacks.clear();
+	pendingTextureUploads.clear();
 	clearTemporaryResources();
 
 	Shader::deinitialize();
@@ -319,9 +339,9 @@ Video *Graphics::newVideo(love::video::VideoStream *stream, float dpiscale)
 	return new Video(this, stream, dpiscale);
 }
 
-love::graphics::SpriteBatch *Graphics::newSpriteBatch(Texture *texture, int size, BufferDataUsage usage)
+love::graphics::SpriteBatch *Graphics::newSpriteBatch(Texture *texture, int size, BufferDataUsage usage, bool instanced)
 {
-	return new SpriteBatch(this, texture, size, usage);
+	return new SpriteBatch(this, texture, size, usage, instanced);
 }
 
 love::graphics::ParticleSystem *Graphics::newParticleSystem(Texture *texture, int size)
@@ -329,6 +349,42 @@ love::graphics::ParticleSystem *Graphics::newParticleSystem(Texture *texture, in
 	return new ParticleSystem(texture, size);
 }
 
+void Graphics::updateParticleSystems(const std::vector<ParticleSystem *> &systems, float dt)
+{
+	std::vector<ParticleSystem *> sorted = systems;
+	std::sort(sorted.begin(), sorted.end());
+	if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+		throw love::Exception("A ParticleSystem can only be updated once per call.");
+
+	// GPU-simulated systems dispatch compute shaders, which can only be done
+	// from this thread.
+	std::vector<ParticleSystem *> cpusystems;
+	cpusystems.reserve(systems.size());
+
+	for (ParticleSystem *ps : systems)
+	{
+		if (ps->getSimulationMode() == ParticleSystem::SIMULATION_GPU)
+			ps->update(dt);
+		else
+			cpusystems.push_back(ps);
+	}
+
+	if (cpusystems.empty())
+		return;
+
+	if (workerPool.get() == nullptr)
+		workerPool.set(thread::WorkerPool::acquireShared(), Acquire::NORETAIN);
+
+	workerPool->parallelFor(cpusystems.size(), 1, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			cpusystems[i]->update(dt);
+			cpusystems[i]->prepareDraw();
+		}
+	});
+}
+
 ShaderStage *Graphics::newShaderStage(ShaderStageType stage, const std::string &source, const Shader::CompileOptions &options, const Shader::SourceInfo &info, bool cache)
 {
 	ShaderStage *s = nullptr;
@@ -367,10 +423,15 @@ ShaderStage *Graphics::newShaderStage(ShaderStageType stage, const std::string &
 	return s;
 }
 
-Shader *Graphics::newShader(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options)
+struct ShaderStageSource
 {
-	StrongRef<ShaderStage> stages[SHADERSTAGE_MAX_ENUM] = {};
+	const std::string *source = nullptr;
+	Shader::SourceInfo info = {};
+	bool isDefault = false;
+};
 
+static void getShaderStageSources(const std::vector<std::string> &stagessource, ShaderStageSource stages[SHADERSTAGE_MAX_ENUM])
+{
 	bool validstages[SHADERSTAGE_MAX_ENUM] = {};
 	validstages[SHADERSTAGE_VERTEX] = true;
 	validstages[SHADERSTAGE_PIXEL] = true;
@@ -388,7 +449,8 @@ Shader *Graphics::newShader(const std::vector<std::string> &stagessource, const
 			if (info.stages[i] != Shader::ENTRYPOINT_NONE)
 			{
 				isanystage = true;
-				stages[i].set(newShaderStage((ShaderStageType) i, source, options, info, true), Acquire::NORETAIN);
+				stages[i].source = &source;
+				stages[i].info = info;
 			}
 		}
 
@@ -398,22 +460,98 @@ Shader *Graphics::newShader(const std::vector<std::string> &stagessource, const
 
 	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
 	{
-		auto stype = (ShaderStageType) i;
-		if (validstages[i] && stages[i].get() == nullptr)
+		if (validstages[i] && stages[i].source == nullptr)
 		{
-			const std::string &source = Shader::getDefaultCode(Shader::STANDARD_DEFAULT, stype);
-			Shader::SourceInfo info = Shader::getSourceInfo(source);
-			Shader::CompileOptions opts;
-			stages[i].set(newShaderStage(stype, source, opts, info, true), Acquire::NORETAIN);
+			stages[i].source = &Shader::getDefaultCode(Shader::STANDARD_DEFAULT, (ShaderStageType) i);
+			stages[i].info = Shader::getSourceInfo(*stages[i].source);
+			stages[i].isDefault = true;
 		}
+	}
+}
+
+Shader *Graphics::newShader(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options)
+{
+	ScopedTiming timing(this, "compileShader");
+
+	ShaderStageSource sources[SHADERSTAGE_MAX_ENUM];
+	getShaderStageSources(stagessource, sources);
+
+	StrongRef<ShaderStage> stages[SHADERSTAGE_MAX_ENUM] = {};
+	Shader::CompileOptions defaultoptions;
 
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		const ShaderStageSource &s = sources[i];
+		if (s.source == nullptr)
+			continue;
+
+		const auto &opts = s.isDefault ? defaultoptions : options;
+		stages[i].set(newShaderStage((ShaderStageType) i, *s.source, opts, s.info, true), Acquire::NORETAIN);
 	}
 
 	return newShaderInternal(stages, options);
 }
 
+Shader *Graphics::newShader(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options, StrongRef<ShaderStage> prevalidated[SHADERSTAGE_MAX_ENUM])
+{
+	prevalidatedShaderStages = prevalidated;
+
+	try
+	{
+		Shader *shader = newShader(stagessource, options);
+		prevalidatedShaderStages = nullptr;
+		return shader;
+	}
+	catch (love::Exception &)
+	{
+		prevalidatedShaderStages = nullptr;
+		throw;
+	}
+}
+
+AsyncShader *Graphics::newShaderAsync(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options, Shader *fallback)
+{
+	ShaderStageSource sources[SHADERSTAGE_MAX_ENUM];
+	getShaderStageSources(stagessource, sources);
+
+	// Generating the final code is cheap compared to parsing it, and needs
+	// access to the system's capabilities, so it's done here.
+	bool glsles = usesGLSLES();
+	Shader::CompileOptions defaultoptions;
+	std::string glsl[SHADERSTAGE_MAX_ENUM];
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		const ShaderStageSource &s = sources[i];
+		if (s.source == nullptr)
+			continue;
+
+		const auto &opts = s.isDefault ? defaultoptions : options;
+		glsl[i] = Shader::createShaderStageCode(this, (ShaderStageType) i, *s.source, opts, s.info, glsles, true);
+	}
+
+	if (workerPool.get() == nullptr)
+		workerPool.set(thread::WorkerPool::acquireShared(), Acquire::NORETAIN);
+
+	return new AsyncShader(workerPool, stagessource, options, glsl, glsles, getShaderPrecompiler(glsl), fallback);
+}
+
+glslang::TShader *Graphics::takePrevalidatedShaderStage(ShaderStageType stage, const std::string &glsl)
+{
+	if (prevalidatedShaderStages == nullptr)
+		return nullptr;
+
+	ShaderStage *s = prevalidatedShaderStages[stage].get();
+	if (s == nullptr || s->getSource() != glsl)
+		return nullptr;
+
+	return s->releaseGLSLangValidationShader();
+}
+
 Shader *Graphics::newComputeShader(const std::string &source, const Shader::CompileOptions &options)
 {
+	ScopedTiming timing(this, "compileShader");
+
 	Shader::SourceInfo info = Shader::getSourceInfo(source);
 
 	if (info.stages[SHADERSTAGE_COMPUTE] == Shader::ENTRYPOINT_NONE)
@@ -494,6 +632,23 @@ GraphicsReadback *Graphics::readbackTextureAsync(Texture *texture, int slice, in
 	return readback;
 }
 
+ReadbackRing *Graphics::newReadbackRing(int size)
+{
+	return new ReadbackRing(this, size);
+}
+
+void Graphics::registerReadbackRing(ReadbackRing *ring)
+{
+	readbackRings.push_back(ring);
+}
+
+void Graphics::unregisterReadbackRing(ReadbackRing *ring)
+{
+	auto it = std::find(readbackRings.begin(), readbackRings.end(), ring);
+	if (it != readbackRings.end())
+		readbackRings.erase(it);
+}
+
 void Graphics::cleanupCachedShaderStage(ShaderStageType type, const std::string &hashkey)
 {
 	cachedShaderStages[type].erase(hashkey);
@@ -971,13 +1126,20 @@ void Graphics::setShader(love::graphics::Shader *shader)
 	if (shader == nullptr)
 		return setShader();
 
+	// The active shader is captured by draws recorded in a batch scope.
+	batchScope.replaySuspended++;
 	shader->attach();
+	batchScope.replaySuspended--;
+
 	states.back().shader.set(shader);
 }
 
 void Graphics::setShader()
 {
+	batchScope.replaySuspended++;
 	Shader::attachDefault(Shader::STANDARD_DEFAULT);
+	batchScope.replaySuspended--;
+
 	states.back().shader.set(nullptr);
 }
 
@@ -1363,6 +1525,9 @@ void Graphics::releaseTemporaryBuffer(Buffer *buffer)
 
 void Graphics::updateTemporaryResources()
 {
+	// This is called once per present.
+	frameNumber++;
+
 	for (int i = (int) temporaryTextures.size() - 1; i >= 0; i--)
 	{
 		auto &t = temporaryTextures[i];
@@ -1413,6 +1578,58 @@ void Graphics::updatePendingReadbacks()
 			pendingReadbacks.pop_back();
 		}
 	}
+
+	for (ReadbackRing *ring : readbackRings)
+		ring->update();
+}
+
+void Graphics::queueTextureUpload(Texture *texture, love::image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+{
+	PendingTextureUpload upload;
+	upload.texture.set(texture);
+	upload.data.set(data);
+	upload.slice = slice;
+	upload.mipmap = mipmap;
+	upload.x = x;
+	upload.y = y;
+	upload.reloadMipmaps = reloadmipmaps;
+
+	pendingTextureUploads.push_back(upload);
+}
+
+int Graphics::getPendingTextureUploadCount(const Texture *texture) const
+{
+	if (texture == nullptr)
+		return (int) pendingTextureUploads.size();
+
+	int count = 0;
+	for (const PendingTextureUpload &upload : pendingTextureUploads)
+	{
+		if (upload.texture.get() == texture)
+			count++;
+	}
+
+	return count;
+}
+
+void Graphics::processPendingTextureUploads()
+{
+	if (pendingTextureUploads.empty())
+		return;
+
+	ScopedTiming timing(this, "textureUploads");
+
+	size_t uploadedsize = 0;
+
+	while (!pendingTextureUploads.empty() && uploadedsize < MAX_TEXTURE_UPLOAD_BYTES_PER_FRAME)
+	{
+		PendingTextureUpload upload = pendingTextureUploads.front();
+		pendingTextureUploads.pop_front();
+
+		uploadedsize += upload.data->getSize();
+
+		upload.texture->replacePixels(upload.data, upload.slice, upload.mipmap, upload.x, upload.y, upload.reloadMipmaps);
+	}
 }
 
 VertexAttributesID Graphics::registerVertexAttributes(const VertexAttributes &attributes)
@@ -1607,6 +1824,59 @@ bool Graphics::isWireframe() const
 	return states.back().wireframe;
 }
 
+void Graphics::setMultiTextureBatching(bool enable)
+{
+	if (enable != multiTextureBatching)
+		flushBatchedDraws();
+
+	multiTextureBatching = enable;
+}
+
+bool Graphics::isMultiTextureBatching() const
+{
+	return multiTextureBatching;
+}
+
+void Graphics::beginBatchScope(BatchScopeMode /*mode*/)
+{
+	if (batchScope.active)
+		throw love::Exception("Batch scopes cannot be nested.");
+
+	flushBatchedDraws();
+
+	batchScope.active = true;
+	batchScope.layer = 0;
+}
+
+void Graphics::endBatchScope()
+{
+	if (!batchScope.active)
+		throw love::Exception("endBatchScope must be called after beginBatchScope.");
+
+	replayBatchScope();
+
+	batchScope.active = false;
+	batchScope.layer = 0;
+}
+
+bool Graphics::isBatchScopeActive() const
+{
+	return batchScope.active;
+}
+
+void Graphics::setBatchLayer(int layer)
+{
+	if (layer < INT16_MIN || layer > INT16_MAX)
+		throw love::Exception("Batch layer must be between %d and %d.", INT16_MIN, INT16_MAX);
+
+	batchScope.layer = layer;
+}
+
+int Graphics::getBatchLayer() const
+{
+	return batchScope.layer;
+}
+
 void Graphics::captureScreenshot(const ScreenshotInfo &info)
 {
 	pendingScreenshotCallbacks.push_back(info);
@@ -1902,33 +2172,272 @@ void Graphics::dispatchIndirect(Shader *shader, Buffer *indirectargs, int argsin
 		throw love::Exception("Compute shader must have resources bound to all writable texture and buffer variables.");
 }
 
+static bool isMultiTextureCompatible(const Texture *texture)
+{
+	// The multi-texture shader only has regular 2D float samplers.
+	return texture != nullptr
+		&& texture->getTextureType() == TEXTURE_2D
+		&& !texture->getSamplerState().depthSampleMode.hasValue
+		&& !isPixelFormatInteger(texture->getPixelFormat());
+}
+
+Graphics::BatchedVertexData Graphics::recordBatchedDraw(const BatchedDrawCommand &cmd)
+{
+	BatchScopeState &scope = batchScope;
+
+	// Start a new recording if any of the sort key fields would overflow.
+	if (scope.textures.size() >= 0xFFFF || scope.shaders.size() >= 0xFFF
+		|| scope.blendStates.size() >= 0xFF || scope.formatIDs.size() >= 0xFFF)
+	{
+		replayBatchScope();
+	}
+
+	uint64 textureid = 0;
+	if (cmd.texture != nullptr)
+	{
+		auto it = scope.textureIDs.find(cmd.texture);
+		if (it != scope.textureIDs.end())
+			textureid = it->second;
+		else
+		{
+			scope.textures.emplace_back(cmd.texture);
+			textureid = (uint16) scope.textures.size();
+			scope.textureIDs[cmd.texture] = (uint16) textureid;
+		}
+	}
+
+	// Shader ID 0 is the default shader.
+	Shader *shader = states.back().shader.get();
+	uint64 shaderid = 0;
+	if (shader != nullptr)
+	{
+		for (; shaderid < scope.shaders.size(); shaderid++)
+		{
+			if (scope.shaders[shaderid].get() == shader)
+				break;
+		}
+
+		if (shaderid == scope.shaders.size())
+			scope.shaders.emplace_back(shader);
+
+		shaderid++;
+	}
+
+	const BlendState &blend = states.back().blend;
+	uint64 blendid = 0;
+	for (; blendid < scope.blendStates.size(); blendid++)
+	{
+		if (scope.blendStates[blendid] == blend)
+			break;
+	}
+
+	if (blendid == scope.blendStates.size())
+		scope.blendStates.push_back(blend);
+
+	uint32 format = ((uint32) cmd.primitiveMode << 28) | ((uint32) cmd.indexMode << 24)
+		| ((uint32) cmd.standardShaderType << 16) | ((uint32) cmd.formats[0] << 8)
+		| (uint32) cmd.formats[1];
+
+	uint64 formatid = 0;
+	for (; formatid < scope.formatIDs.size(); formatid++)
+	{
+		if (scope.formatIDs[formatid] == format)
+			break;
+	}
+
+	if (formatid == scope.formatIDs.size())
+		scope.formatIDs.push_back(format);
+
+	uint64 layer = (uint64) (scope.layer - INT16_MIN);
+
+	uint64 key = (layer << 48) | (shaderid << 36) | (blendid << 28) | (formatid << 16) | textureid;
+
+	RecordedBatchedDraw draw;
+	draw.command = cmd;
+	draw.shaderID = (uint16) shaderid;
+	draw.blendID = (uint8) blendid;
+
+	size_t offset = scope.vertexData.size();
+	for (int i = 0; i < 2; i++)
+	{
+		draw.dataOffsets[i] = offset;
+		if (cmd.formats[i] != CommonFormat::NONE)
+			offset += alignUp(getFormatStride(cmd.formats[i]) * cmd.vertexCount, sizeof(float));
+	}
+
+	scope.vertexData.resize(offset);
+	scope.draws.push_back(draw);
+	scope.sortKeys.push_back(key);
+
+	BatchedVertexData d;
+	for (int i = 0; i < 2; i++)
+		d.stream[i] = scope.vertexData.data() + draw.dataOffsets[i];
+
+	return d;
+}
+
+// Stable LSD radix sort of indices by 64 bit key, 8 bits per pass. Passes
+// where every key has the same digit are skipped.
+static void radixSortKeys(const std::vector<uint64> &keys, std::vector<uint32> &order, std::vector<uint32> &scratch)
+{
+	size_t count = keys.size();
+
+	order.resize(count);
+	scratch.resize(count);
+
+	for (size_t i = 0; i < count; i++)
+		order[i] = (uint32) i;
+
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		size_t counts[257] = {};
+
+		for (size_t i = 0; i < count; i++)
+			counts[((keys[i] >> shift) & 0xFF) + 1]++;
+
+		if (counts[((keys[0] >> shift) & 0xFF) + 1] == count)
+			continue;
+
+		for (int i = 0; i < 256; i++)
+			counts[i + 1] += counts[i];
+
+		for (size_t i = 0; i < count; i++)
+		{
+			uint32 index = order[i];
+			scratch[counts[(keys[index] >> shift) & 0xFF]++] = index;
+		}
+
+		std::swap(order, scratch);
+	}
+}
+
+void Graphics::replayBatchScope()
+{
+	BatchScopeState &scope = batchScope;
+
+	if (scope.draws.empty() || scope.replaying)
+		return;
+
+	scope.replaying = true;
+
+	auto reset = [&]()
+	{
+		scope.draws.clear();
+		scope.sortKeys.clear();
+		scope.vertexData.clear();
+		scope.textureIDs.clear();
+		scope.textures.clear();
+		scope.shaders.clear();
+		scope.blendStates.clear();
+		scope.formatIDs.clear();
+		scope.replaying = false;
+	};
+
+	Shader *prevshader = states.back().shader.get();
+	BlendState prevblend = states.back().blend;
+
+	try
+	{
+		radixSortKeys(scope.sortKeys, scope.order, scope.orderScratch);
+
+		for (uint32 index : scope.order)
+		{
+			const RecordedBatchedDraw &draw = scope.draws[index];
+			const BatchedDrawCommand &cmd = draw.command;
+
+			if (draw.shaderID > 0)
+				scope.shaders[draw.shaderID - 1]->attach();
+			else if (!Shader::isDefaultActive())
+				Shader::attachDefault(Shader::STANDARD_DEFAULT);
+
+			const BlendState &blend = scope.blendStates[draw.blendID];
+			if (!(states.back().blend == blend))
+				setBlendState(blend);
+
+			BatchedVertexData data = requestBatchedDraw(cmd);
+
+			for (int i = 0; i < 2; i++)
+			{
+				if (cmd.formats[i] != CommonFormat::NONE)
+				{
+					size_t size = getFormatStride(cmd.formats[i]) * cmd.vertexCount;
+					memcpy(data.stream[i], scope.vertexData.data() + draw.dataOffsets[i], size);
+				}
+			}
+		}
+
+		flushBatchedDraws();
+	}
+	catch (love::Exception &)
+	{
+		reset();
+		throw;
+	}
+
+	if (prevshader != nullptr)
+		prevshader->attach();
+	else
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+
+	if (!(states.back().blend == prevblend))
+		setBlendState(prevblend);
+
+	reset();
+}
+
 Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawCommand &cmd)
 {
+	if (batchScope.active && !batchScope.replaying)
+		return recordBatchedDraw(cmd);
+
 	BatchedDrawState &state = batchedDrawState;
 
 	bool shouldflush = false;
 	bool shouldresize = false;
 
+	// Draws that would use the default standard shader can share a batch across
+	// different textures until the multi-texture shader runs out of slots.
+	Shader::StandardShader shadertype = cmd.standardShaderType;
+	if (multiTextureBatching && shadertype == Shader::STANDARD_DEFAULT
+		&& Shader::isDefaultActive() && isMultiTextureCompatible(cmd.texture))
+	{
+		shadertype = Shader::STANDARD_MULTITEXTURE;
+	}
+
+	bool multitexture = shadertype == Shader::STANDARD_MULTITEXTURE;
+
 	if (cmd.primitiveMode != state.primitiveMode
 		|| cmd.formats[0] != state.formats[0] || cmd.formats[1] != state.formats[1]
 		|| ((cmd.indexMode != TRIANGLEINDEX_NONE) != (state.indexCount > 0))
-		|| cmd.texture != state.texture
-		|| cmd.standardShaderType != state.standardShaderType)
+		|| (!multitexture && cmd.texture != state.texture)
+		|| shadertype != state.standardShaderType)
 	{
 		shouldflush = true;
 	}
 
-	int totalvertices = state.vertexCount + cmd.vertexCount;
+	int textureslot = -1;
 
-	// We only support uint16 index buffers for now.
-	if (totalvertices > LOVE_UINT16_MAX && cmd.indexMode != TRIANGLEINDEX_NONE)
-		shouldflush = true;
+	if (multitexture && !shouldflush)
+	{
+		for (int i = 0; i < state.textureCount; i++)
+		{
+			if (state.textures[i].get() == cmd.texture)
+			{
+				textureslot = i;
+				break;
+			}
+		}
+
+		if (textureslot < 0 && state.textureCount >= MAX_BATCH_TEXTURES)
+			shouldflush = true;
+	}
+
+	int totalvertices = state.vertexCount + cmd.vertexCount;
 
 	int reqIndexCount = getIndexCount(cmd.indexMode, cmd.vertexCount);
-	size_t reqIndexSize = reqIndexCount * sizeof(uint16);
 
 	size_t newdatasizes[2] = {0, 0};
-	size_t buffersizes[3] = {0, 0, 0};
+	size_t buffersizes[4] = {0, 0, 0, 0};
 
 	for (int i = 0; i < 2; i++)
 	{
@@ -1950,12 +2459,53 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 		newdatasizes[i] = stride * cmd.vertexCount;
 	}
 
+	size_t textureindexsize = 0;
+
+	if (multitexture)
+	{
+		size_t datasize = sizeof(float) * totalvertices;
+
+		if (state.textureIndexMap.data != nullptr && datasize > state.textureIndexMap.size)
+			shouldflush = true;
+
+		if (datasize > state.textureIndexBuffer->getUsableSize())
+		{
+			buffersizes[3] = std::max(datasize, state.textureIndexBuffer->getSize() * 2);
+			shouldresize = true;
+		}
+
+		textureindexsize = sizeof(float) * cmd.vertexCount;
+	}
+
+	// Indexed batches start out with uint16 indices, and are widened to uint32
+	// indices once they reference more vertices than uint16 can address.
+	IndexDataType indextype = INDEX_UINT16;
+	bool widenindices = false;
+
 	if (cmd.indexMode != TRIANGLEINDEX_NONE)
 	{
-		size_t datasize = (state.indexCount + reqIndexCount) * sizeof(uint16);
+		int batchindexcount = state.indexCount + reqIndexCount;
+
+		if (shouldflush)
+			indextype = getIndexDataTypeFromMax(cmd.vertexCount);
+		else if (state.indexCount > 0 && state.indexType == INDEX_UINT32)
+			indextype = INDEX_UINT32;
+		else
+			indextype = getIndexDataTypeFromMax(totalvertices);
+
+		// Index data is padded so every batch starts at a uint32-aligned offset.
+		size_t datasize = alignUp(batchindexcount * getIndexDataSize(indextype), sizeof(uint32));
 
 		if (state.indexBufferMap.data != nullptr && datasize > state.indexBufferMap.size)
+		{
 			shouldflush = true;
+			indextype = getIndexDataTypeFromMax(cmd.vertexCount);
+		}
+
+		if (shouldflush)
+			datasize = alignUp(reqIndexCount * getIndexDataSize(indextype), sizeof(uint32));
+		else
+			widenindices = state.indexCount > 0 && indextype != state.indexType;
 
 		if (datasize > state.indexBuffer->getUsableSize())
 		{
@@ -1972,7 +2522,9 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 		state.formats[0] = cmd.formats[0];
 		state.formats[1] = cmd.formats[1];
 		state.texture = cmd.texture;
-		state.standardShaderType = cmd.standardShaderType;
+		state.standardShaderType = shadertype;
+		widenindices = false;
+		textureslot = -1;
 	}
 
 	if (state.vertexCount == 0)
@@ -2000,17 +2552,68 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 			state.indexBuffer->release();
 			state.indexBuffer = newStreamBuffer(BUFFERUSAGE_INDEX, buffersizes[2]);
 		}
+
+		if (state.textureIndexBuffer->getSize() < buffersizes[3])
+		{
+			state.textureIndexBuffer->release();
+			state.textureIndexBuffer = newStreamBuffer(BUFFERUSAGE_VERTEX, buffersizes[3]);
+		}
+	}
+
+	if (multitexture)
+	{
+		if (textureslot < 0)
+		{
+			textureslot = state.textureCount++;
+			state.textures[textureslot].set(cmd.texture);
+
+			if (textureslot == 0)
+				state.texture.set(cmd.texture);
+		}
+
+		if (state.textureIndexMap.data == nullptr)
+		{
+			ScopedTiming timing(this, "mapBuffer");
+			state.textureIndexMap = state.textureIndexBuffer->map(textureindexsize);
+		}
+
+		float *textureindices = (float *) state.textureIndexMap.data;
+		for (int i = 0; i < cmd.vertexCount; i++)
+			textureindices[i] = (float) textureslot;
+
+		state.textureIndexMap.data += textureindexsize;
 	}
 
 	if (cmd.indexMode != TRIANGLEINDEX_NONE)
 	{
 		if (state.indexBufferMap.data == nullptr)
-			state.indexBufferMap = state.indexBuffer->map(reqIndexSize);
+		{
+			ScopedTiming timing(this, "mapBuffer");
+			state.indexBufferMap = state.indexBuffer->map(reqIndexCount * getIndexDataSize(indextype));
+			state.indexType = indextype;
+		}
+
+		if (widenindices)
+		{
+			// Convert the indices already in this batch in place. Going back to
+			// front means we never overwrite a uint16 index before reading it.
+			uint8 *start = state.indexBufferMap.data - state.indexCount * sizeof(uint16);
+			const uint16 *src = (const uint16 *) start;
+			uint32 *dst = (uint32 *) start;
+
+			for (int i = state.indexCount - 1; i >= 0; i--)
+				dst[i] = src[i];
 
-		uint16 *indices = (uint16 *) state.indexBufferMap.data;
-		fillIndices(cmd.indexMode, state.vertexCount, cmd.vertexCount, indices);
+			state.indexBufferMap.data = start + state.indexCount * sizeof(uint32);
+			state.indexType = INDEX_UINT32;
+		}
+
+		if (state.indexType == INDEX_UINT32)
+			fillIndices(cmd.indexMode, (uint32) state.vertexCount, (uint32) cmd.vertexCount, (uint32 *) state.indexBufferMap.data);
+		else
+			fillIndices(cmd.indexMode, (uint16) state.vertexCount, (uint16) cmd.vertexCount, (uint16 *) state.indexBufferMap.data);
 
-		state.indexBufferMap.data += reqIndexSize;
+		state.indexBufferMap.data += reqIndexCount * getIndexDataSize(state.indexType);
 	}
 
 	BatchedVertexData d;
@@ -2020,7 +2623,10 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 		if (newdatasizes[i] > 0)
 		{
 			if (state.vbMap[i].data == nullptr)
+			{
+				ScopedTiming timing(this, "mapBuffer");
 				state.vbMap[i] = state.vb[i]->map(newdatasizes[i]);
+			}
 
 			d.stream[i] = state.vbMap[i].data;
 
@@ -2037,28 +2643,51 @@ Graphics::BatchedVertexData Graphics::requestBatchedDraw(const BatchedDrawComman
 	return d;
 }
 
+void Graphics::flushBatchedDrawsForRecordedState()
+{
+	batchScope.replaySuspended++;
+	flushBatchedDraws();
+	batchScope.replaySuspended--;
+}
+
 void Graphics::flushBatchedDraws()
 {
+	// State changes which aren't captured by recorded draws end the current
+	// recording, so everything drawn so far uses the state it was drawn with.
+	if (batchScope.active && !batchScope.replaying && batchScope.replaySuspended == 0)
+		replayBatchScope();
+
 	auto &sbstate = batchedDrawState;
 
 	if ((sbstate.vertexCount == 0 && sbstate.indexCount == 0) || sbstate.flushing)
 		return;
 
+	ScopedTiming timing(this, "flushBatchedDraws");
+
 	VertexAttributes attributes;
 	BufferBindings buffers;
 
-	VertexAttributesID attributesID = sbstate.attributesIDs[(int)sbstate.formats[0]][(int)sbstate.formats[1]];
+	bool multitexture = sbstate.standardShaderType == Shader::STANDARD_MULTITEXTURE;
+	auto &attributesIDs = sbstate.attributesIDs[multitexture ? 1 : 0];
+
+	VertexAttributesID attributesID = attributesIDs[(int)sbstate.formats[0]][(int)sbstate.formats[1]];
 
 	if (!findVertexAttributes(attributesID, attributes))
 	{
 		for (int i = 0; i < 2; i++)
 			attributes.setCommonFormat(sbstate.formats[i], (uint8)i);
+
+		if (multitexture)
+		{
+			attributes.set(BATCH_TEXTURE_INDEX_ATTRIB, DATAFORMAT_FLOAT, 0, 2);
+			attributes.setBufferLayout(2, (uint16) sizeof(float));
+		}
 		
 		attributesID = registerVertexAttributes(attributes);
-		sbstate.attributesIDs[(int)sbstate.formats[0]][(int)sbstate.formats[1]] = attributesID;
+		attributesIDs[(int)sbstate.formats[0]][(int)sbstate.formats[1]] = attributesID;
 	}
 
-	size_t usedsizes[3] = {0, 0, 0};
+	size_t usedsizes[4] = {0, 0, 0, 0};
 
 	for (int i = 0; i < 2; i++)
 	{
@@ -2072,6 +2701,15 @@ void Graphics::flushBatchedDraws()
 		sbstate.vbMap[i] = StreamBuffer::MapInfo();
 	}
 
+	if (multitexture)
+	{
+		usedsizes[3] = sizeof(float) * sbstate.vertexCount;
+
+		size_t offset = sbstate.textureIndexBuffer->unmap(usedsizes[3]);
+		buffers.set(2, sbstate.textureIndexBuffer, offset);
+		sbstate.textureIndexMap = StreamBuffer::MapInfo();
+	}
+
 	if (attributes.enableBits == 0)
 		return;
 
@@ -2083,19 +2721,33 @@ void Graphics::flushBatchedDraws()
 
 	pushIdentityTransform();
 
+	if (multitexture && Shader::current != nullptr)
+	{
+		// Unused slots get the default texture, via nullptr.
+		Texture *textures[MAX_BATCH_TEXTURES - 1] = {};
+		for (int i = 1; i < sbstate.textureCount; i++)
+			textures[i - 1] = sbstate.textures[i];
+
+		Shader::current->setBatchTextures(textures, MAX_BATCH_TEXTURES - 1);
+	}
+
 	if (sbstate.indexCount > 0)
 	{
-		usedsizes[2] = sizeof(uint16) * sbstate.indexCount;
+		usedsizes[2] = getIndexDataSize(sbstate.indexType) * sbstate.indexCount;
 
 		DrawIndexedCommand cmd(attributesID, &buffers, sbstate.indexBuffer);
 		cmd.primitiveType = sbstate.primitiveMode;
 		cmd.indexCount = sbstate.indexCount;
-		cmd.indexType = INDEX_UINT16;
+		cmd.indexType = sbstate.indexType;
 		cmd.indexBufferOffset = sbstate.indexBuffer->unmap(usedsizes[2]);
 		cmd.texture = getTextureOrDefaultForActiveShader(sbstate.texture);
 		draw(cmd);
 
+		if (sbstate.indexType == INDEX_UINT32)
+			drawCallsBatchedUint32++;
+
 		sbstate.indexBufferMap = StreamBuffer::MapInfo();
+		usedsizes[2] = alignUp(usedsizes[2], sizeof(uint32));
 	}
 	else
 	{
@@ -2116,13 +2768,20 @@ void Graphics::flushBatchedDraws()
 	if (usedsizes[2] > 0)
 		sbstate.indexBuffer->markUsed(usedsizes[2]);
 
+	if (usedsizes[3] > 0)
+		sbstate.textureIndexBuffer->markUsed(usedsizes[3]);
+
 	popTransform();
 
 	if (attributes.isEnabled(ATTRIB_COLOR))
 		setColor(nc);
 
+	for (int i = 0; i < sbstate.textureCount; i++)
+		sbstate.textures[i].set(nullptr);
+
 	sbstate.vertexCount = 0;
 	sbstate.indexCount = 0;
+	sbstate.textureCount = 0;
 	sbstate.flushing = false;
 }
 
@@ -2386,19 +3045,19 @@ void Graphics::polyline(const Vector2 *vertices, size_t count)
 
 	if (linejoin == LINE_JOIN_NONE)
 	{
-		NoneJoinPolyline line;
+		NoneJoinPolyline line(polylineScratch);
 		line.render(vertices, count, halfwidth, pixelsize, linestyle == LINE_SMOOTH);
 		line.draw(this);
 	}
 	else if (linejoin == LINE_JOIN_BEVEL)
 	{
-		BevelJoinPolyline line;
+		BevelJoinPolyline line(polylineScratch);
 		line.render(vertices, count, halfwidth, pixelsize, linestyle == LINE_SMOOTH);
 		line.draw(this);
 	}
 	else if (linejoin == LINE_JOIN_MITER)
 	{
-		MiterJoinPolyline line;
+		MiterJoinPolyline line(polylineScratch);
 		line.render(vertices, count, halfwidth, pixelsize, linestyle == LINE_SMOOTH);
 		line.draw(this);
 	}
@@ -2695,6 +3354,7 @@ Graphics::Stats Graphics::getStats() const
 
 	stats.renderTargetSwitches = renderTargetSwitchCount;
 	stats.drawCallsBatched = drawCallsBatched;
+	stats.drawCallsBatchedUint32 = drawCallsBatchedUint32;
 	stats.textures = Texture::textureCount;
 	stats.fonts = Font::fontCount;
 	stats.buffers = Buffer::bufferCount;
@@ -2704,6 +3364,196 @@ Graphics::Stats Graphics::getStats() const
 	return stats;
 }
 
+Graphics::ScopedTiming::ScopedTiming(Graphics *gfx, const char *name)
+	: gfx(gfx != nullptr && gfx->frameTimingEnabled ? gfx : nullptr)
+{
+	if (this->gfx != nullptr)
+		this->gfx->pushTimingScope(name);
+}
+
+Graphics::ScopedTiming::~ScopedTiming()
+{
+	// The scope may have been closed already if the frame ended inside it.
+	if (gfx != nullptr && gfx->timingStack.size() > 1)
+		gfx->popTimingScopeInternal();
+}
+
+void Graphics::setFrameTimingEnabled(bool enable)
+{
+	// A frame which is already being recorded is finished by present, so its
+	// timestamp queries stay in step with the backend's.
+	frameTimingEnabled = enable;
+}
+
+bool Graphics::isFrameTimingEnabled() const
+{
+	return frameTimingEnabled;
+}
+
+void Graphics::pushTimingScope(const char *name)
+{
+	if (!frameTimingEnabled)
+		return;
+
+	if (!frameTimingActive)
+		beginFrameTiming();
+
+	size_t parent = timingStack.back().node;
+	size_t index = timingNodes.size();
+
+	for (size_t child : timingNodes[parent].children)
+	{
+		if (timingNodes[child].name == name)
+		{
+			index = child;
+			break;
+		}
+	}
+
+	if (index == timingNodes.size())
+	{
+		timingNodes.emplace_back();
+		timingNodes.back().name = name;
+		timingNodes[parent].children.push_back(index);
+	}
+
+	timingNodes[index].calls++;
+
+	OpenTimingScope scope;
+	scope.node = index;
+	scope.cpuStart = love::timer::Timer::getTime();
+	scope.gpuQueryStart = writeTimestampQuery();
+
+	timingStack.push_back(scope);
+}
+
+void Graphics::popTimingScope()
+{
+	if (!frameTimingActive)
+		return;
+
+	if (timingStack.size() <= 1)
+		throw love::Exception("popTimingScope must be called after a matching pushTimingScope.");
+
+	popTimingScopeInternal();
+}
+
+void Graphics::popTimingScopeInternal()
+{
+	OpenTimingScope scope = timingStack.back();
+	timingStack.pop_back();
+
+	TimingNode &node = timingNodes[scope.node];
+	node.cpuTime += love::timer::Timer::getTime() - scope.cpuStart;
+
+	if (scope.gpuQueryStart >= 0)
+	{
+		int end = writeTimestampQuery();
+		if (end >= 0)
+			node.gpuQueries.push_back(std::make_pair(scope.gpuQueryStart, end));
+	}
+}
+
+bool Graphics::getFrameTimings(TimingScope &timings) const
+{
+	if (!hasFrameTimings)
+		return false;
+
+	timings = lastFrameTimings;
+	return true;
+}
+
+void Graphics::beginFrameTiming()
+{
+	if (!frameTimingEnabled || frameTimingActive)
+		return;
+
+	timingNodes.clear();
+	timingStack.clear();
+
+	timingNodes.emplace_back();
+	timingNodes[0].name = "frame";
+	timingNodes[0].calls = 1;
+
+	OpenTimingScope scope;
+	scope.node = 0;
+	scope.cpuStart = love::timer::Timer::getTime();
+	scope.gpuQueryStart = writeTimestampQuery();
+
+	timingStack.push_back(scope);
+	frameTimingActive = true;
+}
+
+void Graphics::endFrameTiming()
+{
+	if (!frameTimingActive)
+		return;
+
+	// Scopes left open by the user (or by an error) end with the frame.
+	while (!timingStack.empty())
+		popTimingScopeInternal();
+
+	frameTimingActive = false;
+
+	submitTimestampQueries();
+	pendingTimingFrames.push_back(std::move(timingNodes));
+	timingNodes.clear();
+
+	std::vector<double> timestamps;
+
+	while (!pendingTimingFrames.empty())
+	{
+		TimestampQueryStatus status = getTimestampQueryResults(timestamps);
+		if (status == TIMESTAMP_QUERIES_PENDING)
+			break;
+
+		const auto *results = status == TIMESTAMP_QUERIES_READY ? &timestamps : nullptr;
+		lastFrameTimings = buildTimingScope(pendingTimingFrames.front(), 0, results);
+		hasFrameTimings = true;
+
+		pendingTimingFrames.pop_front();
+	}
+}
+
+void Graphics::resetFrameTimings()
+{
+	frameTimingActive = false;
+	timingNodes.clear();
+	timingStack.clear();
+	pendingTimingFrames.clear();
+}
+
+Graphics::TimingScope Graphics::buildTimingScope(const std::vector<TimingNode> &nodes, size_t index, const std::vector<double> *timestamps) const
+{
+	const TimingNode &node = nodes[index];
+
+	TimingScope scope;
+	scope.name = node.name;
+	scope.cpuTime = node.cpuTime;
+	scope.calls = node.calls;
+
+	if (timestamps != nullptr)
+	{
+		for (const auto &queries : node.gpuQueries)
+		{
+			if ((size_t) queries.second >= timestamps->size())
+				continue;
+
+			double start = (*timestamps)[queries.first];
+			double end = (*timestamps)[queries.second];
+
+			if (end >= start)
+				scope.gpuTime = std::max(scope.gpuTime, 0.0) + (end - start);
+		}
+	}
+
+	scope.children.reserve(node.children.size());
+	for (size_t child : node.children)
+		scope.children.push_back(buildTimingScope(nodes, child, timestamps));
+
+	return scope;
+}
+
 size_t Graphics::getStackDepth() const
 {
 	return stackTypeStack.size();
@@ -2948,6 +3798,12 @@ STRINGMAP_CLASS_BEGIN(Graphics, Graphics::StackType, Graphics::STACK_MAX_ENUM, s
 }
 STRINGMAP_CLASS_END(Graphics, Graphics::StackType, Graphics::STACK_MAX_ENUM, stackType)
 
+STRINGMAP_CLASS_BEGIN(Graphics, Graphics::BatchScopeMode, Graphics::BATCHSCOPE_MAX_ENUM, batchScopeMode)
+{
+	{ "sorted", Graphics::BATCHSCOPE_SORTED },
+}
+STRINGMAP_CLASS_END(Graphics, Graphics::BatchScopeMode, Graphics::BATCHSCOPE_MAX_ENUM, batchScopeMode)
+
 STRINGMAP_BEGIN(Renderer, RENDERER_MAX_ENUM, renderer)
 {
 	{ "opengl", RENDERER_OPENGL },
@@ -35,9 +35,12 @@
 #include "Font.h"
 #include "ShaderStage.h"
 #include "Shader.h"
+#include "AsyncShader.h"
 #include "Quad.h"
 #include "Mesh.h"
+#include "Polyline.h"
 #include "GraphicsReadback.h"
+#include "ReadbackRing.h"
 #include "Deprecations.h"
 #include "renderstate.h"
 #include "math/Transform.h"
@@ -45,10 +48,13 @@
 #include "font/Font.h"
 #include "video/VideoStream.h"
 #include "data/HashFunction.h"
+#include "thread/WorkerPool.h"
 
 // C++
 #include <string>
 #include <vector>
+#include <deque>
+#include <utility>
 
 namespace love
 {
@@ -188,6 +194,12 @@ class Graphics : public Module
 		STACK_MAX_ENUM
 	};
 
+	enum BatchScopeMode
+	{
+		BATCHSCOPE_SORTED,
+		BATCHSCOPE_MAX_ENUM
+	};
+
 	enum TemporaryRenderTargetFlags
 	{
 		TEMPORARY_RT_DEPTH   = (1 << 0),
@@ -220,6 +232,7 @@ class Graphics : public Module
 	{
 		int drawCalls;
 		int drawCallsBatched;
+		int drawCallsBatchedUint32;
 		int renderTargetSwitches;
 		int shaderSwitches;
 		int textures;
@@ -229,6 +242,38 @@ class Graphics : public Module
 		int64 bufferMemory;
 	};
 
+	struct TimingScope
+	{
+		std::string name;
+		double cpuTime = 0.0; // In seconds.
+		double gpuTime = -1.0; // In seconds, or negative if unavailable.
+		int calls = 0;
+		std::vector<TimingScope> children;
+	};
+
+	enum TimestampQueryStatus
+	{
+		TIMESTAMP_QUERIES_PENDING,
+		TIMESTAMP_QUERIES_READY,
+		TIMESTAMP_QUERIES_UNAVAILABLE,
+	};
+
+	/**
+	 * Records a timing scope for the lifetime of the object, when frame timing
+	 * is enabled.
+	 **/
+	class ScopedTiming
+	{
+	public:
+
+		ScopedTiming(Graphics *gfx, const char *name);
+		~ScopedTiming();
+
+	private:
+
+		Graphics *gfx;
+	};
+
 	struct DrawCommand
 	{
 		PrimitiveType primitiveType = PRIMITIVE_TRIANGLES;
@@ -456,10 +501,30 @@ class Graphics : public Module
 	Font *newDefaultFont(int size, const font::TrueTypeRasterizer::Settings &settings);
 	Video *newVideo(love::video::VideoStream *stream, float dpiscale);
 
-	SpriteBatch *newSpriteBatch(Texture *texture, int size, BufferDataUsage usage);
+	SpriteBatch *newSpriteBatch(Texture *texture, int size, BufferDataUsage usage, bool instanced = false);
 	ParticleSystem *newParticleSystem(Texture *texture, int size);
 
+	/**
+	 * Updates several ParticleSystems in parallel on the shared worker pool,
+	 * and prepares their vertices for drawing. GPU-simulated systems are
+	 * updated on the calling thread. Each ParticleSystem must only appear once.
+	 **/
+	void updateParticleSystems(const std::vector<ParticleSystem *> &systems, float dt);
+
 	Shader *newShader(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options);
+
+	/**
+	 * Creates a Shader using stages which newShaderAsync has already parsed,
+	 * so they aren't parsed again.
+	 **/
+	Shader *newShader(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options, StrongRef<ShaderStage> prevalidated[SHADERSTAGE_MAX_ENUM]);
+
+	/**
+	 * Validates (and on some backends compiles) a Shader on the shared worker
+	 * pool. The fallback Shader is used by the AsyncShader until it's ready.
+	 **/
+	AsyncShader *newShaderAsync(const std::vector<std::string> &stagessource, const Shader::CompileOptions &options, Shader *fallback);
+
 	Shader *newComputeShader(const std::string &source, const Shader::CompileOptions &options);
 
 	virtual Buffer *newBuffer(const Buffer::Settings &settings, const std::vector<Buffer::DataDeclaration> &format, const void *data, size_t size, size_t arraylength) = 0;
@@ -477,8 +542,23 @@ class Graphics : public Module
 	image::ImageData *readbackTexture(Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty);
 	GraphicsReadback *readbackTextureAsync(Texture *texture, int slice, int mipmap, const Rect &rect, image::ImageData *dest, int destx, int desty);
 
+	ReadbackRing *newReadbackRing(int size);
+
+	/**
+	 * ReadbackRings register themselves so their completed readbacks are
+	 * collected every time a frame is presented.
+	 **/
+	void registerReadbackRing(ReadbackRing *ring);
+	void unregisterReadbackRing(ReadbackRing *ring);
+
 	bool validateShader(bool gles, const std::vector<std::string> &stages, const Shader::CompileOptions &options, std::string &err);
 
+	/**
+	 * Returns the glslang shader for the given code if newShaderAsync already
+	 * parsed it, and transfers its ownership to the caller.
+	 **/
+	glslang::TShader *takePrevalidatedShaderStage(ShaderStageType stage, const std::string &glsl);
+
 	Texture *getDefaultTexture(TextureType type, DataBaseType dataType, bool depthSample);
 	Buffer *getDefaultTexelBuffer(DataBaseType dataType);
 	Buffer *getDefaultStorageBuffer();
@@ -702,6 +782,34 @@ class Graphics : public Module
 	 **/
 	bool isWireframe() const;
 
+	/**
+	 * Sets whether automatic batching can combine draws which use different
+	 * textures, by giving each texture in a batch its own slot in a standard
+	 * multi-texture shader. Only used when no custom shader is active.
+	 **/
+	void setMultiTextureBatching(bool enable);
+	bool isMultiTextureBatching() const;
+
+	/**
+	 * Starts recording automatically batched draws instead of submitting them.
+	 * Recorded draws are sorted by layer, shader, blend state, vertex format
+	 * and texture when the scope ends (or when a state change which can't be
+	 * recorded forces a flush), so interleaved draws of different textures can
+	 * be merged into fewer batches. Shader uniform values are read when the
+	 * recorded draws are submitted, not when they're recorded.
+	 **/
+	void beginBatchScope(BatchScopeMode mode);
+	void endBatchScope();
+	bool isBatchScopeActive() const;
+
+	/**
+	 * Draws recorded in a lower layer are always submitted before draws in a
+	 * higher layer. Draws within a layer keep their relative order only when
+	 * their sort keys match.
+	 **/
+	void setBatchLayer(int layer);
+	int getBatchLayer() const;
+
 	void captureScreenshot(const ScreenshotInfo &info);
 
 	void copyBuffer(Buffer *source, Buffer *dest, size_t sourceoffset, size_t destoffset, size_t size);
@@ -853,6 +961,41 @@ class Graphics : public Module
 	 **/
 	Stats getStats() const;
 
+	/**
+	 * Number of frames which have been presented so far.
+	 **/
+	uint64 getFrameNumber() const { return frameNumber; }
+
+	/**
+	 * Texture uploads queued by Texture::replacePixelsAsync are processed in
+	 * order when a frame is presented, until the per-frame byte budget is used
+	 * up. At least one upload is processed every frame.
+	 **/
+	void queueTextureUpload(Texture *texture, love::image::ImageDataBase *data, int slice, int mipmap, int x, int y, bool reloadmipmaps);
+
+	/**
+	 * Number of queued uploads for the given Texture, or for all Textures when
+	 * it's null.
+	 **/
+	int getPendingTextureUploadCount(const Texture *texture = nullptr) const;
+
+	/**
+	 * When frame timing is enabled, the CPU time spent in each timing scope is
+	 * recorded every frame, along with the GPU time when the backend supports
+	 * timestamp queries. Scopes with the same name and parent are merged.
+	 **/
+	void setFrameTimingEnabled(bool enable);
+	bool isFrameTimingEnabled() const;
+
+	void pushTimingScope(const char *name);
+	void popTimingScope();
+
+	/**
+	 * Gets the timings of the most recent frame whose GPU timestamps (if any)
+	 * have been resolved. Returns false if no frame has been recorded yet.
+	 **/
+	bool getFrameTimings(TimingScope &timings) const;
+
 	size_t getStackDepth() const;
 	void push(StackType type = STACK_TRANSFORM);
 	void pop();
@@ -920,9 +1063,16 @@ class Graphics : public Module
 	STRINGMAP_CLASS_DECLARE(Feature);
 	STRINGMAP_CLASS_DECLARE(SystemLimit);
 	STRINGMAP_CLASS_DECLARE(StackType);
+	STRINGMAP_CLASS_DECLARE(BatchScopeMode);
 
 protected:
 
+	// Must match the number of texture slots in the multi-texture shader.
+	static const int MAX_BATCH_TEXTURES = 8;
+
+	// Vertex attribute location of the per-vertex texture index stream.
+	static const int BATCH_TEXTURE_INDEX_ATTRIB = 3;
+
 	struct DisplayState
 	{
 		DisplayState();
@@ -969,6 +1119,7 @@ class Graphics : public Module
 	{
 		StreamBuffer *vb[2] = {};
 		StreamBuffer *indexBuffer = nullptr;
+		StreamBuffer *textureIndexBuffer = nullptr;
 
 		PrimitiveType primitiveMode = PRIMITIVE_TRIANGLES;
 		CommonFormat formats[2] = {};
@@ -976,15 +1127,52 @@ class Graphics : public Module
 		Shader::StandardShader standardShaderType = Shader::STANDARD_DEFAULT;
 		int vertexCount = 0;
 		int indexCount = 0;
+		IndexDataType indexType = INDEX_UINT16;
+
+		// Only used by multi-texture batches. Index 0 is the main texture.
+		StrongRef<Texture> textures[MAX_BATCH_TEXTURES];
+		int textureCount = 0;
 
-		VertexAttributesID attributesIDs[(int)CommonFormat::COUNT][(int)CommonFormat::COUNT] = {};
+		VertexAttributesID attributesIDs[2][(int)CommonFormat::COUNT][(int)CommonFormat::COUNT] = {};
 
 		StreamBuffer::MapInfo vbMap[2] = {};
 		StreamBuffer::MapInfo indexBufferMap = StreamBuffer::MapInfo();
+		StreamBuffer::MapInfo textureIndexMap = StreamBuffer::MapInfo();
 
 		bool flushing = false;
 	};
 
+	struct RecordedBatchedDraw
+	{
+		BatchedDrawCommand command;
+		size_t dataOffsets[2];
+		uint16 shaderID;
+		uint8 blendID;
+	};
+
+	struct BatchScopeState
+	{
+		bool active = false;
+		bool replaying = false;
+		int replaySuspended = 0;
+		int layer = 0;
+
+		std::vector<RecordedBatchedDraw> draws;
+		std::vector<uint64> sortKeys;
+		std::vector<uint8> vertexData;
+
+		// Resources referenced by recorded draws. Indices into these are used
+		// as the IDs packed into sort keys.
+		std::unordered_map<Texture *, uint16> textureIDs;
+		std::vector<StrongRef<Texture>> textures;
+		std::vector<StrongRef<Shader>> shaders;
+		std::vector<BlendState> blendStates;
+		std::vector<uint32> formatIDs;
+
+		std::vector<uint32> order;
+		std::vector<uint32> orderScratch;
+	};
+
 	struct TemporaryBuffer
 	{
 		Buffer *buffer;
@@ -1012,6 +1200,7 @@ class Graphics : public Module
 	ShaderStage *newShaderStage(ShaderStageType stage, const std::string &source, const Shader::CompileOptions &options, const Shader::SourceInfo &info, bool cache);
 	virtual ShaderStage *newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles) = 0;
 	virtual Shader *newShaderInternal(StrongRef<ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const Shader::CompileOptions &options) = 0;
+	virtual AsyncShader::Precompiler getShaderPrecompiler(const std::string /*glsl*/[SHADERSTAGE_MAX_ENUM]) { return nullptr; }
 	virtual StreamBuffer *newStreamBuffer(BufferUsage type, size_t size) = 0;
 
 	virtual GraphicsReadback *newReadbackInternal(ReadbackMethod method, Buffer *buffer, size_t offset, size_t size, data::ByteData *dest, size_t destoffset) = 0;
@@ -1025,6 +1214,17 @@ class Graphics : public Module
 	virtual void initCapabilities() = 0;
 	virtual void getAPIStats(int &shaderswitches) const = 0;
 
+	// GPU timestamp queries used by frame timing. writeTimestampQuery returns
+	// an index into the current frame's set of queries, or -1. Submitted sets
+	// are resolved in order.
+	virtual int writeTimestampQuery() { return -1; }
+	virtual void submitTimestampQueries() {}
+	virtual TimestampQueryStatus getTimestampQueryResults(std::vector<double> &/*seconds*/) { return TIMESTAMP_QUERIES_UNAVAILABLE; }
+
+	void beginFrameTiming();
+	void endFrameTiming();
+	void resetFrameTimings();
+
 	void createQuadIndexBuffer();
 	void createFanIndexBuffer();
 
@@ -1047,6 +1247,13 @@ class Graphics : public Module
 
 	void updateDeviceProjection(const Matrix4 &projection);
 
+	// Flushes batched draws without ending a sorted batch scope's recording,
+	// for state which is captured per recorded draw.
+	void flushBatchedDrawsForRecordedState();
+
+	BatchedVertexData recordBatchedDraw(const BatchedDrawCommand &command);
+	void replayBatchScope();
+
 	int width;
 	int height;
 	int pixelWidth;
@@ -1060,10 +1267,29 @@ class Graphics : public Module
 
 	StrongRef<love::graphics::Font> defaultFont;
 
+	struct PendingTextureUpload
+	{
+		StrongRef<Texture> texture;
+		StrongRef<love::image::ImageDataBase> data;
+		int slice;
+		int mipmap;
+		int x;
+		int y;
+		bool reloadMipmaps;
+	};
+
+	void processPendingTextureUploads();
+
 	std::vector<ScreenshotInfo> pendingScreenshotCallbacks;
 	std::vector<StrongRef<GraphicsReadback>> pendingReadbacks;
+	std::vector<ReadbackRing *> readbackRings;
+	std::deque<PendingTextureUpload> pendingTextureUploads;
 
 	BatchedDrawState batchedDrawState;
+	BatchScopeState batchScope;
+
+	// Created the first time work is handed to it.
+	StrongRef<thread::WorkerPool> workerPool;
 
 	std::vector<Matrix4> transformStack;
 	Matrix4 deviceProjectionMatrix;
@@ -1079,6 +1305,7 @@ class Graphics : public Module
 	int renderTargetSwitchCount;
 	int drawCalls;
 	int drawCallsBatched;
+	int drawCallsBatchedUint32;
 
 	Buffer *quadIndexBuffer;
 	Buffer *fanIndexBuffer;
@@ -1089,26 +1316,64 @@ class Graphics : public Module
 
 	bool usingNoTextureCubeShadowBiasHack = false;
 
+	bool multiTextureBatching = false;
+
 	static const size_t MAX_USER_STACK_DEPTH = 128;
 	static const int MAX_TEMPORARY_RESOURCE_UNUSED_FRAMES = 16;
+	static const size_t MAX_TEXTURE_UPLOAD_BYTES_PER_FRAME = 16 * 1024 * 1024;
 
 private:
 
+	struct TimingNode
+	{
+		std::string name;
+		double cpuTime = 0.0;
+		int calls = 0;
+		std::vector<std::pair<int, int>> gpuQueries;
+		std::vector<size_t> children;
+	};
+
+	struct OpenTimingScope
+	{
+		size_t node;
+		double cpuStart;
+		int gpuQueryStart;
+	};
+
 	void checkSetDefaultFont();
 	int calculateEllipsePoints(float rx, float ry) const;
 
+	void popTimingScopeInternal();
+	TimingScope buildTimingScope(const std::vector<TimingNode> &nodes, size_t index, const std::vector<double> *timestamps) const;
+
 	Texture *defaultTextures[TEXTURE_MAX_ENUM][DATA_BASETYPE_MAX_ENUM][2];
 	Buffer *defaultTexelBuffers[DATA_BASETYPE_MAX_ENUM];
 	Buffer *defaultStorageBuffer;
 
 	std::vector<uint8> scratchBuffer;
 
+	// Separate from scratchBuffer, which often holds the line's coordinates.
+	PolylineScratch polylineScratch;
+
 	std::unordered_map<std::string, ShaderStage *> cachedShaderStages[SHADERSTAGE_MAX_ENUM];
 
+	// Only set while an AsyncShader's Shader is being created.
+	StrongRef<ShaderStage> *prevalidatedShaderStages;
+
+	uint64 frameNumber;
+
 	std::vector<VertexAttributes> vertexAttributesDatabase;
 
 	VertexAttributesID noAttributesID;
 
+	bool frameTimingEnabled;
+	bool frameTimingActive;
+	std::vector<TimingNode> timingNodes;
+	std::vector<OpenTimingScope> timingStack;
+	std::deque<std::vector<TimingNode>> pendingTimingFrames;
+	TimingScope lastFrameTimings;
+	bool hasFrameTimings;
+
 }; // Graphics
 
 STRINGMAP_DECLARE(Renderer);
@@ -406,31 +406,120 @@ void *Mesh::getVertexData() const
 
 void Mesh::setVertexDataModified(size_t offset, size_t size)
 {
-	if (vertexData != nullptr)
-		modifiedVertexData.encapsulate(offset, size);
+	if (vertexData == nullptr || size == 0)
+		return;
+
+	Range range(offset, size);
+
+	// Repeated edits to the same or consecutive vertices are common, so merge
+	// them here instead of growing the list.
+	if (!modifiedVertexRanges.empty())
+	{
+		Range &last = modifiedVertexRanges.back();
+		if (range.first <= last.last + 1 && range.last + 1 >= last.first)
+		{
+			last.encapsulate(range);
+			return;
+		}
+	}
+
+	if (modifiedVertexRanges.size() >= MAX_MODIFIED_RANGES)
+	{
+		Range all = range;
+		for (const Range &r : modifiedVertexRanges)
+			all.encapsulate(r);
+
+		modifiedVertexRanges.clear();
+		modifiedVertexRanges.push_back(all);
+		return;
+	}
+
+	modifiedVertexRanges.push_back(range);
+}
+
+void Mesh::setVertices(const void *data, size_t datasize, size_t startvertex, const std::vector<Range> &vertexranges)
+{
+	if (vertexData == nullptr)
+		throw love::Exception("Mesh must own its own vertex buffer.");
+
+	size_t datavertices = datasize / vertexStride;
+
+	if (startvertex >= vertexCount)
+		throw love::Exception("Invalid vertex start index: %zu", startvertex + 1);
+
+	for (const Range &r : vertexranges)
+	{
+		if (!r.isValid() || r.first < startvertex || r.last >= vertexCount)
+			throw love::Exception("Invalid vertex range (vertices %zu to %zu) for a Mesh with %zu vertices.", r.first + 1, r.last + 1, vertexCount);
+
+		if (r.last - startvertex >= datavertices)
+			throw love::Exception("Vertex range (vertices %zu to %zu) is outside of the given data.", r.first + 1, r.last + 1);
+	}
+
+	const uint8 *src = (const uint8 *) data;
+
+	for (const Range &r : vertexranges)
+	{
+		size_t offset = r.first * vertexStride;
+		size_t size = r.getSize() * vertexStride;
+
+		memcpy(vertexData + offset, src + (r.first - startvertex) * vertexStride, size);
+		setVertexDataModified(offset, size);
+	}
 }
 
 void Mesh::flush()
 {
-	if (vertexBuffer.get() && vertexData != nullptr && modifiedVertexData.isValid())
+	if (vertexBuffer.get() && vertexData != nullptr && !modifiedVertexRanges.empty())
 	{
+		Graphics::ScopedTiming timing(Module::getInstance<Graphics>(Module::M_GRAPHICS), "uploadBuffer");
+
 		if (vertexBuffer->getDataUsage() == BUFFERDATAUSAGE_STREAM)
 		{
 			vertexBuffer->fill(0, vertexBuffer->getSize(), vertexData);
 		}
 		else
 		{
-			size_t offset = modifiedVertexData.getOffset();
-			size_t size = modifiedVertexData.getSize();
-			vertexBuffer->fill(offset, size, vertexData + offset);
+			std::sort(modifiedVertexRanges.begin(), modifiedVertexRanges.end(), [](const Range &a, const Range &b)
+			{
+				return a.first < b.first;
+			});
+
+			// Merge overlapping and nearby ranges in place.
+			size_t count = 1;
+			for (size_t i = 1; i < modifiedVertexRanges.size(); i++)
+			{
+				Range &prev = modifiedVertexRanges[count - 1];
+				const Range &r = modifiedVertexRanges[i];
+
+				if (r.first <= prev.last + 1 + MODIFIED_RANGE_MERGE_GAP)
+					prev.encapsulate(r);
+				else
+					modifiedVertexRanges[count++] = r;
+			}
+
+			if (count > MAX_MODIFIED_RANGE_UPLOADS)
+			{
+				modifiedVertexRanges[0].encapsulate(modifiedVertexRanges[count - 1]);
+				count = 1;
+			}
+
+			for (size_t i = 0; i < count; i++)
+			{
+				const Range &r = modifiedVertexRanges[i];
+				vertexBuffer->fill(r.getOffset(), r.getSize(), vertexData + r.getOffset());
+			}
 		}
 
-		modifiedVertexData.invalidate();
+		modifiedVertexRanges.clear();
 	}
 
 	if (indexDataModified && indexData != nullptr && indexBuffer != nullptr)
 	{
-		indexBuffer->fill(0, indexBuffer->getSize(), indexData);
+		Graphics::ScopedTiming timing(Module::getInstance<Graphics>(Module::M_GRAPHICS), "uploadBuffer");
+		size_t size = indexCount * getIndexDataSize(indexDataType);
+		if (size > 0)
+			indexBuffer->fill(0, size, indexData);
 		indexDataModified = false;
 	}
 }
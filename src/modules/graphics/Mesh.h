@@ -122,10 +122,24 @@ class Mesh : public Drawable
 	const std::vector<BufferAttribute> &getAttachedAttributes() const;
 
 	void *getVertexData() const;
+
+	/**
+	 * Marks a byte range of the vertex data as modified. Modified ranges are
+	 * kept separately until the next flush, so scattered edits don't upload
+	 * all the unmodified vertices between them.
+	 **/
 	void setVertexDataModified(size_t offset, size_t size);
 
 	/**
-	 * Flushes all modified data to the GPU.
+	 * Copies the given ranges of vertices from data into the Mesh. The data
+	 * holds consecutive vertices starting at vertex startvertex, and each range
+	 * is a vertex index and count within it.
+	 **/
+	void setVertices(const void *data, size_t datasize, size_t startvertex, const std::vector<Range> &vertexranges);
+
+	/**
+	 * Flushes all modified data to the GPU. Nearby modified ranges are merged
+	 * into a single upload.
 	 **/
 	void flush();
 
@@ -191,6 +205,17 @@ class Mesh : public Drawable
 
 	friend class SpriteBatch;
 
+	// Modified ranges separated by at most this many bytes are uploaded
+	// together, since a separate upload costs more than the unmodified bytes.
+	static constexpr size_t MODIFIED_RANGE_MERGE_GAP = 1024;
+
+	// Past this many separate uploads per flush, a single upload which covers
+	// all modified ranges is used instead.
+	static constexpr size_t MAX_MODIFIED_RANGE_UPLOADS = 64;
+
+	// Past this many pending ranges, they're collapsed into one.
+	static constexpr size_t MAX_MODIFIED_RANGES = 4096;
+
 	void setupAttachedAttributes();
 	int getAttachedAttributeIndex(const std::string &name) const;
 	int getAttachedAttributeIndex(int bindingLocation) const;
@@ -209,7 +234,7 @@ class Mesh : public Drawable
 	// Vertex buffer, for the vertex data.
 	StrongRef<Buffer> vertexBuffer;
 	uint8 *vertexData = nullptr;
-	Range modifiedVertexData = Range();
+	std::vector<Range> modifiedVertexRanges;
 
 	size_t vertexCount = 0;
 	size_t vertexStride = 0;
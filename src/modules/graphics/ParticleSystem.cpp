@@ -22,6 +22,7 @@
 #include "common/config.h"
 #include "ParticleSystem.h"
 #include "Graphics.h"
+#include "Shader.h"
 
 #include "common/math.h"
 #include "modules/math/RandomGenerator.h"
@@ -30,6 +31,15 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
+
+#if defined(LOVE_SIMD_SSE)
+#include <xmmintrin.h>
+#endif
+
+#if defined(LOVE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace love
 {
@@ -39,9 +49,17 @@ namespace graphics
 namespace
 {
 
-love::math::RandomGenerator rng;
+// Seeds the generator of each new ParticleSystem.
+love::math::RandomGenerator seedGenerator;
+
+love::math::RandomGenerator::Seed newSeed()
+{
+	love::math::RandomGenerator::Seed seed;
+	seed.b64 = seedGenerator.rand();
+	return seed;
+}
 
-float calculate_variation(float inner, float outer, float var)
+float calculate_variation(love::math::RandomGenerator &rng, float inner, float outer, float var)
 {
 	float low = inner - (outer/2.0f)*var;
 	float high = inner + (outer/2.0f)*var;
@@ -49,15 +67,278 @@ float calculate_variation(float inner, float outer, float var)
 	return low*(1-r)+high*r;
 }
 
+// Particle layout shared by the simulation buffers, the GPU equivalent of the
+// per-particle fields. Integration mirrors updateParticlesScalar.
+const char *simulationShaderCode = R"(
+#pragma language glsl4
+
+layout (local_size_x = 64) in;
+
+struct Particle
+{
+	vec4 positionVelocity;
+	vec4 originLife; // origin.xy, life, lifetime
+	vec4 acceleration; // linear.xy, radial, tangential
+	vec4 dampingSize; // damping, size offset, size interval size, size
+	vec4 rotationSpin; // rotation, angle, spin start, spin end
+	vec4 color;
+};
+
+struct ParticleVertex
+{
+	vec2 position;
+	vec2 texCoord;
+	uint color;
+	uint padding;
+};
+
+layout (std430) readonly buffer SourceParticles { Particle sourceParticles[]; };
+layout (std430) writeonly buffer DestParticles { Particle destParticles[]; };
+layout (std430) buffer DestArgs { uint destArgs[]; };
+layout (std430) writeonly buffer ParticleVertices { ParticleVertex vertices[]; };
+
+#ifdef LOVE_PARTICLE_SPAWN
+uniform uint sourceCount;
+#else
+layout (std430) readonly buffer SourceArgs { uint sourceArgs[]; };
+#endif
+
+uniform float dt;
+uniform uint maxParticles;
+uniform float sizes[8];
+uniform int sizeCount;
+uniform vec4 colors[8];
+uniform int colorCount;
+uniform int relativeRotation;
+uniform vec2 quadPositions[4];
+uniform vec2 quadTexCoords[4];
+uniform vec2 quadOffset;
+
+float getInterval(float x, int count, out int i, out int k)
+{
+	float s = x * float(count - 1);
+	i = s > 0.0 ? min(int(s), count - 1) : 0;
+	k = i == count - 1 ? i : i + 1;
+	return s - float(i);
+}
+
+void updateParticle(inout Particle p)
+{
+	vec2 pos = p.positionVelocity.xy;
+	vec2 velocity = p.positionVelocity.zw;
+
+	vec2 radial = pos - p.originLife.xy;
+	float len = length(radial);
+	radial = len > 0.0 ? radial / len : vec2(0.0);
+	vec2 tangential = vec2(-radial.y, radial.x);
+
+	velocity += (radial * p.acceleration.z + tangential * p.acceleration.w + p.acceleration.xy) * dt;
+	velocity *= 1.0 / (1.0 + p.dampingSize.x * dt);
+	pos += velocity * dt;
+	p.positionVelocity = vec4(pos, velocity);
+
+	float t = 1.0 - p.originLife.z / p.originLife.w;
+
+	float spin = p.rotationSpin.z * (1.0 - t) + p.rotationSpin.w * t;
+	p.rotationSpin.x += spin * dt;
+	p.rotationSpin.y = p.rotationSpin.x;
+
+	int i, k;
+	float s = getInterval(p.dampingSize.y + t * p.dampingSize.z, sizeCount, i, k);
+	p.dampingSize.w = sizes[i] * (1.0 - s) + sizes[k] * s;
+
+	s = getInterval(t, colorCount, i, k);
+	p.color = colors[i] * (1.0 - s) + colors[k] * s;
+
+	if (relativeRotation != 0)
+		p.rotationSpin.y += atan(velocity.y, velocity.x);
+}
+
+void writeVertices(uint slot, Particle p)
+{
+	const int corners[6] = int[6](0, 1, 2, 2, 1, 3);
+
+	float c = cos(p.rotationSpin.y);
+	float s = sin(p.rotationSpin.y);
+	float size = p.dampingSize.w;
+	uint color = packUnorm4x8(p.color);
+
+	for (int v = 0; v < 6; v++)
+	{
+		vec2 local = (quadPositions[corners[v]] - quadOffset) * size;
+
+		ParticleVertex vertex;
+		vertex.position = p.positionVelocity.xy + vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+		vertex.texCoord = quadTexCoords[corners[v]];
+		vertex.color = color;
+		vertex.padding = 0u;
+
+		vertices[slot * 6u + uint(v)] = vertex;
+	}
+}
+
+void computemain()
+{
+	uint index = love_GlobalThreadID.x;
+
+#ifdef LOVE_PARTICLE_SPAWN
+	if (index >= sourceCount)
+		return;
+	Particle p = sourceParticles[index];
+#else
+	if (index >= sourceArgs[0] / 6u)
+		return;
+
+	Particle p = sourceParticles[index];
+	p.originLife.z -= dt;
+	if (p.originLife.z <= 0.0)
+		return;
+
+	updateParticle(p);
+#endif
+
+	// The CPU caps emission so this shouldn't overflow, but don't let a
+	// rounding difference in lifetimes write out of bounds.
+	uint slot = atomicAdd(destArgs[0], 6u) / 6u;
+	if (slot >= maxParticles)
+	{
+		atomicAdd(destArgs[0], 0xFFFFFFFAu);
+		return;
+	}
+
+	destParticles[slot] = p;
+	writeVertices(slot, p);
+}
+)";
+
+
+std::vector<Buffer::DataDeclaration> getSimulationParticleFormat()
+{
+	return {
+		{ "positionVelocity", DATAFORMAT_FLOAT_VEC4 },
+		{ "originLife", DATAFORMAT_FLOAT_VEC4 },
+		{ "acceleration", DATAFORMAT_FLOAT_VEC4 },
+		{ "dampingSize", DATAFORMAT_FLOAT_VEC4 },
+		{ "rotationSpin", DATAFORMAT_FLOAT_VEC4 },
+		{ "color", DATAFORMAT_FLOAT_VEC4 },
+	};
+}
+
+void sendFloats(Shader *shader, const char *name, const float *values, int count)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+	if (info == nullptr)
+		return;
+
+	count = std::min(count, info->count);
+	memcpy(info->floats, values, sizeof(float) * info->components * count);
+	shader->updateUniform(info, count);
+}
+
+void sendInt(Shader *shader, const char *name, int value)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+	if (info == nullptr)
+		return;
+
+	info->ints[0] = value;
+	shader->updateUniform(info, 1);
+}
+
+void sendBuffer(Shader *shader, const char *name, Buffer *buffer)
+{
+	const Shader::UniformInfo *info = shader->getUniformInfo(name);
+	if (info != nullptr)
+		shader->sendBuffers(info, &buffer, 1);
+}
+
+// Finds the two values to interpolate between for a position in [0, 1] along
+// a list of count evenly spaced values, and the interpolation amount.
+inline void getInterval(float x, size_t count, size_t &i, size_t &k, float &s)
+{
+	s = x * (float)(count - 1); // 0 <= s < count
+	i = s > 0.0f ? std::min((size_t) s, count - 1) : 0;
+	k = (i == count - 1) ? i : i + 1; // boundary check (prevents failing on x = 1.0f)
+	s -= (float) i; // transpose s to be in interval [0:1]: i <= s < i + 1 ~> 0 <= s < 1
+}
+
+#if defined(LOVE_SIMD_SSE)
+
+typedef __m128 float4;
+
+inline float4 load4(const float *p) { return _mm_loadu_ps(p); }
+inline void store4(float *p, float4 v) { _mm_storeu_ps(p, v); }
+inline float4 set4(float v) { return _mm_set1_ps(v); }
+inline float4 add4(float4 a, float4 b) { return _mm_add_ps(a, b); }
+inline float4 sub4(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+inline float4 div4(float4 a, float4 b) { return _mm_div_ps(a, b); }
+
+// 1 / sqrt(v), or 0 where v is 0.
+inline float4 inverseLength4(float4 v)
+{
+	float4 mask = _mm_cmpgt_ps(v, _mm_setzero_ps());
+	return _mm_and_ps(mask, _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(v)));
+}
+
+#elif defined(LOVE_SIMD_NEON)
+
+typedef float32x4_t float4;
+
+inline float4 load4(const float *p) { return vld1q_f32(p); }
+inline void store4(float *p, float4 v) { vst1q_f32(p, v); }
+inline float4 set4(float v) { return vdupq_n_f32(v); }
+inline float4 add4(float4 a, float4 b) { return vaddq_f32(a, b); }
+inline float4 sub4(float4 a, float4 b) { return vsubq_f32(a, b); }
+inline float4 mul4(float4 a, float4 b) { return vmulq_f32(a, b); }
+
+inline float4 div4(float4 a, float4 b)
+{
+#if defined(__aarch64__) || defined(_M_ARM64)
+	return vdivq_f32(a, b);
+#else
+	// Reciprocal estimate refined with two Newton-Raphson steps.
+	float4 r = vrecpeq_f32(b);
+	r = vmulq_f32(vrecpsq_f32(b, r), r);
+	r = vmulq_f32(vrecpsq_f32(b, r), r);
+	return vmulq_f32(a, r);
+#endif
+}
+
+// 1 / sqrt(v), or 0 where v is 0.
+inline float4 inverseLength4(float4 v)
+{
+	uint32x4_t mask = vcgtq_f32(v, vdupq_n_f32(0.0f));
+#if defined(__aarch64__) || defined(_M_ARM64)
+	float4 r = vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(v));
+#else
+	float4 r = vrsqrteq_f32(v);
+	r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(v, r), r), r);
+	r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(v, r), r), r);
+#endif
+	return vreinterpretq_f32_u32(vandq_u32(mask, vreinterpretq_u32_f32(r)));
+}
+
+#endif
+
+#if defined(LOVE_SIMD_SSE) || defined(LOVE_SIMD_NEON)
+
+inline float4 lerp4(float4 a, float4 b, float4 s)
+{
+	return add4(mul4(a, sub4(set4(1.0f), s)), mul4(b, s));
+}
+
+#endif
+
 } // anonymous namespace
 
 love::Type ParticleSystem::type("ParticleSystem", &Drawable::type);
 
+Shader *ParticleSystem::simulationShaders[ParticleSystem::SIMULATION_PASS_MAX_ENUM] = {nullptr};
+
 ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
-	: pMem(nullptr)
-	, pFree(nullptr)
-	, pHead(nullptr)
-	, pTail(nullptr)
+	: fields()
+	, fieldStride(0)
 	, texture(texture)
 	, active(true)
 	, insertMode(INSERT_MODE_TOP)
@@ -95,6 +376,8 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	, relativeRotation(false)
 	, vertexAttributesID(Module::getInstance<Graphics>(Module::M_GRAPHICS)->registerVertexAttributes(VertexAttributes(CommonFormat::XYf_STf_RGBAub, 0)))
 	, buffer(nullptr)
+	, verticesPrepared(false)
+	, simulationMode(SIMULATION_CPU)
 {
 	if (size == 0 || size > MAX_PARTICLES)
 		throw love::Exception("Invalid ParticleSystem size.");
@@ -105,14 +388,13 @@ ParticleSystem::ParticleSystem(Texture *texture, uint32 size)
 	sizes.push_back(1.0f);
 	colors.push_back(Colorf(1.0f, 1.0f, 1.0f, 1.0f));
 
+	rng.setSeed(newSeed());
 	setBufferSize(size);
 }
 
 ParticleSystem::ParticleSystem(const ParticleSystem &p)
-	: pMem(nullptr)
-	, pFree(nullptr)
-	, pHead(nullptr)
-	, pTail(nullptr)
+	: fields()
+	, fieldStride(0)
 	, texture(p.texture)
 	, active(p.active)
 	, insertMode(p.insertMode)
@@ -156,12 +438,17 @@ ParticleSystem::ParticleSystem(const ParticleSystem &p)
 	, relativeRotation(p.relativeRotation)
 	, vertexAttributesID(p.vertexAttributesID)
 	, buffer(nullptr)
+	, verticesPrepared(false)
+	, simulationMode(SIMULATION_CPU)
 {
+	rng.setSeed(newSeed());
 	setBufferSize(maxParticles);
+	setSimulationMode(p.simulationMode);
 }
 
 ParticleSystem::~ParticleSystem()
 {
+	deleteGPUBuffers();
 	deleteBuffers();
 }
 
@@ -185,7 +472,13 @@ void ParticleSystem::createBuffers(size_t size)
 {
 	try
 	{
-		pFree = pMem = new Particle[size];
+		fieldStride = (uint32) ((size + 3) & ~(size_t) 3);
+		particleData.assign((size_t) fieldStride * FIELD_MAX_ENUM, 0.0f);
+		quadIndices.assign(size, 0);
+
+		for (int i = 0; i < FIELD_MAX_ENUM; i++)
+			fields[i] = particleData.data() + (size_t) fieldStride * i;
+
 		maxParticles = (uint32) size;
 
 		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
@@ -204,11 +497,16 @@ void ParticleSystem::createBuffers(size_t size)
 
 void ParticleSystem::deleteBuffers()
 {
-	delete[] pMem;
 	if (buffer)
 		buffer->release();
 
-	pMem = nullptr;
+	std::vector<float>().swap(particleData);
+	std::vector<int>().swap(quadIndices);
+
+	for (int i = 0; i < FIELD_MAX_ENUM; i++)
+		fields[i] = nullptr;
+
+	fieldStride = 0;
 	buffer = nullptr;
 	maxParticles = 0;
 	activeParticles = 0;
@@ -220,6 +518,13 @@ void ParticleSystem::setBufferSize(uint32 size)
 		throw love::Exception("Invalid buffer size");
 	deleteBuffers();
 	createBuffers(size);
+
+	if (simulationMode == SIMULATION_GPU)
+	{
+		deleteGPUBuffers();
+		createGPUBuffers();
+	}
+
 	reset();
 }
 
@@ -233,43 +538,38 @@ void ParticleSystem::addParticle(float t)
 	if (isFull())
 		return;
 
-	// Gets a free particle and updates the allocation pointer.
-	Particle *p = pFree++;
-	initParticle(p, t);
+	// New particles are always created at the end of the arrays, which is the
+	// top of the draw order.
+	uint32 index = activeParticles++;
+	initParticle(index, t);
 
-	switch (insertMode)
+	if (insertMode == INSERT_MODE_RANDOM && simulationMode == SIMULATION_CPU)
 	{
-	default:
-	case INSERT_MODE_TOP:
-		insertTop(p);
-		break;
-	case INSERT_MODE_BOTTOM:
-		insertBottom(p);
-		break;
-	case INSERT_MODE_RANDOM:
-		insertRandom(p);
-		break;
+		// Nonuniform, but 64-bit is so large nobody will notice. Hopefully.
+		uint32 pos = (uint32) (rng.rand() % (uint64) activeParticles);
+		swapParticles(pos, index);
 	}
-
-	activeParticles++;
 }
 
-void ParticleSystem::initParticle(Particle *p, float t)
+void ParticleSystem::initParticle(uint32 index, float t)
 {
 	float min,max;
 
 	// Linearly interpolate between the previous and current emitter position.
 	love::Vector2 pos = prevPosition + (position - prevPosition) * t;
 
+	float life;
 	min = particleLifeMin;
 	max = particleLifeMax;
 	if (min == max)
-		p->life = min;
+		life = min;
 	else
-		p->life = (float) rng.random(min, max);
-	p->lifetime = p->life;
+		life = (float) rng.random(min, max);
+
+	fields[FIELD_LIFE][index] = life;
+	fields[FIELD_LIFETIME][index] = life;
 
-	p->position = pos;
+	love::Vector2 ppos = pos;
 
 	min = direction - spread/2.0f;
 	max = direction + spread/2.0f;
@@ -285,15 +585,15 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.random(-emissionArea.x, emissionArea.x);
 		rand_y = (float) rng.random(-emissionArea.y, emissionArea.y);
-		p->position.x += c * rand_x - s * rand_y;
-		p->position.y += s * rand_x + c * rand_y;
+		ppos.x += c * rand_x - s * rand_y;
+		ppos.y += s * rand_x + c * rand_y;
 		break;
 	case DISTRIBUTION_NORMAL:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.randomNormal(emissionArea.x);
 		rand_y = (float) rng.randomNormal(emissionArea.y);
-		p->position.x += c * rand_x - s * rand_y;
-		p->position.y += s * rand_x + c * rand_y;
+		ppos.x += c * rand_x - s * rand_y;
+		ppos.y += s * rand_x + c * rand_y;
 		break;
 	case DISTRIBUTION_ELLIPSE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
@@ -301,16 +601,16 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		rand_y = (float) rng.random(-1, 1);
 		min = emissionArea.x * (rand_x * sqrt(1 - 0.5f*pow(rand_y, 2)));
 		max = emissionArea.y * (rand_y * sqrt(1 - 0.5f*pow(rand_x, 2)));
-		p->position.x += c * min - s * max;
-		p->position.y += s * min + c * max;
+		ppos.x += c * min - s * max;
+		ppos.y += s * min + c * max;
 		break;
 	case DISTRIBUTION_BORDER_ELLIPSE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
 		rand_x = (float) rng.random(0, LOVE_M_PI * 2);
 		min = cosf(rand_x) * emissionArea.x;
 		max = sinf(rand_x) * emissionArea.y;
-		p->position.x += c * min - s * max;
-		p->position.y += s * min + c * max;
+		ppos.x += c * min - s * max;
+		ppos.y += s * min + c * max;
 		break;
 	case DISTRIBUTION_BORDER_RECTANGLE:
 		c = cosf(emissionAreaAngle); s = sinf(emissionAreaAngle);
@@ -319,26 +619,26 @@ void ParticleSystem::initParticle(Particle *p, float t)
 		if (rand_x < -rand_y)
 		{
 			min = rand_x + rand_y + emissionArea.x;
-			p->position.x += c * min - s * -emissionArea.y;
-			p->position.y += s * min + c * -emissionArea.y;
+			ppos.x += c * min - s * -emissionArea.y;
+			ppos.y += s * min + c * -emissionArea.y;
 		}
 		else if (rand_x < 0)
 		{
 			max = rand_x + emissionArea.y;
-			p->position.x += c * -emissionArea.x - s * max;
-			p->position.y += s * -emissionArea.x + c * max;
+			ppos.x += c * -emissionArea.x - s * max;
+			ppos.y += s * -emissionArea.x + c * max;
 		}
 		else if (rand_x < rand_y)
 		{
 			max = rand_x - emissionArea.y;
-			p->position.x += c * emissionArea.x - s * max;
-			p->position.y += s * emissionArea.x + c * max;
+			ppos.x += c * emissionArea.x - s * max;
+			ppos.y += s * emissionArea.x + c * max;
 		}
 		else
 		{
 			min = rand_x - rand_y - emissionArea.x;
-			p->position.x += c * min - s * emissionArea.y;
-			p->position.y += s * min + c * emissionArea.y;
+			ppos.x += c * min - s * emissionArea.y;
+			ppos.y += s * min + c * emissionArea.y;
 		}
 		break;
 	case DISTRIBUTION_NONE:
@@ -348,154 +648,98 @@ void ParticleSystem::initParticle(Particle *p, float t)
 
 	// Determine if the origin of each particle is the center of the area
 	if (directionRelativeToEmissionCenter)
-		dir += atan2(p->position.y - pos.y, p->position.x - pos.x);
+		dir += atan2(ppos.y - pos.y, ppos.x - pos.x);
 
-	p->origin = pos;
+	fields[FIELD_POSITION_X][index] = ppos.x;
+	fields[FIELD_POSITION_Y][index] = ppos.y;
+	fields[FIELD_ORIGIN_X][index] = pos.x;
+	fields[FIELD_ORIGIN_Y][index] = pos.y;
 
 	min = speedMin;
 	max = speedMax;
 	float speed = (float) rng.random(min, max);
 
-	p->velocity = love::Vector2(cosf(dir), sinf(dir)) * speed;
+	love::Vector2 velocity = love::Vector2(cosf(dir), sinf(dir)) * speed;
+	fields[FIELD_VELOCITY_X][index] = velocity.x;
+	fields[FIELD_VELOCITY_Y][index] = velocity.y;
 
-	p->linearAcceleration.x = (float) rng.random(linearAccelerationMin.x, linearAccelerationMax.x);
-	p->linearAcceleration.y = (float) rng.random(linearAccelerationMin.y, linearAccelerationMax.y);
+	fields[FIELD_LINEAR_ACCELERATION_X][index] = (float) rng.random(linearAccelerationMin.x, linearAccelerationMax.x);
+	fields[FIELD_LINEAR_ACCELERATION_Y][index] = (float) rng.random(linearAccelerationMin.y, linearAccelerationMax.y);
 
 	min = radialAccelerationMin;
 	max = radialAccelerationMax;
-	p->radialAcceleration = (float) rng.random(min, max);
+	fields[FIELD_RADIAL_ACCELERATION][index] = (float) rng.random(min, max);
 
 	min = tangentialAccelerationMin;
 	max = tangentialAccelerationMax;
-	p->tangentialAcceleration = (float) rng.random(min, max);
+	fields[FIELD_TANGENTIAL_ACCELERATION][index] = (float) rng.random(min, max);
 
 	min = linearDampingMin;
 	max = linearDampingMax;
-	p->linearDamping = (float) rng.random(min, max);
+	fields[FIELD_LINEAR_DAMPING][index] = (float) rng.random(min, max);
 
-	p->sizeOffset       = (float) rng.random(sizeVariation); // time offset for size change
-	p->sizeIntervalSize = (1.0f - (float) rng.random(sizeVariation)) - p->sizeOffset;
-	p->size = sizes[(size_t)(p->sizeOffset - .5f) * (sizes.size() - 1)];
+	float sizeOffset = (float) rng.random(sizeVariation); // time offset for size change
+	fields[FIELD_SIZE_OFFSET][index] = sizeOffset;
+	fields[FIELD_SIZE_INTERVAL_SIZE][index] = (1.0f - (float) rng.random(sizeVariation)) - sizeOffset;
+	fields[FIELD_SIZE][index] = sizes[(size_t)(sizeOffset - .5f) * (sizes.size() - 1)];
 
 	min = rotationMin;
 	max = rotationMax;
-	p->spinStart = calculate_variation(spinStart, spinEnd, spinVariation);
-	p->spinEnd = calculate_variation(spinEnd, spinStart, spinVariation);
-	p->rotation = (float) rng.random(min, max);
+	fields[FIELD_SPIN_START][index] = calculate_variation(rng, spinStart, spinEnd, spinVariation);
+	fields[FIELD_SPIN_END][index] = calculate_variation(rng, spinEnd, spinStart, spinVariation);
 
-	p->angle = p->rotation;
+	float rotation = (float) rng.random(min, max);
+	fields[FIELD_ROTATION][index] = rotation;
+
+	float angle = rotation;
 	if (relativeRotation)
-		p->angle += atan2f(p->velocity.y, p->velocity.x);
+		angle += atan2f(velocity.y, velocity.x);
+	fields[FIELD_ANGLE][index] = angle;
 
-	p->color = colors[0];
+	fields[FIELD_COLOR_R][index] = colors[0].r;
+	fields[FIELD_COLOR_G][index] = colors[0].g;
+	fields[FIELD_COLOR_B][index] = colors[0].b;
+	fields[FIELD_COLOR_A][index] = colors[0].a;
 
-	p->quadIndex = 0;
+	quadIndices[index] = 0;
 }
 
-void ParticleSystem::insertTop(Particle *p)
+void ParticleSystem::moveToBottom(uint32 first)
 {
-	if (pHead == nullptr)
-	{
-		pHead = p;
-		p->prev = nullptr;
-	}
-	else
-	{
-		pTail->next = p;
-		p->prev = pTail;
-	}
-	p->next = nullptr;
-	pTail = p;
-}
+	if (insertMode != INSERT_MODE_BOTTOM || simulationMode != SIMULATION_CPU || first == 0 || first >= activeParticles)
+		return;
 
-void ParticleSystem::insertBottom(Particle *p)
-{
-	if (pTail == nullptr)
+	// Each new particle goes below the previous one, so the newest ends up at
+	// the very bottom.
+	for (int i = 0; i < FIELD_MAX_ENUM; i++)
 	{
-		pTail = p;
-		p->next = nullptr;
+		float *f = fields[i];
+		std::reverse(f + first, f + activeParticles);
+		std::rotate(f, f + first, f + activeParticles);
 	}
-	else
-	{
-		pHead->prev = p;
-		p->next = pHead;
-	}
-	p->prev = nullptr;
-	pHead = p;
+
+	int *q = quadIndices.data();
+	std::reverse(q + first, q + activeParticles);
+	std::rotate(q, q + first, q + activeParticles);
 }
 
-void ParticleSystem::insertRandom(Particle *p)
+void ParticleSystem::copyParticle(uint32 dst, uint32 src)
 {
-	// Nonuniform, but 64-bit is so large nobody will notice. Hopefully.
-	uint64 pos = rng.rand() % ((int64) activeParticles + 1);
-
-	// Special case where the particle gets inserted before the head.
-	if (pos == activeParticles)
-	{
-		Particle *pA = pHead;
-		if (pA)
-			pA->prev = p;
-		p->prev = nullptr;
-		p->next = pA;
-		pHead = p;
-		return;
-	}
+	for (int i = 0; i < FIELD_MAX_ENUM; i++)
+		fields[i][dst] = fields[i][src];
 
-	// Inserts the particle after the randomly selected particle.
-	Particle *pA = pMem + pos;
-	Particle *pB = pA->next;
-	pA->next = p;
-	if (pB)
-		pB->prev = p;
-	else
-		pTail = p;
-	p->prev = pA;
-	p->next = pB;
+	quadIndices[dst] = quadIndices[src];
 }
 
-ParticleSystem::Particle *ParticleSystem::removeParticle(Particle *p)
+void ParticleSystem::swapParticles(uint32 a, uint32 b)
 {
-	// The linked list is updated in this function and old pointers may be
-	// invalidated. The returned pointer will inform the caller of the new
-	// pointer to the next particle.
-	Particle *pNext = nullptr;
-
-	// Removes the particle from the linked list.
-	if (p->prev)
-		p->prev->next = p->next;
-	else
-		pHead = p->next;
-
-	if (p->next)
-	{
-		p->next->prev = p->prev;
-		pNext = p->next;
-	}
-	else
-		pTail = p->prev;
-
-	// The (in memory) last particle can now be moved into the free slot.
-	// It will skip the moving if it happens to be the removed particle.
-	pFree--;
-	if (p != pFree)
-	{
-		*p = *pFree;
-		if (pNext == pFree)
-			pNext = p;
-
-		if (p->prev)
-			p->prev->next = p;
-		else
-			pHead = p;
+	if (a == b)
+		return;
 
-		if (p->next)
-			p->next->prev = p;
-		else
-			pTail = p;
-	}
+	for (int i = 0; i < FIELD_MAX_ENUM; i++)
+		std::swap(fields[i][a], fields[i][b]);
 
-	activeParticles--;
-	return pNext;
+	std::swap(quadIndices[a], quadIndices[b]);
 }
 
 void ParticleSystem::setTexture(Texture *tex)
@@ -504,6 +748,7 @@ void ParticleSystem::setTexture(Texture *tex)
 		throw love::Exception("Only 2D textures can be used with ParticleSystems.");
 
 	texture.set(tex);
+	verticesPrepared = false;
 
 	if (defaultOffset)
 		resetOffset();
@@ -772,6 +1017,7 @@ void ParticleSystem::setOffset(float x, float y)
 {
 	offset = love::Vector2(x, y);
 	defaultOffset = false;
+	verticesPrepared = false;
 }
 
 love::Vector2 ParticleSystem::getOffset() const
@@ -800,6 +1046,9 @@ std::vector<Colorf> ParticleSystem::getColor() const
 
 void ParticleSystem::setQuads(const std::vector<Quad *> &newQuads)
 {
+	if (simulationMode == SIMULATION_GPU && !newQuads.empty())
+		throw love::Exception("Quads cannot be used with GPU-simulated ParticleSystems.");
+
 	std::vector<StrongRef<Quad>> quadlist;
 	quadlist.reserve(newQuads.size());
 
@@ -807,6 +1056,7 @@ void ParticleSystem::setQuads(const std::vector<Quad *> &newQuads)
 		quadlist.push_back(q);
 
 	quads = quadlist;
+	verticesPrepared = false;
 
 	if (defaultOffset)
 		resetOffset();
@@ -815,6 +1065,7 @@ void ParticleSystem::setQuads(const std::vector<Quad *> &newQuads)
 void ParticleSystem::setQuads()
 {
 	quads.clear();
+	verticesPrepared = false;
 }
 
 std::vector<Quad *> ParticleSystem::getQuads() const
@@ -862,15 +1113,16 @@ void ParticleSystem::pause()
 
 void ParticleSystem::reset()
 {
-	if (pMem == nullptr)
+	if (particleData.empty())
 		return;
 
-	pFree = pMem;
-	pHead = nullptr;
-	pTail = nullptr;
 	activeParticles = 0;
 	life = lifetime;
 	emitCounter = 0;
+	verticesPrepared = false;
+
+	if (simulationMode == SIMULATION_GPU)
+		resetGPUBuffers();
 }
 
 void ParticleSystem::emit(uint32 num)
@@ -880,8 +1132,16 @@ void ParticleSystem::emit(uint32 num)
 
 	num = std::min(num, maxParticles - activeParticles);
 
+	uint32 first = activeParticles;
+
 	while (num--)
 		addParticle(1.0f);
+
+	moveToBottom(first);
+	verticesPrepared = false;
+
+	if (simulationMode == SIMULATION_GPU)
+		simulateGPU(0.0f, first);
 }
 
 bool ParticleSystem::isActive() const
@@ -909,105 +1169,250 @@ bool ParticleSystem::isFull() const
 	return activeParticles == maxParticles;
 }
 
-void ParticleSystem::update(float dt)
+void ParticleSystem::updateParticleIntervals(uint32 index, float t)
 {
-	if (pMem == nullptr || dt == 0.0f)
-		return;
+	// Change size according to given intervals:
+	// i = 0       1       2      3          n-1
+	//     |-------|-------|------|--- ... ---|
+	// t = 0    1/(n-1)        3/(n-1)        1
+	//
+	// `s' is the interpolation variable scaled to the current
+	// interval width, e.g. if n = 5 and t = 0.3, then the current
+	// indices are 1,2 and s = 0.3 - 0.25 = 0.05
+	size_t i, k;
+	float s;
+	getInterval(fields[FIELD_SIZE_OFFSET][index] + t * fields[FIELD_SIZE_INTERVAL_SIZE][index], sizes.size(), i, k, s);
+	fields[FIELD_SIZE][index] = sizes[i] * (1.0f - s) + sizes[k] * s;
 
-	// Traverse all particles and update.
-	Particle *p = pHead;
+	// Update color according to given intervals (as above)
+	getInterval(t, colors.size(), i, k, s);
+	Colorf color = colors[i] * (1.0f - s) + colors[k] * s;
+	fields[FIELD_COLOR_R][index] = color.r;
+	fields[FIELD_COLOR_G][index] = color.g;
+	fields[FIELD_COLOR_B][index] = color.b;
+	fields[FIELD_COLOR_A][index] = color.a;
 
-	while (p)
+	updateQuadIndexAndAngle(index, t);
+}
+
+void ParticleSystem::updateQuadIndexAndAngle(uint32 index, float t)
+{
+	size_t k = quads.size();
+	if (k > 0)
+	{
+		float s = t * (float) k; // [0:numquads-1] (clamped below)
+		size_t i = (s > 0.0f) ? (size_t) s : 0;
+		quadIndices[index] = (int) ((i < k) ? i : k - 1);
+	}
+
+	if (relativeRotation)
+		fields[FIELD_ANGLE][index] += atan2f(fields[FIELD_VELOCITY_Y][index], fields[FIELD_VELOCITY_X][index]);
+}
+
+void ParticleSystem::updateParticlesScalar(uint32 start, uint32 end, float dt)
+{
+	for (uint32 i = start; i < end; i++)
 	{
 		// Decrease lifespan.
-		p->life -= dt;
+		float life = fields[FIELD_LIFE][i] -= dt;
 
-		if (p->life <= 0)
-			p = removeParticle(p);
-		else
+		love::Vector2 ppos(fields[FIELD_POSITION_X][i], fields[FIELD_POSITION_Y][i]);
+		love::Vector2 velocity(fields[FIELD_VELOCITY_X][i], fields[FIELD_VELOCITY_Y][i]);
+
+		// Get vector from particle center to particle.
+		love::Vector2 radial = ppos - love::Vector2(fields[FIELD_ORIGIN_X][i], fields[FIELD_ORIGIN_Y][i]);
+		radial.normalize();
+
+		// Calculate tangential acceleration.
+		love::Vector2 tangential(-radial.y, radial.x);
+
+		radial *= fields[FIELD_RADIAL_ACCELERATION][i];
+		tangential *= fields[FIELD_TANGENTIAL_ACCELERATION][i];
+
+		love::Vector2 linear(fields[FIELD_LINEAR_ACCELERATION_X][i], fields[FIELD_LINEAR_ACCELERATION_Y][i]);
+
+		// Update velocity.
+		velocity += (radial + tangential + linear) * dt;
+
+		// Apply damping.
+		velocity *= 1.0f / (1.0f + fields[FIELD_LINEAR_DAMPING][i] * dt);
+
+		// Modify position.
+		ppos += velocity * dt;
+
+		fields[FIELD_POSITION_X][i] = ppos.x;
+		fields[FIELD_POSITION_Y][i] = ppos.y;
+		fields[FIELD_VELOCITY_X][i] = velocity.x;
+		fields[FIELD_VELOCITY_Y][i] = velocity.y;
+
+		const float t = 1.0f - life / fields[FIELD_LIFETIME][i];
+
+		// Rotate.
+		float spin = fields[FIELD_SPIN_START][i] * (1.0f - t) + fields[FIELD_SPIN_END][i] * t;
+		fields[FIELD_ROTATION][i] += spin * dt;
+		fields[FIELD_ANGLE][i] = fields[FIELD_ROTATION][i];
+
+		if (life > 0.0f)
+			updateParticleIntervals(i, t);
+	}
+}
+
+void ParticleSystem::updateParticles(float dt)
+{
+	uint32 count = activeParticles;
+
+#if defined(LOVE_SIMD_SSE) || defined(LOVE_SIMD_NEON)
+	// The arrays are padded to a multiple of 4, so the last group can include
+	// unused slots. Their results are never read.
+	uint32 simdcount = (count + 3) & ~3u;
+
+	float *life = fields[FIELD_LIFE];
+	const float *lifetime = fields[FIELD_LIFETIME];
+	float *posx = fields[FIELD_POSITION_X];
+	float *posy = fields[FIELD_POSITION_Y];
+	const float *originx = fields[FIELD_ORIGIN_X];
+	const float *originy = fields[FIELD_ORIGIN_Y];
+	float *velx = fields[FIELD_VELOCITY_X];
+	float *vely = fields[FIELD_VELOCITY_Y];
+	const float *linaccx = fields[FIELD_LINEAR_ACCELERATION_X];
+	const float *linaccy = fields[FIELD_LINEAR_ACCELERATION_Y];
+	const float *radialacc = fields[FIELD_RADIAL_ACCELERATION];
+	const float *tangentialacc = fields[FIELD_TANGENTIAL_ACCELERATION];
+	const float *damping = fields[FIELD_LINEAR_DAMPING];
+	float *size = fields[FIELD_SIZE];
+	const float *sizeoffset = fields[FIELD_SIZE_OFFSET];
+	const float *sizeinterval = fields[FIELD_SIZE_INTERVAL_SIZE];
+	float *rotation = fields[FIELD_ROTATION];
+	float *angle = fields[FIELD_ANGLE];
+	const float *spinstart = fields[FIELD_SPIN_START];
+	const float *spinend = fields[FIELD_SPIN_END];
+
+	const float4 vdt = set4(dt);
+	const float4 one = set4(1.0f);
+
+	for (uint32 i = 0; i < simdcount; i += 4)
+	{
+		// Decrease lifespan.
+		float4 plife = sub4(load4(life + i), vdt);
+		store4(life + i, plife);
+
+		float4 px = load4(posx + i);
+		float4 py = load4(posy + i);
+
+		// Get the normalized vector from particle center to particle.
+		float4 rx = sub4(px, load4(originx + i));
+		float4 ry = sub4(py, load4(originy + i));
+		float4 invlength = inverseLength4(add4(mul4(rx, rx), mul4(ry, ry)));
+		rx = mul4(rx, invlength);
+		ry = mul4(ry, invlength);
+
+		// Radial acceleration is along (rx, ry), tangential along (-ry, rx).
+		float4 radial = load4(radialacc + i);
+		float4 tangential = load4(tangentialacc + i);
+		float4 ax = add4(sub4(mul4(rx, radial), mul4(ry, tangential)), load4(linaccx + i));
+		float4 ay = add4(add4(mul4(ry, radial), mul4(rx, tangential)), load4(linaccy + i));
+
+		// Update velocity and apply damping.
+		float4 damp = div4(one, add4(one, mul4(load4(damping + i), vdt)));
+		float4 vx = mul4(add4(load4(velx + i), mul4(ax, vdt)), damp);
+		float4 vy = mul4(add4(load4(vely + i), mul4(ay, vdt)), damp);
+		store4(velx + i, vx);
+		store4(vely + i, vy);
+
+		// Modify position.
+		store4(posx + i, add4(px, mul4(vx, vdt)));
+		store4(posy + i, add4(py, mul4(vy, vdt)));
+
+		float4 t = sub4(one, div4(plife, load4(lifetime + i)));
+
+		// Rotate.
+		float4 spin = add4(mul4(load4(spinstart + i), sub4(one, t)), mul4(load4(spinend + i), t));
+		float4 rot = add4(load4(rotation + i), mul4(spin, vdt));
+		store4(rotation + i, rot);
+		store4(angle + i, rot);
+
+		// Sizes and colors are interpolated between the values at either end
+		// of each particle's current interval. Looking up those values is done
+		// per particle, blending them is done for all four at once.
+		float ts[4];
+		store4(ts, t);
+
+		float size0[4] = {}, size1[4] = {}, sizes_s[4] = {};
+		float color0[4][4] = {}, color1[4][4] = {}, colors_s[4] = {};
+
+		uint32 lanes = std::min(4u, count - i);
+		for (uint32 l = 0; l < lanes; l++)
 		{
-			// Temp variables.
-			love::Vector2 radial, tangential;
-			love::Vector2 ppos = p->position;
-
-			// Get vector from particle center to particle.
-			radial = ppos - p->origin;
-			radial.normalize();
-			tangential = radial;
-
-			// Resize radial acceleration.
-			radial *= p->radialAcceleration;
-
-			// Calculate tangential acceleration.
-			{
-				float a = tangential.x;
-				tangential.x = -tangential.y;
-				tangential.y = a;
-			}
-
-			// Resize tangential.
-			tangential *= p->tangentialAcceleration;
-
-			// Update velocity.
-			p->velocity += (radial + tangential + p->linearAcceleration) * dt;
-
-			// Apply damping.
-			p->velocity *= 1.0f / (1.0f + p->linearDamping * dt);
-
-			// Modify position.
-			ppos += p->velocity * dt;
-
-			p->position = ppos;
-
-			const float t = 1.0f - p->life / p->lifetime;
-
-			// Rotate.
-			p->rotation += (p->spinStart * (1.0f - t) + p->spinEnd * t) * dt;
-
-			p->angle = p->rotation;
-
-			if (relativeRotation)
-				p->angle += atan2f(p->velocity.y, p->velocity.x);
-
-			// Change size according to given intervals:
-			// i = 0       1       2      3          n-1
-			//     |-------|-------|------|--- ... ---|
-			// t = 0    1/(n-1)        3/(n-1)        1
-			//
-			// `s' is the interpolation variable scaled to the current
-			// interval width, e.g. if n = 5 and t = 0.3, then the current
-			// indices are 1,2 and s = 0.3 - 0.25 = 0.05
-			float s = p->sizeOffset + t * p->sizeIntervalSize; // size variation
-			s *= (float)(sizes.size() - 1); // 0 <= s < sizes.size()
-			size_t i = (size_t)s;
-			size_t k = (i == sizes.size() - 1) ? i : i + 1; // boundary check (prevents failing on t = 1.0f)
-			s -= (float)i; // transpose s to be in interval [0:1]: i <= s < i + 1 ~> 0 <= s < 1
-			p->size = sizes[i] * (1.0f - s) + sizes[k] * s;
-
-			// Update color according to given intervals (as above)
-			s = t * (float)(colors.size() - 1);
-			i = (size_t)s;
-			k = (i == colors.size() - 1) ? i : i + 1;
-			s -= (float)i;                            // 0 <= s <= 1
-			p->color = colors[i] * (1.0f - s) + colors[k] * s;
-
-			// Update the quad index.
-			k = quads.size();
-			if (k > 0)
-			{
-				s = t * (float) k; // [0:numquads-1] (clamped below)
-				i = (s > 0.0f) ? (size_t) s : 0;
-				p->quadIndex = (int) ((i < k) ? i : k - 1);
-			}
-
-			// Next particle.
-			p = p->next;
+			uint32 j = i + l;
+			if (life[j] <= 0.0f)
+				continue;
+
+			size_t a, b;
+			getInterval(sizeoffset[j] + ts[l] * sizeinterval[j], sizes.size(), a, b, sizes_s[l]);
+			size0[l] = sizes[a];
+			size1[l] = sizes[b];
+
+			getInterval(ts[l], colors.size(), a, b, colors_s[l]);
+			const Colorf &c0 = colors[a];
+			const Colorf &c1 = colors[b];
+			color0[0][l] = c0.r; color0[1][l] = c0.g; color0[2][l] = c0.b; color0[3][l] = c0.a;
+			color1[0][l] = c1.r; color1[1][l] = c1.g; color1[2][l] = c1.b; color1[3][l] = c1.a;
+
+			updateQuadIndexAndAngle(j, ts[l]);
 		}
+
+		store4(size + i, lerp4(load4(size0), load4(size1), load4(sizes_s)));
+
+		float4 cs = load4(colors_s);
+		for (int c = 0; c < 4; c++)
+			store4(fields[FIELD_COLOR_R + c] + i, lerp4(load4(color0[c]), load4(color1[c]), cs));
 	}
+#else
+	updateParticlesScalar(0, count, dt);
+#endif
+
+	removeDeadParticles();
+}
+
+void ParticleSystem::removeDeadParticles()
+{
+	// Compact the arrays in place. Survivors keep their relative order, which
+	// is the draw order established by the insert mode.
+	const float *life = fields[FIELD_LIFE];
+	uint32 count = activeParticles;
+	uint32 dst = 0;
+
+	for (uint32 src = 0; src < count; src++)
+	{
+		if (life[src] > 0.0f)
+		{
+			if (dst != src)
+				copyParticle(dst, src);
+			dst++;
+		}
+	}
+
+	activeParticles = dst;
+}
+
+void ParticleSystem::update(float dt)
+{
+	if (particleData.empty() || dt == 0.0f)
+		return;
+
+	verticesPrepared = false;
+
+	if (simulationMode == SIMULATION_GPU)
+		updateParticleLifetimes(dt);
+	else
+		updateParticles(dt);
+
+	uint32 first = activeParticles;
 
 	// Make some more particles.
 	if (active)
 	{
+
 		float rate = 1.0f / emissionRate; // the amount of time between each particle emit
 		emitCounter += dt;
 		float total = emitCounter - rate;
@@ -1017,55 +1422,60 @@ void ParticleSystem::update(float dt)
 			emitCounter -= rate;
 		}
 
+		moveToBottom(first);
+
 		life -= dt;
 		if (lifetime != -1 && life < 0)
 			stop();
 	}
 
+	if (simulationMode == SIMULATION_GPU)
+		simulateGPU(dt, first);
+
 	prevPosition = position;
 }
 
-void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
+void ParticleSystem::setRandomSeed(love::math::RandomGenerator::Seed seed)
 {
-	uint32 pCount = getCount();
-
-	if (pCount == 0 || texture.get() == nullptr || pMem == nullptr || buffer == nullptr)
-		return;
-
-	gfx->flushBatchedDraws();
-
-	if (Shader::isDefaultActive())
-		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+	rng.setSeed(seed);
+}
 
-	if (Shader::current)
-		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, texture);
+love::math::RandomGenerator::Seed ParticleSystem::getRandomSeed() const
+{
+	return rng.getSeed();
+}
 
+void ParticleSystem::generateVertices(Vertex *pVerts) const
+{
 	const Vector2 *positions = texture->getQuad()->getVertexPositions();
 	const Vector2 *texcoords = texture->getQuad()->getVertexTexCoords();
 
-	Vertex *pVerts = (Vertex *) buffer->map(Buffer::MAP_WRITE_INVALIDATE, 0, buffer->getSize());
-	Particle *p = pHead;
+	const float *posx = fields[FIELD_POSITION_X];
+	const float *posy = fields[FIELD_POSITION_Y];
+	const float *angle = fields[FIELD_ANGLE];
+	const float *size = fields[FIELD_SIZE];
 
 	bool useQuads = !quads.empty();
 
 	Matrix3 t;
 
 	// set the vertex data for each particle (transformation, texcoords, color)
-	while (p)
+	for (uint32 i = 0; i < activeParticles; i++)
 	{
 		if (useQuads)
 		{
-			positions = quads[p->quadIndex]->getVertexPositions();
-			texcoords = quads[p->quadIndex]->getVertexTexCoords();
+			positions = quads[quadIndices[i]]->getVertexPositions();
+			texcoords = quads[quadIndices[i]]->getVertexTexCoords();
 		}
 
 		// particle vertices are image vertices transformed by particle info
-		t.setTransformation(p->position.x, p->position.y, p->angle, p->size, p->size, offset.x, offset.y, 0.0f, 0.0f);
-		t.transformXY(pVerts, positions, 4);
+		t.setTransformation(posx[i], posy[i], angle[i], size[i], size[i], offset.x, offset.y, 0.0f, 0.0f);
+		t.transformXYStrided(pVerts, sizeof(Vertex), positions, sizeof(Vector2), 4);
 
 		// Particle colors are stored as floats (0-1) but vertex colors are
 		// unsigned bytes (0-255).
-		Color32 c = toColor32(p->color);
+		Colorf color(fields[FIELD_COLOR_R][i], fields[FIELD_COLOR_G][i], fields[FIELD_COLOR_B][i], fields[FIELD_COLOR_A][i]);
+		Color32 c = toColor32(color);
 
 		// set the texture coordinate and color data for particle vertices
 		for (int v = 0; v < 4; v++)
@@ -1076,8 +1486,304 @@ void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
 		}
 
 		pVerts += 4;
-		p = p->next;
 	}
+}
+
+void ParticleSystem::prepareDraw()
+{
+	// GPU-simulated vertices are written by the simulation shader.
+	if (texture.get() == nullptr || particleData.empty() || simulationMode == SIMULATION_GPU)
+		return;
+
+	preparedVertices.resize((size_t) activeParticles * 4);
+	generateVertices(preparedVertices.data());
+	verticesPrepared = true;
+}
+
+void ParticleSystem::setSimulationMode(SimulationMode mode)
+{
+	if (mode == simulationMode)
+		return;
+
+	if (mode == SIMULATION_GPU)
+	{
+		auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+		const auto &caps = gfx->getCapabilities();
+
+		if (!caps.features[Graphics::FEATURE_GLSL4] || !caps.features[Graphics::FEATURE_INDIRECT_DRAW])
+			throw love::Exception("GPU particle simulation requires GLSL 4 and indirect draw support.");
+
+		if (!quads.empty())
+			throw love::Exception("Quads cannot be used with GPU-simulated ParticleSystems.");
+
+		if ((maxParticles + 63) / 64 > (uint32) caps.limits[Graphics::LIMIT_THREADGROUPS_X])
+			throw love::Exception("ParticleSystem buffer size is too large for GPU simulation on this system.");
+
+		createGPUBuffers();
+	}
+	else
+		deleteGPUBuffers();
+
+	simulationMode = mode;
+
+	// Particles don't move between the two simulation backends.
+	reset();
+}
+
+ParticleSystem::SimulationMode ParticleSystem::getSimulationMode() const
+{
+	return simulationMode;
+}
+
+void ParticleSystem::createGPUBuffers()
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	auto particleformat = getSimulationParticleFormat();
+
+	Buffer::Settings particlesettings(BUFFERUSAGEFLAG_SHADER_STORAGE, BUFFERDATAUSAGE_STATIC);
+	Buffer::Settings spawnsettings(BUFFERUSAGEFLAG_SHADER_STORAGE, BUFFERDATAUSAGE_DYNAMIC);
+	Buffer::Settings argssettings(BUFFERUSAGEFLAG_SHADER_STORAGE | BUFFERUSAGEFLAG_INDIRECT_ARGUMENTS, BUFFERDATAUSAGE_STATIC);
+	Buffer::Settings vertexsettings(BUFFERUSAGEFLAG_SHADER_STORAGE | BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_STATIC);
+
+	std::vector<Buffer::DataDeclaration> argsformat = {{ "args", DATAFORMAT_UINT32 }};
+
+	// Six unindexed vertices per particle: the quad index buffer is limited
+	// to 16 bit indices.
+	std::vector<Buffer::DataDeclaration> vertexformat = {
+		{ "VertexPosition", DATAFORMAT_FLOAT_VEC2 },
+		{ "VertexTexCoord", DATAFORMAT_FLOAT_VEC2 },
+		{ "VertexColor", DATAFORMAT_UINT32 },
+		{ "padding", DATAFORMAT_UINT32 },
+	};
+
+	const uint32 emptyargs[4] = {0, 1, 0, 0};
+
+	for (int i = 0; i < 2; i++)
+	{
+		gpu.particles[i].set(gfx->newBuffer(particlesettings, particleformat, nullptr, 0, maxParticles), Acquire::NORETAIN);
+		gpu.drawArgs[i].set(gfx->newBuffer(argssettings, argsformat, emptyargs, 0, 4), Acquire::NORETAIN);
+	}
+
+	gpu.spawned.set(gfx->newBuffer(spawnsettings, particleformat, nullptr, 0, maxParticles), Acquire::NORETAIN);
+	gpu.vertices.set(gfx->newBuffer(vertexsettings, vertexformat, nullptr, 0, (size_t) maxParticles * 6), Acquire::NORETAIN);
+
+	VertexAttributes attributes;
+	attributes.set(ATTRIB_POS, DATAFORMAT_FLOAT_VEC2, (uint16) gpu.vertices->getMemberOffset(0), 0);
+	attributes.set(ATTRIB_TEXCOORD, DATAFORMAT_FLOAT_VEC2, (uint16) gpu.vertices->getMemberOffset(1), 0);
+	attributes.set(ATTRIB_COLOR, DATAFORMAT_UNORM8_VEC4, (uint16) gpu.vertices->getMemberOffset(2), 0);
+	attributes.setBufferLayout(0, (uint16) gpu.vertices->getArrayStride());
+
+	gpu.vertexAttributesID = gfx->registerVertexAttributes(attributes);
+	gpu.current = 0;
+	gpu.count = 0;
+}
+
+void ParticleSystem::deleteGPUBuffers()
+{
+	for (int i = 0; i < 2; i++)
+	{
+		gpu.particles[i].set(nullptr);
+		gpu.drawArgs[i].set(nullptr);
+	}
+
+	gpu.spawned.set(nullptr);
+	gpu.vertices.set(nullptr);
+	std::vector<float>().swap(gpu.spawnData);
+	gpu.count = 0;
+}
+
+void ParticleSystem::resetGPUBuffers()
+{
+	const uint32 emptyargs[4] = {0, 1, 0, 0};
+
+	if (gpu.drawArgs[gpu.current].get() != nullptr)
+		gpu.drawArgs[gpu.current]->fill(0, sizeof(emptyargs), emptyargs);
+
+	gpu.count = 0;
+}
+
+void ParticleSystem::updateParticleLifetimes(float dt)
+{
+	float *life = fields[FIELD_LIFE];
+	uint32 count = activeParticles;
+	uint32 dst = 0;
+
+	// The GPU buffers hold everything else, so order doesn't matter here.
+	for (uint32 src = 0; src < count; src++)
+	{
+		float l = life[src] - dt;
+		if (l > 0.0f)
+			life[dst++] = l;
+	}
+
+	activeParticles = dst;
+}
+
+void ParticleSystem::sendSimulationUniforms(Shader *shader, float dt)
+{
+	const Vector2 *positions = texture->getQuad()->getVertexPositions();
+	const Vector2 *texcoords = texture->getQuad()->getVertexTexCoords();
+
+	float quadpositions[8];
+	float quadtexcoords[8];
+	for (int i = 0; i < 4; i++)
+	{
+		quadpositions[i * 2 + 0] = positions[i].x;
+		quadpositions[i * 2 + 1] = positions[i].y;
+		quadtexcoords[i * 2 + 0] = texcoords[i].x;
+		quadtexcoords[i * 2 + 1] = texcoords[i].y;
+	}
+
+	float quadoffset[2] = {offset.x, offset.y};
+
+	sendFloats(shader, "dt", &dt, 1);
+	sendInt(shader, "maxParticles", (int) maxParticles);
+	sendFloats(shader, "sizes", sizes.data(), (int) sizes.size());
+	sendInt(shader, "sizeCount", (int) sizes.size());
+	sendFloats(shader, "colors", (const float *) colors.data(), (int) colors.size());
+	sendInt(shader, "colorCount", (int) colors.size());
+	sendInt(shader, "relativeRotation", relativeRotation ? 1 : 0);
+	sendFloats(shader, "quadPositions", quadpositions, 4);
+	sendFloats(shader, "quadTexCoords", quadtexcoords, 4);
+	sendFloats(shader, "quadOffset", quadoffset, 1);
+}
+
+void ParticleSystem::simulateGPU(float dt, uint32 first)
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+
+	for (int pass = 0; pass < SIMULATION_PASS_MAX_ENUM; pass++)
+	{
+		if (simulationShaders[pass] != nullptr)
+			continue;
+
+		Shader::CompileOptions options;
+		options.debugName = "ParticleSystem simulation";
+		if (pass == SIMULATION_PASS_SPAWN)
+			options.defines["LOVE_PARTICLE_SPAWN"] = "1";
+
+		simulationShaders[pass] = gfx->newComputeShader(simulationShaderCode, options);
+	}
+
+	// Integrate the live particles into the other buffer. A zero dt (from
+	// emit) leaves them in place and only appends the new ones.
+	if (dt != 0.0f)
+	{
+		int src = gpu.current;
+		int dst = 1 - src;
+
+		const uint32 emptyargs[4] = {0, 1, 0, 0};
+		gpu.drawArgs[dst]->fill(0, sizeof(emptyargs), emptyargs);
+
+		if (gpu.count > 0)
+		{
+			Shader *shader = simulationShaders[SIMULATION_PASS_UPDATE];
+			sendSimulationUniforms(shader, dt);
+			sendBuffer(shader, "SourceParticles", gpu.particles[src]);
+			sendBuffer(shader, "SourceArgs", gpu.drawArgs[src]);
+			sendBuffer(shader, "DestParticles", gpu.particles[dst]);
+			sendBuffer(shader, "DestArgs", gpu.drawArgs[dst]);
+			sendBuffer(shader, "ParticleVertices", gpu.vertices);
+
+			gfx->dispatchThreadgroups(shader, (int) ((gpu.count + 63) / 64), 1, 1);
+		}
+
+		gpu.current = dst;
+	}
+
+	uint32 spawncount = activeParticles - first;
+
+	if (spawncount > 0)
+	{
+		const size_t stride = FIELD_MAX_ENUM;
+		gpu.spawnData.resize((size_t) spawncount * stride);
+
+		// Matches the Particle struct in the simulation shader.
+		static const ParticleField order[FIELD_MAX_ENUM] =
+		{
+			FIELD_POSITION_X, FIELD_POSITION_Y, FIELD_VELOCITY_X, FIELD_VELOCITY_Y,
+			FIELD_ORIGIN_X, FIELD_ORIGIN_Y, FIELD_LIFE, FIELD_LIFETIME,
+			FIELD_LINEAR_ACCELERATION_X, FIELD_LINEAR_ACCELERATION_Y, FIELD_RADIAL_ACCELERATION, FIELD_TANGENTIAL_ACCELERATION,
+			FIELD_LINEAR_DAMPING, FIELD_SIZE_OFFSET, FIELD_SIZE_INTERVAL_SIZE, FIELD_SIZE,
+			FIELD_ROTATION, FIELD_ANGLE, FIELD_SPIN_START, FIELD_SPIN_END,
+			FIELD_COLOR_R, FIELD_COLOR_G, FIELD_COLOR_B, FIELD_COLOR_A,
+		};
+
+		for (uint32 i = 0; i < spawncount; i++)
+		{
+			float *dst = gpu.spawnData.data() + i * stride;
+			for (size_t f = 0; f < stride; f++)
+				dst[f] = fields[order[f]][first + i];
+		}
+
+		gpu.spawned->fill(0, sizeof(float) * gpu.spawnData.size(), gpu.spawnData.data());
+
+		Shader *shader = simulationShaders[SIMULATION_PASS_SPAWN];
+		sendSimulationUniforms(shader, 0.0f);
+		sendInt(shader, "sourceCount", (int) spawncount);
+		sendBuffer(shader, "SourceParticles", gpu.spawned);
+		sendBuffer(shader, "DestParticles", gpu.particles[gpu.current]);
+		sendBuffer(shader, "DestArgs", gpu.drawArgs[gpu.current]);
+		sendBuffer(shader, "ParticleVertices", gpu.vertices);
+
+		gfx->dispatchThreadgroups(shader, (int) ((spawncount + 63) / 64), 1, 1);
+	}
+
+	gpu.count = activeParticles;
+}
+
+void ParticleSystem::drawGPU(Graphics *gfx, const Matrix4 &m)
+{
+	gfx->flushBatchedDraws();
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+
+	if (Shader::current)
+		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, texture);
+
+	Graphics::TempTransform transform(gfx, m);
+
+	BufferBindings vertexbuffers;
+	vertexbuffers.set(0, gpu.vertices, 0);
+
+	// The vertex count comes from the number of particles the simulation
+	// shader wrote, so nothing needs to be read back.
+	Graphics::DrawCommand cmd(gpu.vertexAttributesID, &vertexbuffers);
+	cmd.indirectBuffer = gpu.drawArgs[gpu.current];
+	cmd.texture = gfx->getTextureOrDefaultForActiveShader(texture);
+
+	gfx->draw(cmd);
+}
+
+void ParticleSystem::draw(Graphics *gfx, const Matrix4 &m)
+{
+	uint32 pCount = getCount();
+
+	if (pCount == 0 || texture.get() == nullptr || particleData.empty() || buffer == nullptr)
+		return;
+
+	if (simulationMode == SIMULATION_GPU)
+	{
+		drawGPU(gfx, m);
+		return;
+	}
+
+	gfx->flushBatchedDraws();
+
+	if (Shader::isDefaultActive())
+		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+
+	if (Shader::current)
+		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, texture);
+
+	Vertex *pVerts = (Vertex *) buffer->map(Buffer::MAP_WRITE_INVALIDATE, 0, buffer->getSize());
+
+	if (verticesPrepared)
+		memcpy(pVerts, preparedVertices.data(), sizeof(Vertex) * 4 * pCount);
+	else
+		generateVertices(pVerts);
 
 	buffer->unmap(0, pCount * sizeof(Vertex) * 4);
 
@@ -1120,6 +1826,21 @@ std::vector<std::string> ParticleSystem::getConstants(InsertMode)
 	return insertModes.getNames();
 }
 
+bool ParticleSystem::getConstant(const char *in, SimulationMode &out)
+{
+	return simulationModes.find(in, out);
+}
+
+bool ParticleSystem::getConstant(SimulationMode in, const char *&out)
+{
+	return simulationModes.find(in, out);
+}
+
+std::vector<std::string> ParticleSystem::getConstants(SimulationMode)
+{
+	return simulationModes.getNames();
+}
+
 StringMap<ParticleSystem::AreaSpreadDistribution, ParticleSystem::DISTRIBUTION_MAX_ENUM>::Entry ParticleSystem::distributionsEntries[] =
 {
 	{ "none",    DISTRIBUTION_NONE },
@@ -1141,5 +1862,13 @@ StringMap<ParticleSystem::InsertMode, ParticleSystem::INSERT_MODE_MAX_ENUM>::Ent
 
 StringMap<ParticleSystem::InsertMode, ParticleSystem::INSERT_MODE_MAX_ENUM> ParticleSystem::insertModes(ParticleSystem::insertModesEntries, sizeof(ParticleSystem::insertModesEntries));
 
+StringMap<ParticleSystem::SimulationMode, ParticleSystem::SIMULATION_MAX_ENUM>::Entry ParticleSystem::simulationModesEntries[] =
+{
+	{ "cpu", SIMULATION_CPU },
+	{ "gpu", SIMULATION_GPU },
+};
+
+StringMap<ParticleSystem::SimulationMode, ParticleSystem::SIMULATION_MAX_ENUM> ParticleSystem::simulationModes(ParticleSystem::simulationModesEntries, sizeof(ParticleSystem::simulationModesEntries));
+
 } // graphics
 } // love
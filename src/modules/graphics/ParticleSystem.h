@@ -30,6 +30,7 @@
 #include "Quad.h"
 #include "Texture.h"
 #include "Buffer.h"
+#include "math/RandomGenerator.h"
 
 // STL
 #include <vector>
@@ -40,6 +41,7 @@ namespace graphics
 {
 
 class Graphics;
+class Shader;
 
 /**
  * A class for creating, moving and drawing particles.
@@ -76,6 +78,29 @@ class ParticleSystem : public Drawable
 		INSERT_MODE_MAX_ENUM
 	};
 
+	/**
+	 * Where particles are integrated: on the CPU, or by a compute shader.
+	 */
+	enum SimulationMode
+	{
+		SIMULATION_CPU,
+		SIMULATION_GPU,
+		SIMULATION_MAX_ENUM
+	};
+
+	/**
+	 * Compute shader passes used by GPU simulation. Shared by every
+	 * ParticleSystem and released by Graphics.
+	 **/
+	enum SimulationPass
+	{
+		SIMULATION_PASS_UPDATE,
+		SIMULATION_PASS_SPAWN,
+		SIMULATION_PASS_MAX_ENUM
+	};
+
+	static Shader *simulationShaders[SIMULATION_PASS_MAX_ENUM];
+
 	/**
 	 * Maximum numbers of particles in a ParticleSystem.
 	 * This limit comes from the fact that a quad requires four vertices and the
@@ -135,6 +160,21 @@ class ParticleSystem : public Drawable
 	 */
 	InsertMode getInsertMode() const;
 
+	/**
+	 * Sets whether particles are simulated on the CPU or by a compute shader.
+	 * GPU simulation requires GLSL 4 and indirect draw support. New particles
+	 * are still spawned on the CPU, but only they are uploaded each update.
+	 * The draw order of particles is unspecified in GPU mode, and Quads can't
+	 * be used.
+	 * @param mode The new simulation mode.
+	 **/
+	void setSimulationMode(SimulationMode mode);
+
+	/**
+	 * Returns the current simulation mode.
+	 **/
+	SimulationMode getSimulationMode() const;
+
 	/**
 	 * Sets the emission rate.
 	 * @param rate The amount of particles per second.
@@ -510,6 +550,21 @@ class ParticleSystem : public Drawable
 	 **/
 	void update(float dt);
 
+	/**
+	 * Sets the seed of the random generator used when emitting particles. Two
+	 * ParticleSystems with the same settings and seed emit the same particles
+	 * for the same sequence of updates.
+	 **/
+	void setRandomSeed(love::math::RandomGenerator::Seed seed);
+	love::math::RandomGenerator::Seed getRandomSeed() const;
+
+	/**
+	 * Generates the vertices of the current particles ahead of time, so it can
+	 * be done off the main thread. They're used by draw until the particles
+	 * change.
+	 **/
+	void prepareDraw();
+
 	// Implements Drawable.
 	void draw(Graphics *gfx, const Matrix4 &m) override;
 
@@ -521,41 +576,41 @@ class ParticleSystem : public Drawable
 	static bool getConstant(InsertMode in, const char *&out);
 	static std::vector<std::string> getConstants(InsertMode);
 
+	static bool getConstant(const char *in, SimulationMode &out);
+	static bool getConstant(SimulationMode in, const char *&out);
+	static std::vector<std::string> getConstants(SimulationMode);
+
 private:
 
-	// Represents a single particle.
-	struct Particle
+	// Per-particle attributes. Each one is stored in its own array, in the
+	// order particles are drawn.
+	enum ParticleField
 	{
-		Particle *prev;
-		Particle *next;
-
-		float lifetime;
-		float life;
-
-		love::Vector2 position;
-
-		// Particles gravitate towards this point.
-		love::Vector2 origin;
-
-		love::Vector2 velocity;
-		love::Vector2 linearAcceleration;
-		float radialAcceleration;
-		float tangentialAcceleration;
-
-		float linearDamping;
-
-		float size;
-		float sizeOffset;
-		float sizeIntervalSize;
-
-		float rotation; // Amount of rotation applied to the final angle.
-		float angle;
-		float spinStart;
-		float spinEnd;
-
-		Colorf color;
-
-		int quadIndex;
+		FIELD_LIFE,
+		FIELD_LIFETIME,
+		FIELD_POSITION_X,
+		FIELD_POSITION_Y,
+		FIELD_ORIGIN_X, // Particles gravitate towards this point.
+		FIELD_ORIGIN_Y,
+		FIELD_VELOCITY_X,
+		FIELD_VELOCITY_Y,
+		FIELD_LINEAR_ACCELERATION_X,
+		FIELD_LINEAR_ACCELERATION_Y,
+		FIELD_RADIAL_ACCELERATION,
+		FIELD_TANGENTIAL_ACCELERATION,
+		FIELD_LINEAR_DAMPING,
+		FIELD_SIZE,
+		FIELD_SIZE_OFFSET,
+		FIELD_SIZE_INTERVAL_SIZE,
+		FIELD_ROTATION, // Amount of rotation applied to the final angle.
+		FIELD_ANGLE,
+		FIELD_SPIN_START,
+		FIELD_SPIN_END,
+		FIELD_COLOR_R,
+		FIELD_COLOR_G,
+		FIELD_COLOR_B,
+		FIELD_COLOR_A,
+		FIELD_MAX_ENUM
 	};
 
 	void resetOffset();
@@ -564,25 +619,46 @@ class ParticleSystem : public Drawable
 	void deleteBuffers();
 
 	void addParticle(float t);
-	Particle *removeParticle(Particle *p);
+	void initParticle(uint32 index, float t);
+
+	// Moves particles added since 'first' to the front of the draw order, for
+	// INSERT_MODE_BOTTOM.
+	void moveToBottom(uint32 first);
 
-	// Called by addParticle.
-	void initParticle(Particle *p, float t);
-	void insertTop(Particle *p);
-	void insertBottom(Particle *p);
-	void insertRandom(Particle *p);
+	void copyParticle(uint32 dst, uint32 src);
+	void swapParticles(uint32 a, uint32 b);
 
-	// Pointer to the beginning of the allocated memory.
-	Particle *pMem;
+	// Integrates every particle, then compacts the arrays to remove the ones
+	// which have died while preserving the draw order of the rest.
+	void updateParticles(float dt);
+	void updateParticlesScalar(uint32 start, uint32 end, float dt);
+	void updateParticleIntervals(uint32 index, float t);
+	void updateQuadIndexAndAngle(uint32 index, float t);
+	void removeDeadParticles();
 
-	// Pointer to a free particle.
-	Particle *pFree;
+	// Writes the vertices of every active particle, in draw order.
+	void generateVertices(Vertex *vertices) const;
 
-	// Pointer to the start of the linked list.
-	Particle *pHead;
+	void createGPUBuffers();
+	void deleteGPUBuffers();
+	void resetGPUBuffers();
 
-	// Pointer to the end of the linked list.
-	Particle *pTail;
+	// Only particle lifetimes are tracked on the CPU in GPU mode, so the
+	// particle count and emission limits match the CPU path exactly.
+	void updateParticleLifetimes(float dt);
+
+	// Uploads particles added since 'first' and runs the simulation passes.
+	void simulateGPU(float dt, uint32 first);
+	void sendSimulationUniforms(Shader *shader, float dt);
+	void drawGPU(Graphics *gfx, const Matrix4 &m);
+
+	// Backing memory for all particle attribute arrays.
+	std::vector<float> particleData;
+	float *fields[FIELD_MAX_ENUM];
+	std::vector<int> quadIndices;
+
+	// Size of each attribute array: maxParticles rounded up to a multiple of 4.
+	uint32 fieldStride;
 
 	// The texture to be drawn.
 	StrongRef<Texture> texture;
@@ -676,11 +752,41 @@ class ParticleSystem : public Drawable
 	VertexAttributesID vertexAttributesID;
 	Buffer *buffer;
 
+	// Each ParticleSystem has its own generator so systems can be updated in
+	// parallel, and deterministically for a given seed.
+	love::math::RandomGenerator rng;
+
+	std::vector<Vertex> preparedVertices;
+	bool verticesPrepared;
+
+	SimulationMode simulationMode;
+
+	// Resources used by GPU simulation. Particles are double-buffered: each
+	// update reads the live particles from one buffer and writes the
+	// survivors to the other, counting them with atomics in that buffer's
+	// indirect draw arguments.
+	struct GPUSimulation
+	{
+		StrongRef<Buffer> particles[2];
+		StrongRef<Buffer> drawArgs[2];
+		StrongRef<Buffer> spawned;
+		StrongRef<Buffer> vertices;
+		VertexAttributesID vertexAttributesID;
+		int current = 0;
+		uint32 count = 0;
+		std::vector<float> spawnData;
+	};
+
+	GPUSimulation gpu;
+
 	static StringMap<AreaSpreadDistribution, DISTRIBUTION_MAX_ENUM>::Entry distributionsEntries[];
 	static StringMap<AreaSpreadDistribution, DISTRIBUTION_MAX_ENUM> distributions;
 
 	static StringMap<InsertMode, INSERT_MODE_MAX_ENUM>::Entry insertModesEntries[];
 	static StringMap<InsertMode, INSERT_MODE_MAX_ENUM> insertModes;
+
+	static StringMap<SimulationMode, SIMULATION_MAX_ENUM>::Entry simulationModesEntries[];
+	static StringMap<SimulationMode, SIMULATION_MAX_ENUM> simulationModes;
 };
 
 } // graphics
@@ -35,11 +35,11 @@ namespace graphics
 
 void Polyline::render(const Vector2 *coords, size_t count, size_t size_hint, float halfwidth, float pixel_size, bool draw_overdraw)
 {
-	static std::vector<Vector2> anchors;
+	std::vector<Vector2> &anchors = scratch.anchors;
 	anchors.clear();
 	anchors.reserve(size_hint);
 
-	static std::vector<Vector2> normals;
+	std::vector<Vector2> &normals = scratch.normals;
 	normals.clear();
 	normals.reserve(size_hint);
 
@@ -87,7 +87,10 @@ void Polyline::render(const Vector2 *coords, size_t count, size_t size_hint, flo
 	}
 
 	// Use a single linear array for both the regular and overdraw vertices.
-	vertices = new Vector2[vertex_count + extra_vertices + overdraw_vertex_count];
+	size_t total_vertex_count = vertex_count + extra_vertices + overdraw_vertex_count;
+	if (scratch.vertices.size() < total_vertex_count)
+		scratch.vertices.resize(total_vertex_count);
+	vertices = scratch.vertices.data();
 
 	for (size_t i = 0; i < vertex_count; ++i)
 		vertices[i] = anchors[i] + normals[i];
@@ -391,12 +394,6 @@ void NoneJoinPolyline::render_overdraw(const std::vector<Vector2> &/*normals*/,
 	}
 }
 
-Polyline::~Polyline()
-{
-	if (vertices)
-		delete[] vertices;
-}
-
 void Polyline::draw(love::graphics::Graphics *gfx)
 {
 	const Matrix4 &t = gfx->getTransform();
@@ -36,6 +36,17 @@ namespace graphics
 
 class Graphics;
 
+/**
+ * Storage reused by every Polyline drawn with the same Graphics, so drawing
+ * lines doesn't allocate once the arrays are large enough.
+ **/
+struct PolylineScratch
+{
+	std::vector<Vector2> anchors;
+	std::vector<Vector2> normals;
+	std::vector<Vector2> vertices;
+};
+
 /**
  * Abstract base class for a chain of segments.
  * @author Matthias Richter
@@ -44,8 +55,9 @@ class Polyline
 {
 public:
 
-	Polyline(TriangleIndexMode mode = TRIANGLEINDEX_STRIP)
-		: vertices(nullptr)
+	Polyline(PolylineScratch &scratch, TriangleIndexMode mode = TRIANGLEINDEX_STRIP)
+		: scratch(scratch)
+		, vertices(nullptr)
 		, overdraw(nullptr)
 		, vertex_count(0)
 		, overdraw_vertex_count(0)
@@ -53,7 +65,7 @@ class Polyline
 		, overdraw_vertex_start(0)
 	{}
 
-	virtual ~Polyline();
+	virtual ~Polyline() {}
 
 	/**
 	 * @param vertices      Vertices defining the core line segments
@@ -90,6 +102,7 @@ class Polyline
 	                        Vector2 &segment, float &segmentLength, Vector2 &segmentNormal,
 	                        const Vector2 &pointA, const Vector2 &pointB, float halfWidth) = 0;
 
+	PolylineScratch &scratch;
 	Vector2 *vertices;
 	Vector2 *overdraw;
 	size_t vertex_count;
@@ -108,8 +121,8 @@ class NoneJoinPolyline : public Polyline
 {
 public:
 
-	NoneJoinPolyline()
-		: Polyline(TRIANGLEINDEX_QUADS)
+	NoneJoinPolyline(PolylineScratch &scratch)
+		: Polyline(scratch, TRIANGLEINDEX_QUADS)
 	{}
 
 	void render(const Vector2 *vertices, size_t count, float halfwidth, float pixel_size, bool draw_overdraw)
@@ -149,6 +162,10 @@ class MiterJoinPolyline : public Polyline
 {
 public:
 
+	MiterJoinPolyline(PolylineScratch &scratch)
+		: Polyline(scratch)
+	{}
+
 	void render(const Vector2 *vertices, size_t count, float halfwidth, float pixel_size, bool draw_overdraw)
 	{
 		Polyline::render(vertices, count, 2 * count, halfwidth, pixel_size, draw_overdraw);
@@ -171,6 +188,10 @@ class BevelJoinPolyline : public Polyline
 {
 public:
 
+	BevelJoinPolyline(PolylineScratch &scratch)
+		: Polyline(scratch)
+	{}
+
 	void render(const Vector2 *vertices, size_t count, float halfwidth, float pixel_size, bool draw_overdraw)
 	{
 		Polyline::render(vertices, count, 4 * count - 4, halfwidth, pixel_size, draw_overdraw);
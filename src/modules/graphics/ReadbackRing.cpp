@@ -0,0 +1,215 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "ReadbackRing.h"
+#include "Graphics.h"
+#include "Buffer.h"
+#include "Texture.h"
+#include "data/ByteData.h"
+#include "image/ImageData.h"
+#include "thread/Channel.h"
+
+namespace love
+{
+namespace graphics
+{
+
+love::Type ReadbackRing::type("ReadbackRing", &Object::type);
+
+ReadbackRing::ReadbackRing(Graphics *gfx, int size)
+	: gfx(gfx)
+	, nextSlot(0)
+	, nextSequence(0)
+	, droppedCount(0)
+{
+	if (size <= 0)
+		throw love::Exception("ReadbackRing size must be greater than 0.");
+
+	slots.resize(size);
+	gfx->registerReadbackRing(this);
+}
+
+ReadbackRing::~ReadbackRing()
+{
+	auto graphics = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (graphics != nullptr)
+		graphics->unregisterReadbackRing(this);
+}
+
+ReadbackRing::Slot *ReadbackRing::getFreeSlot()
+{
+	update();
+
+	Slot &slot = slots[nextSlot];
+
+	// The oldest readback is still in flight, so every slot is in use.
+	if (slot.readback.get() != nullptr)
+		return nullptr;
+
+	if (slot.hasData)
+	{
+		droppedCount++;
+		slot.hasData = false;
+	}
+
+	nextSlot = (nextSlot + 1) % slots.size();
+	return &slot;
+}
+
+bool ReadbackRing::readbackBuffer(Buffer *buffer, size_t offset, size_t size)
+{
+	Slot *slot = getFreeSlot();
+	if (slot == nullptr)
+		return false;
+
+	love::data::ByteData *dest = nullptr;
+	if (slot->bufferData.get() != nullptr && slot->bufferData->getSize() == size)
+		dest = slot->bufferData;
+
+	slot->readback.set(gfx->readbackBufferAsync(buffer, offset, size, dest, 0), Acquire::NORETAIN);
+	slot->isTexture = false;
+	slot->sequence = nextSequence++;
+	return true;
+}
+
+bool ReadbackRing::readbackTexture(Texture *texture, int slice, int mipmap, const Rect &rect)
+{
+	Slot *slot = getFreeSlot();
+	if (slot == nullptr)
+		return false;
+
+	love::image::ImageData *dest = nullptr;
+	love::image::ImageData *prev = slot->imageData;
+
+	if (prev != nullptr && prev->getWidth() == rect.w && prev->getHeight() == rect.h
+		&& getLinearPixelFormat(prev->getFormat()) == getLinearPixelFormat(texture->getPixelFormat()))
+	{
+		dest = prev;
+	}
+
+	slot->readback.set(gfx->readbackTextureAsync(texture, slice, mipmap, rect, dest, 0, 0), Acquire::NORETAIN);
+	slot->isTexture = true;
+	slot->sequence = nextSequence++;
+	return true;
+}
+
+void ReadbackRing::finishSlot(Slot &slot)
+{
+	GraphicsReadback *readback = slot.readback;
+
+	if (!readback->hasError())
+	{
+		if (slot.isTexture)
+			slot.imageData.set(readback->getImageData());
+		else
+			slot.bufferData.set(readback->getBufferData());
+
+		slot.hasData = true;
+	}
+
+	slot.readback.set(nullptr);
+}
+
+void ReadbackRing::update()
+{
+	for (Slot &slot : slots)
+	{
+		if (slot.readback.get() != nullptr && slot.readback->isComplete())
+			finishSlot(slot);
+	}
+
+	if (channel.get() == nullptr)
+		return;
+
+	// The slot can't reuse data which other threads might be reading, so it
+	// lets go of it here and gets a new destination for its next readback.
+	while (Slot *slot = popSlot())
+	{
+		if (slot->isTexture)
+		{
+			channel->push(Variant(&love::image::ImageData::type, slot->imageData.get()));
+			slot->imageData.set(nullptr);
+		}
+		else
+		{
+			channel->push(Variant(&love::data::ByteData::type, slot->bufferData.get()));
+			slot->bufferData.set(nullptr);
+		}
+	}
+}
+
+ReadbackRing::Slot *ReadbackRing::popSlot()
+{
+	Slot *oldest = nullptr;
+
+	for (Slot &slot : slots)
+	{
+		if (slot.hasData && (oldest == nullptr || slot.sequence < oldest->sequence))
+			oldest = &slot;
+	}
+
+	if (oldest != nullptr)
+		oldest->hasData = false;
+
+	return oldest;
+}
+
+Data *ReadbackRing::pop(love::Type *&datatype)
+{
+	Slot *slot = popSlot();
+	if (slot == nullptr)
+		return nullptr;
+
+	if (slot->isTexture)
+	{
+		datatype = &love::image::ImageData::type;
+		return slot->imageData;
+	}
+	else
+	{
+		datatype = &love::data::ByteData::type;
+		return slot->bufferData;
+	}
+}
+
+void ReadbackRing::setChannel(love::thread::Channel *channel)
+{
+	this->channel.set(channel);
+}
+
+love::thread::Channel *ReadbackRing::getChannel() const
+{
+	return channel;
+}
+
+int ReadbackRing::getPendingCount() const
+{
+	int count = 0;
+	for (const Slot &slot : slots)
+	{
+		if (slot.readback.get() != nullptr)
+			count++;
+	}
+	return count;
+}
+
+} // graphics
+} // love
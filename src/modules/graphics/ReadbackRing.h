@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+#pragma once
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "common/math.h"
+#include "common/int.h"
+#include "GraphicsReadback.h"
+#include "data/ByteData.h"
+#include "image/ImageData.h"
+
+// C++
+#include <vector>
+
+namespace love
+{
+
+class Data;
+
+namespace thread
+{
+class Channel;
+}
+
+namespace graphics
+{
+
+/**
+ * A fixed number of reusable asynchronous readback slots, for code which reads
+ * back GPU data every frame. Each slot keeps its destination ByteData or
+ * ImageData and reuses it for later readbacks of the same size, so steady-state
+ * use doesn't allocate new destinations. Completed readbacks are returned in
+ * the order they were started, either via pop or by being pushed to a Channel.
+ * Graphics calls update every time a frame is presented.
+ **/
+class ReadbackRing : public Object
+{
+public:
+
+	static love::Type type;
+
+	ReadbackRing(Graphics *gfx, int size);
+	virtual ~ReadbackRing();
+
+	/**
+	 * Starts an asynchronous readback in the next slot. Returns false if all
+	 * slots are still waiting for earlier readbacks to complete. Completed data
+	 * which hasn't been popped yet is discarded when its slot is reused.
+	 **/
+	bool readbackBuffer(Buffer *buffer, size_t offset, size_t size);
+	bool readbackTexture(Texture *texture, int slice, int mipmap, const Rect &rect);
+
+	/**
+	 * Returns the data of the oldest completed readback which hasn't been
+	 * returned yet, or null. The data belongs to its slot and is overwritten
+	 * when the slot is reused, size readbacks later.
+	 **/
+	Data *pop(love::Type *&datatype);
+
+	/**
+	 * When a Channel is set, completed data is pushed to it instead of being
+	 * returned by pop. The slot gives up data it pushes, since other threads
+	 * may use it, and allocates a new destination for its next readback.
+	 **/
+	void setChannel(love::thread::Channel *channel);
+	love::thread::Channel *getChannel() const;
+
+	int getSize() const { return (int) slots.size(); }
+	int getPendingCount() const;
+	int getDroppedCount() const { return droppedCount; }
+
+	/**
+	 * Collects completed readbacks, and pushes them to the Channel if one is
+	 * set. Called automatically when a frame is presented, but can be called
+	 * earlier to get results without waiting for the end of the frame.
+	 **/
+	void update();
+
+private:
+
+	struct Slot
+	{
+		StrongRef<GraphicsReadback> readback;
+		StrongRef<love::data::ByteData> bufferData;
+		StrongRef<love::image::ImageData> imageData;
+		bool isTexture = false;
+		bool hasData = false;
+		uint64 sequence = 0;
+	};
+
+	Slot *getFreeSlot();
+	Slot *popSlot();
+	void finishSlot(Slot &slot);
+
+	Graphics *gfx;
+
+	std::vector<Slot> slots;
+	size_t nextSlot;
+	uint64 nextSequence;
+	int droppedCount;
+
+	StrongRef<love::thread::Channel> channel;
+
+}; // ReadbackRing
+
+} // graphics
+} // love
@@ -815,6 +815,13 @@ void Shader::setVideoTextures(love::graphics::Texture *ytexture, love::graphics:
 	}
 }
 
+void Shader::setBatchTextures(love::graphics::Texture **textures, int count)
+{
+	const UniformInfo *info = getUniformInfo(BUILTIN_TEXTURE_BATCH);
+	if (info != nullptr)
+		sendTextures(info, textures, count, true);
+}
+
 void Shader::sendTextures(const UniformInfo *info, Texture **textures, int count)
 {
 	Shader::sendTextures(info, textures, count, false);
@@ -1789,6 +1796,84 @@ void effect()
 }
 )";
 
+// Texture indices come from a separate vertex stream at location 3, which
+// Graphics::flushBatchedDraws sets up for multi-texture batches.
+static const std::string defaultMultiTextureVertex = R"(
+layout (location = 0) in vec4 VertexPosition;
+layout (location = 1) in vec4 VertexTexCoord;
+layout (location = 2) in vec4 VertexColor;
+layout (location = 3) in float VertexTextureIndex;
+
+out vec4 VaryingTexCoord;
+out vec4 VaryingColor;
+flat out int VaryingTextureIndex;
+
+void vertexmain()
+{
+	VaryingTexCoord = VertexTexCoord;
+	VaryingColor = gammaCorrectColor(VertexColor) * ConstantColor;
+	VaryingTextureIndex = int(VertexTextureIndex);
+	love_Position = ClipSpaceFromLocal * VertexPosition;
+}
+)";
+
+// Sampler arrays can only be indexed with constant expressions in GLSL 3, so
+// each texture index gets its own branch. The index is flat per primitive.
+static const std::string defaultMultiTexturePixel = R"(
+uniform Image MainTex;
+uniform Image love_BatchTextures[7];
+flat in int VaryingTextureIndex;
+
+vec4 love_batchTexel(int index, vec2 uv)
+{
+	if (index == 0) return Texel(MainTex, uv);
+	else if (index == 1) return Texel(love_BatchTextures[0], uv);
+	else if (index == 2) return Texel(love_BatchTextures[1], uv);
+	else if (index == 3) return Texel(love_BatchTextures[2], uv);
+	else if (index == 4) return Texel(love_BatchTextures[3], uv);
+	else if (index == 5) return Texel(love_BatchTextures[4], uv);
+	else if (index == 6) return Texel(love_BatchTextures[5], uv);
+	else return Texel(love_BatchTextures[6], uv);
+}
+
+void effect()
+{
+	love_PixelColor = love_batchTexel(VaryingTextureIndex, VaryingTexCoord.st) * VaryingColor;
+}
+)";
+
+// Instanced SpriteBatches draw a unit quad per sprite. Each instance has the
+// sprite's transformed quad axes and origin (plus array layer), and its
+// texture coordinate rectangle.
+static const std::string defaultInstancedVertex = R"(
+layout (location = 0) in vec4 VertexPosition;
+layout (location = 2) in vec4 VertexColor;
+layout (location = 3) in vec4 InstanceAxes;
+layout (location = 4) in vec3 InstanceOrigin;
+layout (location = 5) in vec4 InstanceTexRect;
+
+out vec4 VaryingTexCoord;
+out vec4 VaryingColor;
+
+void vertexmain()
+{
+	vec2 corner = VertexPosition.xy;
+	vec2 position = InstanceOrigin.xy + InstanceAxes.xy * corner.x + InstanceAxes.zw * corner.y;
+
+	VaryingTexCoord = vec4(mix(InstanceTexRect.xy, InstanceTexRect.zw, corner), InstanceOrigin.z, 0.0);
+	VaryingColor = gammaCorrectColor(VertexColor) * ConstantColor;
+	love_Position = ClipSpaceFromLocal * vec4(position, 0.0, 1.0);
+}
+)";
+
+static const std::string defaultInstancedPixel = R"(
+uniform Image MainTex;
+void effect()
+{
+	love_PixelColor = Texel(MainTex, VaryingTexCoord.st) * VaryingColor;
+}
+)";
+
 static const std::string defaultArrayPixel = R"(
 uniform ArrayImage MainTex;
 void effect()
@@ -1797,12 +1882,29 @@ void effect()
 }
 )";
 
+// Signed distance field glyphs store the distance to the glyph's edge in the
+// alpha channel, with 0.5 on the edge. The edge is antialiased over about one
+// screen pixel, whatever scale the text is drawn at.
+static const std::string defaultSDFTextPixel = R"(
+vec4 effect(vec4 vcolor, Image tex, vec2 texcoord, vec2 pixcoord)
+{
+	float dist = Texel(tex, texcoord).a;
+	float width = max(fwidth(dist) * 0.5, 0.0001);
+	float alpha = smoothstep(0.5 - width, 0.5 + width, dist);
+	return vec4(vcolor.rgb, vcolor.a * alpha);
+}
+)";
+
 const std::string &Shader::getDefaultCode(StandardShader shader, ShaderStageType stage)
 {
 	if (stage == SHADERSTAGE_VERTEX)
 	{
 		if (shader == STANDARD_POINTS)
 			return defaultPointsVertex;
+		else if (shader == STANDARD_MULTITEXTURE)
+			return defaultMultiTextureVertex;
+		else if (shader == STANDARD_INSTANCED || shader == STANDARD_INSTANCED_ARRAY)
+			return defaultInstancedVertex;
 		else
 			return defaultVertex;
 	}
@@ -1815,6 +1917,10 @@ const std::string &Shader::getDefaultCode(StandardShader shader, ShaderStageType
 		case STANDARD_VIDEO: return defaultVideoPixel;
 		case STANDARD_ARRAY: return defaultArrayPixel;
 		case STANDARD_POINTS: return defaultStandardPixel;
+		case STANDARD_MULTITEXTURE: return defaultMultiTexturePixel;
+		case STANDARD_INSTANCED: return defaultInstancedPixel;
+		case STANDARD_INSTANCED_ARRAY: return defaultArrayPixel;
+		case STANDARD_SDF_TEXT: return defaultSDFTextPixel;
 		case STANDARD_MAX_ENUM: return nocode;
 	}
 
@@ -1835,6 +1941,7 @@ static StringMap<Shader::BuiltinUniform, Shader::BUILTIN_MAX_ENUM>::Entry builti
 	{ "love_VideoYChannel",    Shader::BUILTIN_TEXTURE_VIDEO_Y   },
 	{ "love_VideoCbChannel",   Shader::BUILTIN_TEXTURE_VIDEO_CB  },
 	{ "love_VideoCrChannel",   Shader::BUILTIN_TEXTURE_VIDEO_CR  },
+	{ "love_BatchTextures",    Shader::BUILTIN_TEXTURE_BATCH     },
 	{ "love_UniformsPerDraw",  Shader::BUILTIN_UNIFORMS_PER_DRAW },
 };
 
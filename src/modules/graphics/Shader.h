@@ -63,6 +63,7 @@ class Shader : public Object, public Resource
 		BUILTIN_TEXTURE_VIDEO_Y,
 		BUILTIN_TEXTURE_VIDEO_CB,
 		BUILTIN_TEXTURE_VIDEO_CR,
+		BUILTIN_TEXTURE_BATCH,
 		BUILTIN_UNIFORMS_PER_DRAW,
 		BUILTIN_MAX_ENUM
 	};
@@ -89,6 +90,10 @@ class Shader : public Object, public Resource
 		STANDARD_VIDEO,
 		STANDARD_ARRAY,
 		STANDARD_POINTS,
+		STANDARD_MULTITEXTURE,
+		STANDARD_INSTANCED,
+		STANDARD_INSTANCED_ARRAY,
+		STANDARD_SDF_TEXT,
 		STANDARD_MAX_ENUM
 	};
 
@@ -259,6 +264,12 @@ class Shader : public Object, public Resource
 	 **/
 	void setVideoTextures(Texture *ytexture, Texture *cbtexture, Texture *crtexture);
 
+	/**
+	 * Sets the extra textures used by multi-texture batches, for texture
+	 * indices 1 and up (index 0 is the main texture). For internal use only.
+	 **/
+	void setBatchTextures(Texture **textures, int count);
+
 	const UniformInfo *getMainTextureInfo() const;
 	void validateDrawState(PrimitiveType primtype, Texture *maintexture) const;
 
@@ -30,12 +30,21 @@ namespace love
 namespace graphics
 {
 
-ShaderStage::ShaderStage(Graphics */*gfx*/, ShaderStageType stage, const std::string &glsl, bool gles, const std::string &cachekey)
+ShaderStage::ShaderStage(Graphics *gfx, ShaderStageType stage, const std::string &glsl, bool gles, const std::string &cachekey)
 	: stageType(stage)
 	, source(glsl)
 	, cacheKey(cachekey)
 	, glslangValidationShader(nullptr)
 {
+	// newShaderAsync may have already parsed this exact code on a worker
+	// thread.
+	if (gfx != nullptr)
+	{
+		glslangValidationShader = gfx->takePrevalidatedShaderStage(stage, glsl);
+		if (glslangValidationShader != nullptr)
+			return;
+	}
+
 	EShLanguage glslangStage = EShLangCount;
 	if (stage == SHADERSTAGE_VERTEX)
 		glslangStage = EShLangVertex;
@@ -86,6 +95,13 @@ ShaderStage::~ShaderStage()
 	delete glslangValidationShader;
 }
 
+glslang::TShader *ShaderStage::releaseGLSLangValidationShader()
+{
+	glslang::TShader *shader = glslangValidationShader;
+	glslangValidationShader = nullptr;
+	return shader;
+}
+
 bool ShaderStage::getConstant(const char *in, ShaderStageType &out)
 {
 	return stageNames.find(in, out);
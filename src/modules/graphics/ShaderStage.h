@@ -70,6 +70,11 @@ class ShaderStage : public love::Object
 	const std::string &getWarnings() const { return warnings; }
 	glslang::TShader *getGLSLangValidationShader() const { return glslangValidationShader; }
 
+	/**
+	 * Transfers ownership of the glslang validation shader to the caller.
+	 **/
+	glslang::TShader *releaseGLSLangValidationShader();
+
 	static bool getConstant(const char *in, ShaderStageType &out);
 	static bool getConstant(ShaderStageType in, const char *&out);
 	static const char *getConstant(ShaderStageType in);
@@ -40,12 +40,119 @@ namespace graphics
 
 love::Type SpriteBatch::type("SpriteBatch", &Drawable::type);
 
-SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUsage usage)
+// Per-instance attributes of instanced SpriteBatches, at the binding locations
+// the instanced standard vertex shader declares them with.
+static const struct
+{
+	const char *name;
+	DataFormat format;
+	int location;
+} instanceAttributes[] =
+{
+	{ "InstanceAxes", DATAFORMAT_FLOAT_VEC4, 3 },
+	{ "InstanceOrigin", DATAFORMAT_FLOAT_VEC3, 4 },
+	{ "InstanceTexRect", DATAFORMAT_FLOAT_VEC4, 5 },
+};
+
+// Equivalent to Matrix4::setTransformation (without shearing) followed by
+// transformXY, but without building a matrix per sprite. The layer is only
+// written for array texture vertices.
+template <typename Vertex>
+struct VerticesPerSprite { static const int count = 4; };
+
+template <>
+struct VerticesPerSprite<SpriteBatch::SpriteInstance> { static const int count = 1; };
+
+static inline void transformSprite(XYf_STf_RGBAub *verts, const SpriteBatch::SpriteTransform &t, const Quad *quad, Color32 color)
+{
+	const Vector2 *positions = quad->getVertexPositions();
+	const Vector2 *texcoords = quad->getVertexTexCoords();
+
+	float c = cosf(t.angle);
+	float s = sinf(t.angle);
+
+	for (int i = 0; i < 4; i++)
+	{
+		float px = (positions[i].x - t.ox) * t.sx;
+		float py = (positions[i].y - t.oy) * t.sy;
+
+		verts[i].x = t.x + c * px - s * py;
+		verts[i].y = t.y + s * px + c * py;
+		verts[i].s = texcoords[i].x;
+		verts[i].t = texcoords[i].y;
+		verts[i].color = color;
+	}
+}
+
+static inline void transformSprite(XYf_STPf_RGBAub *verts, const SpriteBatch::SpriteTransform &t, const Quad *quad, Color32 color)
+{
+	const Vector2 *positions = quad->getVertexPositions();
+	const Vector2 *texcoords = quad->getVertexTexCoords();
+
+	float c = cosf(t.angle);
+	float s = sinf(t.angle);
+	float layer = (float) quad->getLayer();
+
+	for (int i = 0; i < 4; i++)
+	{
+		float px = (positions[i].x - t.ox) * t.sx;
+		float py = (positions[i].y - t.oy) * t.sy;
+
+		verts[i].x = t.x + c * px - s * py;
+		verts[i].y = t.y + s * px + c * py;
+		verts[i].s = texcoords[i].x;
+		verts[i].t = texcoords[i].y;
+		verts[i].p = layer;
+		verts[i].color = color;
+	}
+}
+
+static inline void transformSprite(SpriteBatch::SpriteInstance *instance, const SpriteBatch::SpriteTransform &t, const Quad *quad, Color32 color)
+{
+	const Vector2 *positions = quad->getVertexPositions();
+	const Vector2 *texcoords = quad->getVertexTexCoords();
+
+	float c = cosf(t.angle);
+	float s = sinf(t.angle);
+
+	float px = (positions[0].x - t.ox) * t.sx;
+	float py = (positions[0].y - t.oy) * t.sy;
+	float w = (positions[3].x - positions[0].x) * t.sx;
+	float h = (positions[3].y - positions[0].y) * t.sy;
+
+	instance->axes[0] = c * w;
+	instance->axes[1] = s * w;
+	instance->axes[2] = -s * h;
+	instance->axes[3] = c * h;
+	instance->origin[0] = t.x + c * px - s * py;
+	instance->origin[1] = t.y + s * px + c * py;
+	instance->origin[2] = (float) quad->getLayer();
+	instance->texRect[0] = texcoords[0].x;
+	instance->texRect[1] = texcoords[0].y;
+	instance->texRect[2] = texcoords[3].x;
+	instance->texRect[3] = texcoords[3].y;
+	instance->color = color;
+}
+
+template <typename Vertex>
+static void transformSprites(Vertex *verts, const SpriteBatch::SpriteTransform *sprites, int count, Quad *texturequad, const std::vector<Quad *> &quads, Color32 color)
+{
+	for (int i = 0; i < count; i++)
+	{
+		int quadindex = (int) sprites[i].quad;
+		const Quad *quad = quadindex > 0 ? quads[quadindex - 1] : texturequad;
+
+		transformSprite(verts + i * VerticesPerSprite<Vertex>::count, sprites[i], quad, color);
+	}
+}
+
+SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUsage usage, bool instanced)
 	: texture(texture)
 	, size(size)
 	, next(0)
 	, color(255, 255, 255, 255)
 	, colorf(1.0f, 1.0f, 1.0f, 1.0f)
+	, instanced(instanced)
 	, attributesID()
 	, array_buf(nullptr)
 	, vertex_data(nullptr)
@@ -65,8 +172,9 @@ SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUs
 		vertex_format = CommonFormat::XYf_STf_RGBAub;
 
 	vertex_stride = getFormatStride(vertex_format);
+	sprite_stride = instanced ? sizeof(SpriteInstance) : vertex_stride * 4;
 
-	size_t vertex_size = vertex_stride * 4 * size;
+	size_t vertex_size = sprite_stride * size;
 
 	vertex_data = (uint8 *) malloc(vertex_size);
 	if (vertex_data == nullptr)
@@ -75,9 +183,20 @@ SpriteBatch::SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUs
 	memset(vertex_data, 0, vertex_size);
 
 	Buffer::Settings settings(BUFFERUSAGEFLAG_VERTEX, usage);
-	auto decl = Buffer::getCommonFormatDeclaration(vertex_format);
+	auto decl = getBufferFormat();
 
 	array_buf.set(gfx->newBuffer(settings, decl, nullptr, vertex_size, 0), Acquire::NORETAIN);
+
+	if (instanced)
+	{
+		// Same corner order as Quad vertices.
+		const float corners[] = {0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f, 1.0f};
+
+		Buffer::Settings quadsettings(BUFFERUSAGEFLAG_VERTEX, BUFFERDATAUSAGE_STATIC);
+		auto quaddecl = Buffer::getCommonFormatDeclaration(CommonFormat::XYf);
+
+		quad_buf.set(gfx->newBuffer(quadsettings, quaddecl, corners, sizeof(corners), 0), Acquire::NORETAIN);
+	}
 }
 
 SpriteBatch::~SpriteBatch()
@@ -101,21 +220,26 @@ int SpriteBatch::add(Quad *quad, const Matrix4 &m, int index /*= -1*/)
 	if (index == -1 && next >= size)
 		setBufferSize(size * 2);
 
-	const Vector2 *quadpositions = quad->getVertexPositions();
-	const Vector2 *quadtexcoords = quad->getVertexTexCoords();
-
 	int spriteindex = (index == -1 ? next : index);
 
-	size_t offset = spriteindex * vertex_stride * 4;
-	auto verts = (XYf_STf_RGBAub *) (vertex_data + offset);
+	if (instanced)
+		writeInstance(spriteindex, 0, quad, m);
+	else
+	{
+		const Vector2 *quadpositions = quad->getVertexPositions();
+		const Vector2 *quadtexcoords = quad->getVertexTexCoords();
 
-	m.transformXY(verts, quadpositions, 4);
+		size_t offset = spriteindex * sprite_stride;
+		auto verts = (XYf_STf_RGBAub *) (vertex_data + offset);
 
-	for (int i = 0; i < 4; i++)
-	{
-		verts[i].s = quadtexcoords[i].x;
-		verts[i].t = quadtexcoords[i].y;
-		verts[i].color = color;
+		m.transformXYStrided(verts, sizeof(XYf_STf_RGBAub), quadpositions, sizeof(Vector2), 4);
+
+		for (int i = 0; i < 4; i++)
+		{
+			verts[i].s = quadtexcoords[i].x;
+			verts[i].t = quadtexcoords[i].y;
+			verts[i].color = color;
+		}
 	}
 
 	modified_sprites.encapsulate(spriteindex);
@@ -146,22 +270,27 @@ int SpriteBatch::addLayer(int layer, Quad *quad, const Matrix4 &m, int index)
 	if (index == -1 && next >= size)
 		setBufferSize(size * 2);
 
-	const Vector2 *quadpositions = quad->getVertexPositions();
-	const Vector2 *quadtexcoords = quad->getVertexTexCoords();
-
 	int spriteindex = (index == -1 ? next : index);
 
-	size_t offset = spriteindex * vertex_stride * 4;
-	auto verts = (XYf_STPf_RGBAub *) (vertex_data + offset);
+	if (instanced)
+		writeInstance(spriteindex, layer, quad, m);
+	else
+	{
+		const Vector2 *quadpositions = quad->getVertexPositions();
+		const Vector2 *quadtexcoords = quad->getVertexTexCoords();
 
-	m.transformXY(verts, quadpositions, 4);
+		size_t offset = spriteindex * sprite_stride;
+		auto verts = (XYf_STPf_RGBAub *) (vertex_data + offset);
 
-	for (int i = 0; i < 4; i++)
-	{
-		verts[i].s = quadtexcoords[i].x;
-		verts[i].t = quadtexcoords[i].y;
-		verts[i].p = (float) layer;
-		verts[i].color = color;
+		m.transformXYStrided(verts, sizeof(XYf_STPf_RGBAub), quadpositions, sizeof(Vector2), 4);
+
+		for (int i = 0; i < 4; i++)
+		{
+			verts[i].s = quadtexcoords[i].x;
+			verts[i].t = quadtexcoords[i].y;
+			verts[i].p = (float) layer;
+			verts[i].color = color;
+		}
 	}
 
 	modified_sprites.encapsulate(spriteindex);
@@ -173,6 +302,95 @@ int SpriteBatch::addLayer(int layer, Quad *quad, const Matrix4 &m, int index)
 	return index;
 }
 
+void SpriteBatch::writeInstance(int index, int layer, const Quad *quad, const Matrix4 &m)
+{
+	const Vector2 *quadpositions = quad->getVertexPositions();
+	const Vector2 *quadtexcoords = quad->getVertexTexCoords();
+
+	// Quad vertices are (0,0), (0,h), (w,0), (w,h), so the first three are
+	// enough to get the transformed origin and axes.
+	Vector2 corners[3];
+	m.transformXY(corners, quadpositions, 3);
+
+	auto instance = (SpriteInstance *) (vertex_data + index * sprite_stride);
+
+	instance->axes[0] = corners[2].x - corners[0].x;
+	instance->axes[1] = corners[2].y - corners[0].y;
+	instance->axes[2] = corners[1].x - corners[0].x;
+	instance->axes[3] = corners[1].y - corners[0].y;
+	instance->origin[0] = corners[0].x;
+	instance->origin[1] = corners[0].y;
+	instance->origin[2] = (float) layer;
+	instance->texRect[0] = quadtexcoords[0].x;
+	instance->texRect[1] = quadtexcoords[0].y;
+	instance->texRect[2] = quadtexcoords[3].x;
+	instance->texRect[3] = quadtexcoords[3].y;
+	instance->color = color;
+}
+
+int SpriteBatch::addMany(const SpriteTransform *sprites, int count, const std::vector<Quad *> &quads)
+{
+	if (count < 0)
+		throw love::Exception("Invalid sprite count: %d", count);
+
+	if (next + count > size)
+		setBufferSize(std::max(size * 2, next + count));
+
+	int first = next;
+	writeSprites(first, sprites, count, quads);
+	next += count;
+
+	return first;
+}
+
+void SpriteBatch::setMany(int index, const SpriteTransform *sprites, int count, const std::vector<Quad *> &quads)
+{
+	if (count < 0)
+		throw love::Exception("Invalid sprite count: %d", count);
+
+	if (index < 0 || index + count > size)
+		throw love::Exception("Invalid sprite range: %d to %d", index + 1, index + count);
+
+	writeSprites(index, sprites, count, quads);
+}
+
+void SpriteBatch::writeSprites(int index, const SpriteTransform *sprites, int count, const std::vector<Quad *> &quads)
+{
+	if (count == 0)
+		return;
+
+	bool arraytexture = vertex_format == CommonFormat::XYf_STPf_RGBAub;
+	Quad *texturequad = texture->getQuad();
+
+	// Validate everything up front, so an error doesn't leave some of the
+	// sprites half-written.
+	for (int i = 0; i < count; i++)
+	{
+		int quadindex = (int) sprites[i].quad;
+		if (quadindex < 0 || quadindex > (int) quads.size())
+			throw love::Exception("Invalid quad index %d for sprite %d (%d quads given)", quadindex, index + i + 1, (int) quads.size());
+
+		if (arraytexture)
+		{
+			const Quad *quad = quadindex > 0 ? quads[quadindex - 1] : texturequad;
+			int layer = quad->getLayer();
+			if (layer < 0 || layer >= texture->getLayerCount())
+				throw love::Exception("Invalid layer: %d (Texture has %d layers)", layer + 1, texture->getLayerCount());
+		}
+	}
+
+	uint8 *data = vertex_data + index * sprite_stride;
+
+	if (instanced)
+		transformSprites((SpriteInstance *) data, sprites, count, texturequad, quads, color);
+	else if (arraytexture)
+		transformSprites((XYf_STPf_RGBAub *) data, sprites, count, texturequad, quads, color);
+	else
+		transformSprites((XYf_STf_RGBAub *) data, sprites, count, texturequad, quads, color);
+
+	modified_sprites.encapsulate(index, count);
+}
+
 void SpriteBatch::clear()
 {
 	// Reset the position of the next index.
@@ -183,8 +401,10 @@ void SpriteBatch::flush()
 {
 	if (modified_sprites.isValid())
 	{
-		size_t offset = modified_sprites.getOffset() * vertex_stride * 4;
-		size_t size = modified_sprites.getSize() * vertex_stride * 4;
+		Graphics::ScopedTiming timing(Module::getInstance<Graphics>(Module::M_GRAPHICS), "uploadBuffer");
+
+		size_t offset = modified_sprites.getOffset() * sprite_stride;
+		size_t size = modified_sprites.getSize() * sprite_stride;
 
 		if (array_buf->getDataUsage() == BUFFERDATAUSAGE_STREAM)
 			array_buf->fill(0, array_buf->getSize(), vertex_data);
@@ -236,7 +456,7 @@ void SpriteBatch::setBufferSize(int newsize)
 	if (newsize == size)
 		return;
 
-	size_t vertex_size = vertex_stride * 4 * newsize;
+	size_t vertex_size = sprite_stride * newsize;
 
 	int new_next = std::min(next, newsize);
 
@@ -246,11 +466,11 @@ void SpriteBatch::setBufferSize(int newsize)
 
 	auto gfx = Module::getInstance<graphics::Graphics>(Module::M_GRAPHICS);
 	Buffer::Settings settings(array_buf->getUsageFlags(), array_buf->getDataUsage());
-	auto decl = Buffer::getCommonFormatDeclaration(vertex_format);
+	auto decl = getBufferFormat();
 
 	array_buf.set(gfx->newBuffer(settings, decl, nullptr, vertex_size, 0), Acquire::NORETAIN);
 
-	array_buf->fill(0, vertex_stride * 4 * new_next, new_vertex_data);
+	array_buf->fill(0, sprite_stride * new_next, new_vertex_data);
 
 	vertex_data = (uint8 *) new_vertex_data;
 
@@ -263,11 +483,31 @@ int SpriteBatch::getBufferSize() const
 	return size;
 }
 
+bool SpriteBatch::isInstanced() const
+{
+	return instanced;
+}
+
+std::vector<Buffer::DataDeclaration> SpriteBatch::getBufferFormat() const
+{
+	if (!instanced)
+		return Buffer::getCommonFormatDeclaration(vertex_format);
+
+	std::vector<Buffer::DataDeclaration> format;
+	for (const auto &attrib : instanceAttributes)
+		format.emplace_back(attrib.name, attrib.format, 0, attrib.location);
+	format.emplace_back(getConstant(ATTRIB_COLOR), DATAFORMAT_UNORM8_VEC4, 0, ATTRIB_COLOR);
+	return format;
+}
+
 void SpriteBatch::attachAttribute(const std::string &name, Buffer *buffer, Mesh *mesh)
 {
 	if ((buffer->getUsageFlags() & BUFFERUSAGEFLAG_VERTEX) == 0)
 		throw love::Exception("GraphicsBuffer must be created with vertex buffer support to be used as a SpriteBatch vertex attribute.");
 
+	if (instanced)
+		throw love::Exception("Vertex attributes cannot be attached to an instanced SpriteBatch.");
+
 	AttachedAttribute oldattrib = {};
 	AttachedAttribute newattrib = {};
 
@@ -326,6 +566,23 @@ void SpriteBatch::updateVertexAttributes(Graphics *gfx)
 	VertexAttributes attributes;
 	BufferBindings &buffers = bufferBindings;
 
+	if (instanced)
+	{
+		buffers.set(0, quad_buf, 0);
+		attributes.setCommonFormat(CommonFormat::XYf, 0);
+
+		buffers.set(1, array_buf, 0);
+		for (int i = 0; i < (int) array_buf->getDataMembers().size(); i++)
+		{
+			const auto &member = array_buf->getDataMember(i);
+			attributes.set(member.decl.bindingLocation, member.decl.format, (uint16) member.offset, 1);
+		}
+		attributes.setBufferLayout(1, (uint16) sprite_stride, STEP_PER_INSTANCE);
+
+		attributesID = gfx->registerVertexAttributes(attributes);
+		return;
+	}
+
 	buffers.set(0, array_buf, 0);
 	attributes.setCommonFormat(vertex_format, 0);
 
@@ -384,7 +641,9 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 		if (Shader::isDefaultActive())
 		{
 			Shader::StandardShader defaultshader = Shader::STANDARD_DEFAULT;
-			if (texture->getTextureType() == TEXTURE_2D_ARRAY)
+			if (instanced)
+				defaultshader = texture->getTextureType() == TEXTURE_2D_ARRAY ? Shader::STANDARD_INSTANCED_ARRAY : Shader::STANDARD_INSTANCED;
+			else if (texture->getTextureType() == TEXTURE_2D_ARRAY)
 				defaultshader = Shader::STANDARD_ARRAY;
 
 			Shader::attachDefault(defaultshader);
@@ -394,6 +653,19 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 	if (Shader::current)
 		Shader::current->validateDrawState(PRIMITIVE_TRIANGLES, texture);
 
+	// Only vertex shaders which read the per-instance attributes can place
+	// instanced sprites. Anything else (including a pixel-only shader, which
+	// uses the non-instanced default vertex stage) would draw every sprite as
+	// the same untransformed quad.
+	if (instanced && Shader::current && !Shader::isDefaultActive())
+	{
+		for (const auto &attrib : instanceAttributes)
+		{
+			if (Shader::current->getVertexAttributeIndex(attrib.name) != attrib.location)
+				throw love::Exception("Drawing an instanced SpriteBatch requires a vertex shader which uses the '%s' attribute at location %d.", attrib.name, attrib.location);
+		}
+	}
+
 	flush(); // Upload any modified sprite data to the GPU.
 
 	bool attributesIDneedsupdate = !attributesID.isValid();
@@ -429,7 +701,20 @@ void SpriteBatch::draw(Graphics *gfx, const Matrix4 &m)
 
 	count = std::min(count, next - start);
 
-	if (count > 0)
+	if (count > 0 && instanced)
+	{
+		BufferBindings buffers = bufferBindings;
+		buffers.set(1, array_buf, start * sprite_stride);
+
+		Graphics::DrawIndexedCommand cmd(attributesID, &buffers, gfx->getQuadIndexBuffer());
+		cmd.indexCount = 6;
+		cmd.instanceCount = count;
+		cmd.indexType = INDEX_UINT16;
+		cmd.texture = gfx->getTextureOrDefaultForActiveShader(texture);
+
+		gfx->draw(cmd);
+	}
+	else if (count > 0)
 	{
 		Texture *tex = gfx->getTextureOrDefaultForActiveShader(texture);
 		gfx->drawQuads(start, count, attributesID, bufferBindings, tex);
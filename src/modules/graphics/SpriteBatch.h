@@ -25,6 +25,7 @@
 
 // C++
 #include <unordered_map>
+#include <vector>
 
 // LOVE
 #include "common/math.h"
@@ -52,7 +53,33 @@ class SpriteBatch : public Drawable
 
 	static love::Type type;
 
-	SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUsage usage);
+	/**
+	 * A packed sprite transform, as used by addMany and setMany. The quad
+	 * value selects from the list of Quads given to those functions: 0 uses
+	 * the whole texture and n uses the nth Quad in the list.
+	 **/
+	struct SpriteTransform
+	{
+		float x, y;
+		float angle;
+		float sx, sy;
+		float ox, oy;
+		float quad;
+	};
+
+	/**
+	 * Per-sprite data used by instanced SpriteBatches, in place of 4
+	 * transformed vertices. The vertex shader expands a unit quad with it.
+	 **/
+	struct SpriteInstance
+	{
+		float axes[4]; // Transformed x and y axes of the sprite's quad.
+		float origin[3]; // Transformed first corner of the quad, and its array layer.
+		float texRect[4]; // Top-left and bottom-right texture coordinates.
+		Color32 color;
+	};
+
+	SpriteBatch(Graphics *gfx, Texture *texture, int size, BufferDataUsage usage, bool instanced = false);
 	virtual ~SpriteBatch();
 
 	int add(const Matrix4 &m, int index = -1);
@@ -60,6 +87,17 @@ class SpriteBatch : public Drawable
 	int addLayer(int layer, const Matrix4 &m, int index = -1);
 	int addLayer(int layer, Quad *quad, const Matrix4 &m, int index = -1);
 
+	/**
+	 * Adds several sprites at once, growing the buffer if needed. Returns the
+	 * index of the first added sprite.
+	 **/
+	int addMany(const SpriteTransform *sprites, int count, const std::vector<Quad *> &quads);
+
+	/**
+	 * Replaces 'count' sprites starting at the given index.
+	 **/
+	void setMany(int index, const SpriteTransform *sprites, int count, const std::vector<Quad *> &quads);
+
 	void clear();
 
 	void flush();
@@ -90,6 +128,12 @@ class SpriteBatch : public Drawable
 	 **/
 	int getBufferSize() const;
 
+	/**
+	 * Whether this SpriteBatch stores one instance per sprite and expands it
+	 * in the vertex shader, rather than storing 4 vertices per sprite.
+	 **/
+	bool isInstanced() const;
+
 	/**
 	 * Attaches a specific vertex attribute from a Buffer to this SpriteBatch.
 	 * The vertex attribute will be used when drawing the SpriteBatch.
@@ -110,6 +154,11 @@ class SpriteBatch : public Drawable
 
 	void updateVertexAttributes(Graphics *gfx);
 
+	void writeSprites(int index, const SpriteTransform *sprites, int count, const std::vector<Quad *> &quads);
+	void writeInstance(int index, int layer, const Quad *quad, const Matrix4 &m);
+
+	std::vector<Buffer::DataDeclaration> getBufferFormat() const;
+
 	struct AttachedAttribute
 	{
 		StrongRef<Buffer> buffer;
@@ -139,6 +188,14 @@ class SpriteBatch : public Drawable
 	CommonFormat vertex_format;
 	size_t vertex_stride;
 
+	bool instanced;
+
+	// Size of each sprite's data: 4 vertices, or one SpriteInstance.
+	size_t sprite_stride;
+
+	// Unit quad expanded by instanced SpriteBatches.
+	StrongRef<love::graphics::Buffer> quad_buf;
+
 	VertexAttributesID attributesID;
 	BufferBindings bufferBindings;
 
@@ -81,12 +81,17 @@ void TextBatch::uploadVertices(const std::vector<Font::GlyphVertex> &vertices, s
 		vertexBuffer = newbuffer;
 
 		vertexBuffers.set(0, vertexBuffer, 0);
+
+		// The new buffer doesn't have any of the existing vertices yet.
+		modifiedVertices.clear();
+		if (offset > 0)
+			modifiedVertices.push_back(Range(0, offset));
 	}
 
 	if (vertexData != nullptr && datasize > 0)
 	{
 		memcpy(vertexData + offset, &vertices[0], datasize);
-		modifiedVertices.encapsulate(offset, datasize);
+		modifiedVertices.push_back(Range(offset, datasize));
 	}
 }
 
@@ -107,20 +112,32 @@ void TextBatch::regenerateVertices()
 	}
 }
 
+void TextBatch::generateVertices(const TextData &t, std::vector<Font::GlyphVertex> &vertices, std::vector<Font::DrawCommand> &commands, love::font::TextShaper::TextInfo &textinfo, std::vector<Font::ShelfID> &shelves)
+{
+	Colorf constantcolor = Colorf(1.0f, 1.0f, 1.0f, 1.0f);
+
+	// We only have formatted text if the align mode is valid.
+	if (t.align == Font::ALIGN_MAX_ENUM)
+		commands = font->generateVertices(t.codepoints, Range(), constantcolor, vertices, 0.0f, Vector2(0.0f, 0.0f), &textinfo, &shelves);
+	else
+		commands = font->generateVerticesFormatted(t.codepoints, constantcolor, t.wrap, t.align, vertices, &textinfo, &shelves);
+
+	std::sort(shelves.begin(), shelves.end());
+	shelves.erase(std::unique(shelves.begin(), shelves.end()), shelves.end());
+
+	if (t.useMatrix && !vertices.empty())
+		t.matrix.transformXYStrided(vertices.data(), sizeof(Font::GlyphVertex), vertices.data(), sizeof(Font::GlyphVertex), (int) vertices.size());
+}
+
 void TextBatch::addTextData(const TextData &t)
 {
 	std::vector<Font::GlyphVertex> vertices;
 	std::vector<Font::DrawCommand> newcommands;
+	std::vector<Font::ShelfID> shelves;
 
 	love::font::TextShaper::TextInfo textinfo;
 
-	Colorf constantcolor = Colorf(1.0f, 1.0f, 1.0f, 1.0f);
-
-	// We only have formatted text if the align mode is valid.
-	if (t.align == Font::ALIGN_MAX_ENUM)
-		newcommands = font->generateVertices(t.codepoints, Range(), constantcolor, vertices, 0.0f, Vector2(0.0f, 0.0f), &textinfo);
-	else
-		newcommands = font->generateVerticesFormatted(t.codepoints, constantcolor, t.wrap, t.align, vertices, &textinfo);
+	generateVertices(t, vertices, newcommands, textinfo, shelves);
 
 	size_t voffset = vertOffset;
 
@@ -129,49 +146,133 @@ void TextBatch::addTextData(const TextData &t)
 		voffset = 0;
 		vertOffset = 0;
 		drawCommands.clear();
+		usedShelves.clear();
 		textData.clear();
 	}
 
-	if (t.useMatrix && !vertices.empty())
-		t.matrix.transformXY(vertices.data(), vertices.data(), (int) vertices.size());
-
 	uploadVertices(vertices, voffset);
 
-	if (!newcommands.empty())
-	{
-		// The start vertex should be adjusted to account for the vertex offset.
-		for (Font::DrawCommand &cmd : newcommands)
-			cmd.startvertex += (int) voffset;
-
-		auto firstcmd = newcommands.begin();
+	// The start vertex should be adjusted to account for the vertex offset.
+	for (Font::DrawCommand &cmd : newcommands)
+		cmd.startvertex += (int) voffset;
 
-		// If the first draw command in the new list has the same texture as the
-		// last one in the existing list we're building and its vertices are
-		// in-order, we can combine them (saving a draw call.)
-		if (!drawCommands.empty())
-		{
-			auto prevcmd = drawCommands.back();
-			if (prevcmd.texture == firstcmd->texture && (prevcmd.startvertex + prevcmd.vertexcount) == firstcmd->startvertex)
-			{
-				drawCommands.back().vertexcount += firstcmd->vertexcount;
-				++firstcmd;
-			}
-		}
-
-		// Append the new draw commands to the list we're building.
-		drawCommands.insert(drawCommands.end(), firstcmd, newcommands.end());
-	}
+	appendDrawCommands(newcommands);
 
 	vertOffset = voffset + vertices.size();
 
 	textData.push_back(t);
 	textData.back().textInfo = textinfo;
+	textData.back().vertexStart = voffset;
+	textData.back().vertexCount = vertices.size();
+	textData.back().vertexCapacity = vertices.size();
+	textData.back().drawCommands = std::move(newcommands);
+
+	// The number of shelves is small, so merging them here is cheap even when
+	// many strings are added.
+	usedShelves.insert(usedShelves.end(), shelves.begin(), shelves.end());
+	std::sort(usedShelves.begin(), usedShelves.end());
+	usedShelves.erase(std::unique(usedShelves.begin(), usedShelves.end()), usedShelves.end());
+
+	textData.back().shelves = std::move(shelves);
 
 	// Font::generateVertices can invalidate the font's texture cache.
 	if (font->getTextureCacheID() != textureCacheID)
 		regenerateVertices();
 }
 
+void TextBatch::appendDrawCommands(const std::vector<Font::DrawCommand> &commands)
+{
+	if (commands.empty())
+		return;
+
+	auto firstcmd = commands.begin();
+
+	// If the first draw command in the new list has the same texture as the
+	// last one in the existing list we're building and its vertices are
+	// in-order, we can combine them (saving a draw call.)
+	if (!drawCommands.empty())
+	{
+		auto prevcmd = drawCommands.back();
+		if (prevcmd.texture == firstcmd->texture && (prevcmd.startvertex + prevcmd.vertexcount) == firstcmd->startvertex)
+		{
+			drawCommands.back().vertexcount += firstcmd->vertexcount;
+			++firstcmd;
+		}
+	}
+
+	// Append the new draw commands to the list we're building.
+	drawCommands.insert(drawCommands.end(), firstcmd, commands.end());
+}
+
+void TextBatch::rebuildDrawCommands()
+{
+	drawCommands.clear();
+
+	for (const TextData &t : textData)
+		appendDrawCommands(t.drawCommands);
+}
+
+void TextBatch::rebuildUsedShelves()
+{
+	usedShelves.clear();
+
+	for (const TextData &t : textData)
+		usedShelves.insert(usedShelves.end(), t.shelves.begin(), t.shelves.end());
+
+	std::sort(usedShelves.begin(), usedShelves.end());
+	usedShelves.erase(std::unique(usedShelves.begin(), usedShelves.end()), usedShelves.end());
+}
+
+void TextBatch::compactVertices()
+{
+	size_t usedvertices = 0;
+	for (const TextData &t : textData)
+		usedvertices += t.vertexCount;
+
+	// Only compact once at least half of the used part of the buffer is unused
+	// space left behind by removed or moved text.
+	if (vertOffset == 0 || usedvertices * 2 > vertOffset)
+		return;
+
+	// Entries are moved towards the start of the buffer in the order of their
+	// current location, so no entry overwrites one which hasn't moved yet.
+	std::vector<TextData *> sorted;
+	sorted.reserve(textData.size());
+	for (TextData &t : textData)
+		sorted.push_back(&t);
+
+	std::sort(sorted.begin(), sorted.end(), [](const TextData *a, const TextData *b)
+	{
+		return a->vertexStart < b->vertexStart;
+	});
+
+	size_t voffset = 0;
+
+	for (TextData *t : sorted)
+	{
+		if (t->vertexStart != voffset && t->vertexCount > 0)
+		{
+			const size_t stride = sizeof(Font::GlyphVertex);
+			memmove(vertexData + voffset * stride, vertexData + t->vertexStart * stride, t->vertexCount * stride);
+		}
+
+		for (Font::DrawCommand &cmd : t->drawCommands)
+			cmd.startvertex += (int) voffset - (int) t->vertexStart;
+
+		t->vertexStart = voffset;
+		t->vertexCapacity = t->vertexCount;
+		voffset += t->vertexCount;
+	}
+
+	vertOffset = voffset;
+
+	modifiedVertices.clear();
+	if (vertOffset > 0)
+		modifiedVertices.push_back(Range(0, vertOffset * sizeof(Font::GlyphVertex)));
+
+	rebuildDrawCommands();
+}
+
 void TextBatch::set(const std::vector<love::font::ColoredString> &text)
 {
 	return set(text, -1.0f, Font::ALIGN_MAX_ENUM);
@@ -203,10 +304,81 @@ int TextBatch::addf(const std::vector<love::font::ColoredString> &text, float wr
 	return (int) textData.size() - 1;
 }
 
+void TextBatch::setAt(int index, const std::vector<love::font::ColoredString> &text)
+{
+	if (index < 0 || index >= (int) textData.size())
+		throw love::Exception("Invalid text index: %d", index + 1);
+
+	TextData &t = textData[index];
+
+	t.codepoints = love::font::ColoredCodepoints();
+	love::font::getCodepointsFromString(text, t.codepoints);
+
+	std::vector<Font::GlyphVertex> vertices;
+	std::vector<Font::DrawCommand> newcommands;
+	std::vector<Font::ShelfID> shelves;
+	love::font::TextShaper::TextInfo textinfo;
+
+	generateVertices(t, vertices, newcommands, textinfo, shelves);
+
+	// Font::generateVertices can invalidate the font's texture cache, in which
+	// case every entry (including this one) has to be regenerated anyway.
+	if (font->getTextureCacheID() != textureCacheID)
+		return regenerateVertices();
+
+	// Re-use the entry's existing space if the new vertices fit, otherwise put
+	// them at the end of the buffer.
+	size_t voffset = t.vertexStart;
+	if (vertices.size() > t.vertexCapacity)
+	{
+		voffset = vertOffset;
+		vertOffset += vertices.size();
+		t.vertexCapacity = vertices.size();
+	}
+
+	uploadVertices(vertices, voffset);
+
+	for (Font::DrawCommand &cmd : newcommands)
+		cmd.startvertex += (int) voffset;
+
+	t.textInfo = textinfo;
+	t.vertexStart = voffset;
+	t.vertexCount = vertices.size();
+	t.drawCommands = std::move(newcommands);
+	t.shelves = std::move(shelves);
+
+	rebuildDrawCommands();
+	rebuildUsedShelves();
+	compactVertices();
+}
+
+void TextBatch::remove(int index)
+{
+	if (index < 0 || index >= (int) textData.size())
+		throw love::Exception("Invalid text index: %d", index + 1);
+
+	textData.erase(textData.begin() + index);
+
+	if (textData.empty())
+		return clear();
+
+	// The removed text's vertices are left in place until the buffer is
+	// compacted.
+	rebuildDrawCommands();
+	rebuildUsedShelves();
+	compactVertices();
+}
+
+int TextBatch::getTextCount() const
+{
+	return (int) textData.size();
+}
+
 void TextBatch::clear()
 {
 	textData.clear();
 	drawCommands.clear();
+	usedShelves.clear();
 	textureCacheID = font->getTextureCacheID();
 	vertOffset = 0;
 }
@@ -260,8 +432,11 @@ void TextBatch::draw(Graphics *gfx, const Matrix4 &m)
 	if (font->getTextureCacheID() != textureCacheID)
 		regenerateVertices();
 
+	// Keep the glyphs drawn here from being evicted from the Font's atlas.
+	font->touchShelves(usedShelves);
+
 	if (Shader::isDefaultActive())
-		Shader::attachDefault(Shader::STANDARD_DEFAULT);
+		Shader::attachDefault(font->getStandardShaderType());
 
 	Texture *firsttex = nullptr;
 	if (!drawCommands.empty())
@@ -275,17 +450,36 @@ void TextBatch::draw(Graphics *gfx, const Matrix4 &m)
 		totalverts = std::max(cmd.startvertex + cmd.vertexcount, totalverts);
 
 	// Make sure all pending data is uploaded to the GPU.
-	if (modifiedVertices.isValid())
+	if (!modifiedVertices.empty())
 	{
-		size_t offset = modifiedVertices.getOffset();
-		size_t size = modifiedVertices.getSize();
-
 		if (vertexBuffer->getDataUsage() == BUFFERDATAUSAGE_STREAM)
 			vertexBuffer->fill(0, vertexBuffer->getSize(), vertexData);
 		else
-			vertexBuffer->fill(offset, size, vertexData + offset);
+		{
+			std::sort(modifiedVertices.begin(), modifiedVertices.end(), [](const Range &a, const Range &b)
+			{
+				return a.first < b.first;
+			});
+
+			// Merge overlapping and adjacent ranges, and upload each of the
+			// resulting ranges separately.
+			Range range = modifiedVertices[0];
+			for (size_t i = 1; i <= modifiedVertices.size(); i++)
+			{
+				if (i < modifiedVertices.size() && modifiedVertices[i].first <= range.last + 1)
+				{
+					range.encapsulate(modifiedVertices[i]);
+					continue;
+				}
+
+				vertexBuffer->fill(range.getOffset(), range.getSize(), vertexData + range.getOffset());
+
+				if (i < modifiedVertices.size())
+					range = modifiedVertices[i];
+			}
+		}
 
-		modifiedVertices.invalidate();
+		modifiedVertices.clear();
 	}
 
 	Graphics::TempTransform transform(gfx, m);
@@ -49,6 +49,19 @@ class TextBatch : public Drawable
 	int add(const std::vector<love::font::ColoredString> &text, const Matrix4 &m);
 	int addf(const std::vector<love::font::ColoredString> &text, float wrap, Font::AlignMode align, const Matrix4 &m);
 
+	/**
+	 * Replaces the text of an existing entry, keeping its wrap limit, alignment
+	 * and transform. Only that entry's vertices are regenerated and uploaded.
+	 **/
+	void setAt(int index, const std::vector<love::font::ColoredString> &text);
+
+	/**
+	 * Removes an entry. The indices of all entries after it are shifted down.
+	 **/
+	void remove(int index);
+
+	int getTextCount() const;
+
 	void clear();
 
 	void setFont(Font *f);
@@ -78,11 +91,28 @@ class TextBatch : public Drawable
 		bool useMatrix;
 		bool appendVertices;
 		Matrix4 matrix;
+
+		// The range of vertices used by this text. The vertex capacity can be
+		// larger than the vertex count when the text was replaced with a
+		// shorter string.
+		size_t vertexStart = 0;
+		size_t vertexCount = 0;
+		size_t vertexCapacity = 0;
+
+		std::vector<Font::DrawCommand> drawCommands;
+
+		// Font atlas shelves holding this text's glyphs.
+		std::vector<Font::ShelfID> shelves;
 	};
 
 	void uploadVertices(const std::vector<Font::GlyphVertex> &vertices, size_t vertoffset);
 	void regenerateVertices();
+	void generateVertices(const TextData &t, std::vector<Font::GlyphVertex> &vertices, std::vector<Font::DrawCommand> &commands, love::font::TextShaper::TextInfo &textinfo, std::vector<Font::ShelfID> &shelves);
 	void addTextData(const TextData &s);
+	void appendDrawCommands(const std::vector<Font::DrawCommand> &commands);
+	void rebuildDrawCommands();
+	void rebuildUsedShelves();
+	void compactVertices();
 
 	StrongRef<Font> font;
 
@@ -91,10 +121,16 @@ class TextBatch : public Drawable
 
 	StrongRef<Buffer> vertexBuffer;
 	uint8 *vertexData;
-	Range modifiedVertices;
+
+	// Vertex ranges which still need to be uploaded to the vertex buffer.
+	std::vector<Range> modifiedVertices;
 
 	std::vector<Font::DrawCommand> drawCommands;
 
+	// Sorted, unique atlas shelves used by all of the text. They're marked as
+	// used whenever the TextBatch is drawn, so the Font doesn't evict them.
+	std::vector<Font::ShelfID> usedShelves;
+
 	std::vector<TextData> textData;
 
 	size_t vertOffset;
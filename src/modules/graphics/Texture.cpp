@@ -223,6 +223,9 @@ Texture::Texture(Graphics *gfx, const Settings &settings, const Slices *slices)
 
 		if (isCompressed() && dataMipmaps <= 1)
 			mipmapsMode = MIPMAPS_NONE;
+
+		if (isCompressed() && settings.async)
+			throw love::Exception("Compressed textures cannot use asynchronous uploads.");
 	}
 	else
 	{
@@ -601,7 +604,7 @@ void Texture::uploadImageData(love::image::ImageDataBase *d, int level, int slic
 	uploadByteData(d->getData(), d->getSize(), level, slice, rect);
 }
 
-void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+void Texture::validateReplacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y) const
 {
 	if (!isReadable())
 		throw love::Exception("replacePixels can only be called on readable Textures.");
@@ -612,14 +615,6 @@ void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap
 	if (isPixelFormatDepthStencil(format))
 		throw love::Exception("replacePixels cannot be called on depth or stencil Textures.");
 
-	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
-	if (gfx != nullptr && gfx->isRenderTargetActive(this))
-		throw love::Exception("replacePixels cannot be called on this Texture while it's an active render target.");
-
-	// No effect if the texture hasn't been created yet.
-	if (getHandle() == 0)
-		return;
-
 	// ImageData format might be linear but intended to be used as sRGB, so we
 	// don't error if only the sRGBness is different.
 	if (getLinearPixelFormat(d->getFormat()) != getLinearPixelFormat(getPixelFormat()))
@@ -658,15 +653,67 @@ void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap
 			throw love::Exception("Compressed texture format %s only supports replacing a sub-rectangle with offset and dimensions that are a multiple of %d x %d.", name, bw, bh);
 		}
 	}
+}
+
+void Texture::replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx != nullptr && gfx->isRenderTargetActive(this))
+		throw love::Exception("replacePixels cannot be called on this Texture while it's an active render target.");
+
+	validateReplacePixels(d, slice, mipmap, x, y);
+
+	// No effect if the texture hasn't been created yet.
+	if (getHandle() == 0)
+		return;
 
 	Graphics::flushBatchedDrawsGlobal();
 
+	Graphics::ScopedTiming timing(gfx, "uploadTexture");
+
 	uploadImageData(d, mipmap, slice, x, y);
 
 	if (reloadmipmaps && mipmap == 0 && getMipmapCount() > 1)
 		generateMipmaps();
 }
 
+void Texture::replacePixelsAsync(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps)
+{
+	validateReplacePixels(d, slice, mipmap, x, y);
+
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	if (gfx == nullptr)
+		return replacePixels(d, slice, mipmap, x, y, reloadmipmaps);
+
+	gfx->queueTextureUpload(this, d, slice, mipmap, x, y, reloadmipmaps);
+}
+
+void Texture::replaceSlicesAsync(const Slices &slices)
+{
+	int mipcount = slices.getMipmapCount();
+
+	// Mipmaps are generated once the last slice of the base level has been
+	// uploaded, when they weren't supplied.
+	bool genmipmaps = mipcount <= 1 && getMipmapsMode() != MIPMAPS_NONE;
+
+	for (int mip = 0; mip < mipcount; mip++)
+	{
+		int slicecount = slices.getSliceCount(mip);
+		for (int slice = 0; slice < slicecount; slice++)
+		{
+			love::image::ImageDataBase *d = slices.get(slice, mip);
+			if (d != nullptr)
+				replacePixelsAsync(d, slice, mip, 0, 0, genmipmaps && slice == slicecount - 1);
+		}
+	}
+}
+
+bool Texture::hasPendingUploads() const
+{
+	auto gfx = Module::getInstance<Graphics>(Module::M_GRAPHICS);
+	return gfx != nullptr && gfx->getPendingTextureUploadCount(this) > 0;
+}
+
 void Texture::replacePixels(const void *data, size_t size, int slice, int mipmap, const Rect &rect, bool reloadmipmaps)
 {
 	if (!isReadable() || getMSAA() > 1)
@@ -678,6 +725,8 @@ void Texture::replacePixels(const void *data, size_t size, int slice, int mipmap
 
 	Graphics::flushBatchedDrawsGlobal();
 
+	Graphics::ScopedTiming timing(gfx, "uploadTexture");
+
 	uploadByteData(data, size, mipmap, slice, rect);
 
 	if (reloadmipmaps && mipmap == 0 && getMipmapCount() > 1)
@@ -1136,6 +1185,7 @@ static StringMap<Texture::SettingType, Texture::SETTING_MAX_ENUM>::Entry setting
 	{ "computewrite", Texture::SETTING_COMPUTE_WRITE },
 	{ "viewformats",  Texture::SETTING_VIEW_FORMATS  },
 	{ "readable",     Texture::SETTING_READABLE      },
+	{ "async",        Texture::SETTING_ASYNC         },
 	{ "debugname",    Texture::SETTING_DEBUGNAME     },
 };
 
@@ -177,6 +177,7 @@ class Texture : public Drawable, public Resource
 		SETTING_COMPUTE_WRITE,
 		SETTING_VIEW_FORMATS,
 		SETTING_READABLE,
+		SETTING_ASYNC,
 		SETTING_DEBUGNAME,
 		SETTING_MAX_ENUM
 	};
@@ -198,6 +199,7 @@ class Texture : public Drawable, public Resource
 		bool computeWrite = false;
 		std::vector<PixelFormat> viewFormats;
 		OptionalBool readable;
+		bool async = false; // Initial data is uploaded over the next frames.
 		std::string debugName;
 	};
 
@@ -265,6 +267,21 @@ class Texture : public Drawable, public Resource
 	void replacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps);
 	void replacePixels(const void *data, size_t size, int slice, int mipmap, const Rect &rect, bool reloadmipmaps);
 
+	/**
+	 * Queues a replacePixels call instead of uploading immediately. Queued
+	 * uploads are processed in order when frames are presented, within a
+	 * per-frame byte budget. The data is referenced until the upload happens.
+	 **/
+	void replacePixelsAsync(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y, bool reloadmipmaps);
+
+	/**
+	 * Queues uploads for all the given slices and mipmap levels. Used for
+	 * Textures created with the async setting.
+	 **/
+	void replaceSlicesAsync(const Slices &slices);
+
+	bool hasPendingUploads() const;
+
 	void generateMipmaps();
 
 	virtual void copyFromBuffer(Buffer *source, size_t sourceoffset, int sourcewidth, size_t size, int slice, int mipmap, const Rect &rect) = 0;
@@ -339,6 +356,8 @@ class Texture : public Drawable, public Resource
 
 	void updateGraphicsMemorySize(bool loaded);
 
+	void validateReplacePixels(love::image::ImageDataBase *d, int slice, int mipmap, int x, int y) const;
+
 	void uploadImageData(love::image::ImageDataBase *d, int level, int slice, int x, int y);
 	virtual void uploadByteData(const void *data, size_t size, int level, int slice, const Rect &r) = 0;
 
@@ -358,6 +358,7 @@ Graphics::Graphics()
 		batchedDrawState.vb[0] = CreateStreamBuffer(device, BUFFERUSAGE_VERTEX, 1024 * 1024 * 1);
 		batchedDrawState.vb[1] = CreateStreamBuffer(device, BUFFERUSAGE_VERTEX, 256  * 1024 * 1);
 		batchedDrawState.indexBuffer = CreateStreamBuffer(device, BUFFERUSAGE_INDEX, sizeof(uint16) * LOVE_UINT16_MAX);
+		batchedDrawState.textureIndexBuffer = CreateStreamBuffer(device, BUFFERUSAGE_VERTEX, 64 * 1024 * 1);
 	}
 
 	createQuadIndexBuffer();
@@ -1645,10 +1646,14 @@ void Graphics::present(void *screenshotCallbackData)
 
 	deprecations.draw(this);
 
+	processPendingTextureUploads();
+
 	// endPass calls useRenderEncoder, which makes sure activeDrawable is set
 	// when possible.
 	endPass(true);
 
+	endFrameTiming();
+
 	id<MTLBuffer> screenshotbuffer = nil;
 
 	int w = activeDrawable.texture.width;
@@ -1680,6 +1685,7 @@ void Graphics::present(void *screenshotCallbackData)
 	for (StreamBuffer *buffer : batchedDrawState.vb)
 		buffer->nextFrame();
 	batchedDrawState.indexBuffer->nextFrame();
+	batchedDrawState.textureIndexBuffer->nextFrame();
 
 	uniformBuffer->nextFrame();
 	uniformBufferData = {};
@@ -1753,10 +1759,13 @@ void Graphics::present(void *screenshotCallbackData)
 	shaderSwitches = 0;
 	renderTargetSwitchCount = 0;
 	drawCallsBatched = 0;
+	drawCallsBatchedUint32 = 0;
 
 	updatePendingReadbacks();
 	updateTemporaryResources();
 	processCompletedCommandBuffers();
+
+	beginFrameTiming();
 }}
 
 int Graphics::getRequestedBackbufferMSAA() const
@@ -1849,7 +1858,7 @@ void Graphics::setBlendState(const BlendState &blend)
 {
 	if (!(blend == states.back().blend))
 	{
-		flushBatchedDraws();
+		flushBatchedDrawsForRecordedState();
 		states.back().blend = blend;
 		dirtyRenderState |= STATEBIT_BLEND;
 	}
@@ -136,7 +136,8 @@ Texture::Texture(love::graphics::Graphics *gfxbase, id<MTLDevice> device, const
 	{
 		for (int slice = 0; slice < getSliceCount(mip); slice++)
 		{
-			auto imgd = data != nullptr ? data->get(slice, mip) : nullptr;
+			// Async textures receive their data through queued uploads instead.
+			auto imgd = data != nullptr && !settings.async ? data->get(slice, mip) : nullptr;
 			if (imgd != nullptr)
 			{
 				uploadImageData(imgd, mip, slice, 0, 0);
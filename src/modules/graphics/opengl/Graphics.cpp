@@ -359,6 +359,7 @@ bool Graphics::setMode(void */*context*/, int width, int height, int pixelwidth,
 		batchedDrawState.vb[0] = CreateStreamBuffer(BUFFERUSAGE_VERTEX, 1024 * 1024 * 1);
 		batchedDrawState.vb[1] = CreateStreamBuffer(BUFFERUSAGE_VERTEX, 256  * 1024 * 1);
 		batchedDrawState.indexBuffer = CreateStreamBuffer(BUFFERUSAGE_INDEX, sizeof(uint16) * LOVE_UINT16_MAX);
+		batchedDrawState.textureIndexBuffer = CreateStreamBuffer(BUFFERUSAGE_VERTEX, 64 * 1024 * 1);
 	}
 
 	// Reload all volatile objects.
@@ -432,6 +433,8 @@ void Graphics::unSetMode()
 
 	framebufferObjects.clear();
 
+	deleteTimestampQueries();
+
 	if (mainVAO != 0)
 	{
 		glDeleteVertexArrays(1, &mainVAO);
@@ -1189,10 +1192,14 @@ void Graphics::present(void *screenshotCallbackData)
 
 	deprecations.draw(this);
 
+	processPendingTextureUploads();
+
 	flushBatchedDraws();
 
 	endPass(true);
 
+	endFrameTiming();
+
 	int w = getPixelWidth();
 	int h = getPixelHeight();
 
@@ -1297,6 +1304,7 @@ void Graphics::present(void *screenshotCallbackData)
 	for (StreamBuffer *buffer : batchedDrawState.vb)
 		buffer->nextFrame();
 	batchedDrawState.indexBuffer->nextFrame();
+	batchedDrawState.textureIndexBuffer->nextFrame();
 
 	auto window = getInstance<love::window::Window>(M_WINDOW);
 	if (window != nullptr)
@@ -1309,9 +1317,12 @@ void Graphics::present(void *screenshotCallbackData)
 	gl.stats.shaderSwitches = 0;
 	renderTargetSwitchCount = 0;
 	drawCallsBatched = 0;
+	drawCallsBatchedUint32 = 0;
 
 	updatePendingReadbacks();
 	updateTemporaryResources();
+
+	beginFrameTiming();
 }
 
 int Graphics::getRequestedBackbufferMSAA() const
@@ -1488,7 +1499,7 @@ void Graphics::setColorMask(ColorChannelMask mask)
 void Graphics::setBlendState(const BlendState &blend)
 {
 	if (!(blend == states.back().blend))
-		flushBatchedDraws();
+		flushBatchedDrawsForRecordedState();
 
 	if (blend.enable != gl.isStateEnabled(OpenGL::ENABLE_BLEND))
 		gl.setEnableState(OpenGL::ENABLE_BLEND, blend.enable);
@@ -1589,6 +1600,119 @@ void Graphics::getAPIStats(int &shaderswitches) const
 	shaderswitches = gl.stats.shaderSwitches;
 }
 
+bool Graphics::isTimestampQuerySupported() const
+{
+	return GLAD_VERSION_3_3 || GLAD_ARB_timer_query || GLAD_EXT_disjoint_timer_query;
+}
+
+int Graphics::writeTimestampQuery()
+{
+	if (!isCreated() || !isTimestampQuerySupported())
+		return -1;
+
+	if (timestampQueries.size() >= MAX_TIMESTAMP_QUERIES_PER_FRAME)
+		return -1;
+
+	GLuint query = 0;
+	if (!freeTimestampQueries.empty())
+	{
+		query = freeTimestampQueries.back();
+		freeTimestampQueries.pop_back();
+	}
+	else if (GLAD_EXT_disjoint_timer_query)
+		glGenQueriesEXT(1, &query);
+	else
+		glGenQueries(1, &query);
+
+	if (GLAD_EXT_disjoint_timer_query)
+		glQueryCounterEXT(query, GL_TIMESTAMP_EXT);
+	else
+		glQueryCounter(query, GL_TIMESTAMP);
+
+	timestampQueries.push_back(query);
+	return (int) timestampQueries.size() - 1;
+}
+
+void Graphics::submitTimestampQueries()
+{
+	pendingTimestampQueries.push_back(std::move(timestampQueries));
+	timestampQueries.clear();
+}
+
+Graphics::TimestampQueryStatus Graphics::getTimestampQueryResults(std::vector<double> &seconds)
+{
+	if (pendingTimestampQueries.empty())
+		return TIMESTAMP_QUERIES_UNAVAILABLE;
+
+	std::vector<GLuint> &queries = pendingTimestampQueries.front();
+	TimestampQueryStatus status = TIMESTAMP_QUERIES_UNAVAILABLE;
+
+	if (!queries.empty())
+	{
+		// Queries complete in order, so the last one being available means
+		// they all are.
+		GLint available = 0;
+		if (GLAD_EXT_disjoint_timer_query)
+			glGetQueryObjectivEXT(queries.back(), GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+		else
+			glGetQueryObjectiv(queries.back(), GL_QUERY_RESULT_AVAILABLE, &available);
+
+		if (!available)
+			return TIMESTAMP_QUERIES_PENDING;
+
+		// A disjoint operation (e.g. a GPU frequency change) invalidates the
+		// results of every query in flight.
+		GLint disjoint = 0;
+		if (GLAD_EXT_disjoint_timer_query)
+			glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+
+		if (!disjoint)
+		{
+			seconds.resize(queries.size());
+
+			for (size_t i = 0; i < queries.size(); i++)
+			{
+				GLuint64 ns = 0;
+				if (GLAD_EXT_disjoint_timer_query)
+					glGetQueryObjectui64vEXT(queries[i], GL_QUERY_RESULT_EXT, &ns);
+				else
+					glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &ns);
+
+				seconds[i] = (double) ns / 1000000000.0;
+			}
+
+			status = TIMESTAMP_QUERIES_READY;
+		}
+	}
+
+	freeTimestampQueries.insert(freeTimestampQueries.end(), queries.begin(), queries.end());
+	pendingTimestampQueries.pop_front();
+
+	return status;
+}
+
+void Graphics::deleteTimestampQueries()
+{
+	for (const auto &queries : pendingTimestampQueries)
+		freeTimestampQueries.insert(freeTimestampQueries.end(), queries.begin(), queries.end());
+
+	freeTimestampQueries.insert(freeTimestampQueries.end(), timestampQueries.begin(), timestampQueries.end());
+
+	if (!freeTimestampQueries.empty())
+	{
+		if (GLAD_EXT_disjoint_timer_query)
+			glDeleteQueriesEXT((GLsizei) freeTimestampQueries.size(), freeTimestampQueries.data());
+		else
+			glDeleteQueries((GLsizei) freeTimestampQueries.size(), freeTimestampQueries.data());
+	}
+
+	timestampQueries.clear();
+	pendingTimestampQueries.clear();
+	freeTimestampQueries.clear();
+
+	resetFrameTimings();
+}
+
 void Graphics::initCapabilities()
 {
 	capabilities.features[FEATURE_MULTI_RENDER_TARGET_FORMATS] = true;
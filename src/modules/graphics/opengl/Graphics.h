@@ -24,6 +24,7 @@
 // STD
 #include <stack>
 #include <vector>
+#include <deque>
 #include <unordered_map>
 
 // OpenGL
@@ -145,6 +146,12 @@ class Graphics final : public love::graphics::Graphics
 	void initCapabilities() override;
 	void getAPIStats(int &shaderswitches) const override;
 
+	int writeTimestampQuery() override;
+	void submitTimestampQueries() override;
+	TimestampQueryStatus getTimestampQueryResults(std::vector<double> &seconds) override;
+	bool isTimestampQuerySupported() const;
+	void deleteTimestampQueries();
+
 	void endPass(bool presenting);
 	GLuint bindCachedFBO(const RenderTargets &targets);
 	void discard(OpenGL::FramebufferTarget target, const std::vector<bool> &colorbuffers, bool depthstencil);
@@ -172,6 +179,12 @@ class Graphics final : public love::graphics::Graphics
 	// [non-readable, readable]
 	uint32 pixelFormatUsage[PIXELFORMAT_MAX_ENUM][2];
 
+	std::vector<GLuint> timestampQueries;
+	std::deque<std::vector<GLuint>> pendingTimestampQueries;
+	std::vector<GLuint> freeTimestampQueries;
+
+	static const size_t MAX_TIMESTAMP_QUERIES_PER_FRAME = 1024;
+
 }; // Graphics
 
 } // opengl
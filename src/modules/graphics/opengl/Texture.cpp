@@ -220,7 +220,8 @@ Texture::Texture(love::graphics::Graphics *gfx, const Settings &settings, const
 	, textureGLError(GL_NO_ERROR)
 	, actualSamples(1)
 {
-	if (data != nullptr)
+	// Async textures receive their data through queued uploads instead.
+	if (data != nullptr && !settings.async)
 		slices = *data;
 
 	if (!loadVolatile())
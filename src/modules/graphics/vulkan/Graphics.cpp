@@ -23,6 +23,7 @@
 #include "common/version.h"
 #include "common/memory.h"
 #include "window/Window.h"
+#include "filesystem/Filesystem.h"
 #include "Buffer.h"
 #include "Graphics.h"
 #include "GraphicsReadback.h"
@@ -150,6 +151,9 @@ Graphics::Graphics()
 
 Graphics::~Graphics()
 {
+	if (device != VK_NULL_HANDLE)
+		savePersistentCaches();
+
 	defaultVertexBuffer.set(nullptr);
 	localUniformBuffer.set(nullptr);
 
@@ -320,6 +324,9 @@ void Graphics::submitGpuCommands(SubmitMode submitMode, void *screenshotCallback
 	if (renderPassState.active)
 		endRenderPass();
 
+	if (submitMode == SUBMIT_PRESENT)
+		endFrameTiming();
+
 	VkBuffer screenshotBuffer = VK_NULL_HANDLE;
 	VmaAllocation screenshotAllocation = VK_NULL_HANDLE;
 	VmaAllocationInfo screenshotAllocationInfo = {};
@@ -529,6 +536,8 @@ void Graphics::present(void *screenshotCallbackdata)
 
 	deprecations.draw(this);
 
+	processPendingTextureUploads();
+
 	submitGpuCommands(SUBMIT_PRESENT, screenshotCallbackdata);
 
 	VkResult result = VK_SUCCESS;
@@ -569,10 +578,12 @@ void Graphics::present(void *screenshotCallbackdata)
 	for (love::graphics::StreamBuffer *buffer : batchedDrawState.vb)
 		buffer->nextFrame();
 	batchedDrawState.indexBuffer->nextFrame();
+	batchedDrawState.textureIndexBuffer->nextFrame();
 
 	drawCalls = 0;
 	renderTargetSwitchCount = 0;
 	drawCallsBatched = 0;
+	drawCallsBatchedUint32 = 0;
 
 	updatePendingReadbacks();
 	updateTemporaryResources();
@@ -581,6 +592,8 @@ void Graphics::present(void *screenshotCallbackdata)
 	currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 
 	beginFrame();
+
+	beginFrameTiming();
 }
 
 void Graphics::backbufferChanged(int width, int height, int pixelwidth, int pixelheight, bool backbufferstencil, bool backbufferdepth, int msaa)
@@ -625,6 +638,8 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 		pickPhysicalDevice();
 		createLogicalDevice();
 		createPipelineCache();
+		loadSpirvCache();
+		createTimestampQueryPools();
 		initVMA();
 		initCapabilities();
 	}
@@ -658,6 +673,7 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 			batchedDrawState.vb[0] = new StreamBuffer(this, BUFFERUSAGE_VERTEX, 1024 * 1024 * 1);
 			batchedDrawState.vb[1] = new StreamBuffer(this, BUFFERUSAGE_VERTEX, 256 * 1024 * 1);
 			batchedDrawState.indexBuffer = new StreamBuffer(this, BUFFERUSAGE_INDEX, sizeof(uint16) * LOVE_UINT16_MAX);
+			batchedDrawState.textureIndexBuffer = new StreamBuffer(this, BUFFERUSAGE_VERTEX, 64 * 1024 * 1);
 		}
 
 		if (defaultVertexBuffer == nullptr)
@@ -714,6 +730,7 @@ bool Graphics::setMode(void *context, int width, int height, int pixelwidth, int
 	created = true;
 	drawCalls = 0;
 	drawCallsBatched = 0;
+	drawCallsBatchedUint32 = 0;
 
 	return true;
 }
@@ -771,6 +788,8 @@ void Graphics::unSetMode()
 
 	created = false;
 
+	savePersistentCaches();
+
 	cleanupSwapChain();
 	vkDestroySurfaceKHR(instance, surface, nullptr);
 }
@@ -817,7 +836,7 @@ void Graphics::setColorMask(ColorChannelMask mask)
 
 void Graphics::setBlendState(const BlendState &blend)
 {
-	flushBatchedDraws();
+	flushBatchedDrawsForRecordedState();
 
 	states.back().blend = blend;
 }
@@ -1174,6 +1193,30 @@ graphics::Shader *Graphics::newShaderInternal(StrongRef<love::graphics::ShaderSt
 	return new Shader(stages, options);
 }
 
+AsyncShader::Precompiler Graphics::getShaderPrecompiler(const std::string glsl[SHADERSTAGE_MAX_ENUM])
+{
+	bool spirv14 = getEnabledOptionalDeviceExtensions().spirv14;
+	std::string key = Shader::getSpirvCacheKey(glsl, spirv14);
+
+	if (spirvCache.find(key) != spirvCache.end())
+		return nullptr;
+
+	// SPIR-V generation is most of the cost of creating a Shader, so it's done
+	// on the worker thread and added to the cache once the result is back.
+	return [key, spirv14](const std::string stageglsl[SHADERSTAGE_MAX_ENUM]) -> AsyncShader::PrecompileFinisher
+	{
+		auto spirv = std::make_shared<std::vector<std::vector<uint32>>>(SHADERSTAGE_MAX_ENUM);
+		Shader::compileSpirv(stageglsl, spirv14, spirv->data());
+
+		return [key, spirv](love::graphics::Graphics *gfx)
+		{
+			auto vgfx = (Graphics *) gfx;
+			if (vgfx->spirvCache.find(key) == vgfx->spirvCache.end())
+				vgfx->addCachedSpirv(key, spirv->data());
+		};
+	};
+}
+
 graphics::StreamBuffer *Graphics::newStreamBuffer(BufferUsage type, size_t size)
 {
 	return new StreamBuffer(this, type, size);
@@ -1356,8 +1399,30 @@ void Graphics::beginFrame()
 		cleanUpFn();
 	cleanUpFunctions.at(currentFrame).clear();
 
+	// This frame's fence has been waited on, so its part of the staging ring
+	// is no longer in use by the GPU.
+	stagingRingFrameOffset = 0;
+
+	// This frame's timestamp queries are about to be reset, so any results
+	// which haven't been read yet must be read now. The fence wait above means
+	// they're complete.
+	while (std::find(pendingTimestampFrames.begin(), pendingTimestampFrames.end(), currentFrame) != pendingTimestampFrames.end())
+	{
+		std::vector<double> seconds;
+		readTimestampQueries(pendingTimestampFrames.front(), true, seconds);
+		resolvedTimestamps.push_back(std::move(seconds));
+		pendingTimestampFrames.pop_front();
+	}
+
 	startRecordingGraphicsCommands();
 
+	if (!timestampQueryPools.empty())
+	{
+		vkCmdResetQueryPool(commandBuffers.at(currentFrame), timestampQueryPools[currentFrame], 0, MAX_TIMESTAMP_QUERIES_PER_FRAME);
+		timestampQueryCounts[currentFrame] = 0;
+		timestampQueriesRecording = true;
+	}
+
 	if (!swapChainImages.empty())
 	{
 		Vulkan::cmdTransitionImageLayout(
@@ -1451,6 +1516,59 @@ VkCommandBuffer Graphics::getCommandBufferForDataTransfer()
 	return commandBuffers.at(currentFrame);
 }
 
+bool Graphics::allocateStagingMemory(VkDeviceSize size, VkDeviceSize alignment, VkBuffer &buffer, VkDeviceSize &offset, void *&data)
+{
+	if (size > STAGING_RING_FRAME_SIZE)
+		return false;
+
+	if (stagingRingBuffer == VK_NULL_HANDLE)
+	{
+		VkBufferCreateInfo bufferInfo{};
+		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferInfo.size = STAGING_RING_FRAME_SIZE * MAX_FRAMES_IN_FLIGHT;
+		bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VmaAllocationCreateInfo allocCreateInfo = {};
+		allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+		allocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+		VmaAllocationInfo allocInfo;
+		if (vmaCreateBuffer(vmaAllocator, &bufferInfo, &allocCreateInfo, &stagingRingBuffer, &stagingRingAllocation, &allocInfo) != VK_SUCCESS)
+		{
+			stagingRingBuffer = VK_NULL_HANDLE;
+			return false;
+		}
+
+		VkMemoryPropertyFlags properties;
+		vmaGetAllocationMemoryProperties(vmaAllocator, stagingRingAllocation, &properties);
+
+		stagingRingData = (uint8 *) allocInfo.pMappedData;
+		stagingRingCoherent = (properties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+		stagingRingFrameOffset = 0;
+	}
+
+	VkDeviceSize alignedoffset = stagingRingFrameOffset;
+	if (alignment > 1 && alignedoffset % alignment != 0)
+		alignedoffset += alignment - (alignedoffset % alignment);
+
+	if (alignedoffset + size > STAGING_RING_FRAME_SIZE)
+		return false;
+
+	stagingRingFrameOffset = alignedoffset + size;
+
+	buffer = stagingRingBuffer;
+	offset = currentFrame * STAGING_RING_FRAME_SIZE + alignedoffset;
+	data = stagingRingData + offset;
+	return true;
+}
+
+void Graphics::flushStagingMemory(VkDeviceSize offset, VkDeviceSize size)
+{
+	if (!stagingRingCoherent)
+		vmaFlushAllocation(vmaAllocator, stagingRingAllocation, offset, size);
+}
+
 void Graphics::queueCleanUp(std::function<void()> cleanUp)
 {
 	cleanUpFunctions.at(currentFrame).push_back(cleanUp);
@@ -1787,15 +1905,370 @@ void Graphics::createLogicalDevice()
 	vkGetDeviceQueue(device, indices.presentFamily.value, 0, &presentQueue);
 }
 
+static const char *PIPELINE_CACHE_FILENAME = "gpucache/vulkan_pipelines.bin";
+static const char *SPIRV_CACHE_FILENAME = "gpucache/vulkan_spirv.bin";
+
+// Both cache files are only valid for the LOVE version and driver which wrote
+// them, since SPIR-V output depends on the bundled glslang and pipeline cache
+// data depends on the driver.
+struct PersistentCacheHeader
+{
+	char magic[8];
+	char version[16];
+	uint8 pipelineCacheUUID[VK_UUID_SIZE];
+	uint32 vendorID;
+	uint32 deviceID;
+	uint32 driverVersion;
+	uint32 reserved;
+	uint64 count;
+};
+
+static PersistentCacheHeader getPersistentCacheHeader(VkPhysicalDevice physicalDevice)
+{
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	PersistentCacheHeader header;
+	memset(&header, 0, sizeof(PersistentCacheHeader));
+
+	memcpy(header.magic, "LOVEVKC1", sizeof(header.magic));
+	strncpy(header.version, LOVE_VERSION_STRING, sizeof(header.version) - 1);
+	memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+	header.vendorID = properties.vendorID;
+	header.deviceID = properties.deviceID;
+	header.driverVersion = properties.driverVersion;
+
+	return header;
+}
+
+bool Graphics::readPersistentCacheFile(const char *filename, std::vector<uint8> &data, uint64 &count) const
+{
+	auto fs = Module::getInstance<love::filesystem::Filesystem>(M_FILESYSTEM);
+	if (fs == nullptr || !fs->exists(filename))
+		return false;
+
+	StrongRef<love::filesystem::FileData> file;
+
+	try
+	{
+		file.set(fs->read(filename), Acquire::NORETAIN);
+	}
+	catch (love::Exception &)
+	{
+		return false;
+	}
+
+	if (file->getSize() < sizeof(PersistentCacheHeader))
+		return false;
+
+	PersistentCacheHeader expected = getPersistentCacheHeader(physicalDevice);
+	PersistentCacheHeader header;
+	memcpy(&header, file->getData(), sizeof(PersistentCacheHeader));
+
+	count = header.count;
+	header.count = 0;
+
+	if (memcmp(&header, &expected, sizeof(PersistentCacheHeader)) != 0)
+		return false;
+
+	const uint8 *bytes = (const uint8 *) file->getData() + sizeof(PersistentCacheHeader);
+	data.assign(bytes, bytes + (file->getSize() - sizeof(PersistentCacheHeader)));
+
+	return true;
+}
+
+void Graphics::writePersistentCacheFile(const char *filename, const void *data, size_t size, uint64 count) const
+{
+	auto fs = Module::getInstance<love::filesystem::Filesystem>(M_FILESYSTEM);
+	if (fs == nullptr)
+		return;
+
+	PersistentCacheHeader header = getPersistentCacheHeader(physicalDevice);
+	header.count = count;
+
+	std::vector<uint8> contents(sizeof(PersistentCacheHeader) + size);
+	memcpy(contents.data(), &header, sizeof(PersistentCacheHeader));
+	if (size > 0)
+		memcpy(contents.data() + sizeof(PersistentCacheHeader), data, size);
+
+	// The caches are an optimization, so failing to write them (for example
+	// if there's no save directory) isn't an error.
+	try
+	{
+		fs->createDirectory("gpucache");
+		fs->write(filename, contents.data(), (int64) contents.size());
+	}
+	catch (love::Exception &)
+	{
+	}
+}
+
 void Graphics::createPipelineCache()
 {
 	VkPipelineCacheCreateInfo cacheInfo{};
 	cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
 
+	std::vector<uint8> data;
+	uint64 count = 0;
+	if (readPersistentCacheFile(PIPELINE_CACHE_FILENAME, data, count) && count == data.size())
+	{
+		cacheInfo.initialDataSize = data.size();
+		cacheInfo.pInitialData = data.data();
+		savedPipelineCacheSize = data.size();
+	}
+
+	if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache) == VK_SUCCESS)
+		return;
+
+	// The driver may reject stale data, in which case we start from scratch.
+	cacheInfo.initialDataSize = 0;
+	cacheInfo.pInitialData = nullptr;
+	savedPipelineCacheSize = 0;
+
 	if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache) != VK_SUCCESS)
 		throw love::Exception("could not create pipeline cache");
 }
 
+void Graphics::loadSpirvCache()
+{
+	std::vector<uint8> data;
+	uint64 count = 0;
+	if (!readPersistentCacheFile(SPIRV_CACHE_FILENAME, data, count))
+		return;
+
+	// Each entry is a hash key, a mask of the stages it has, then a word count
+	// and SPIR-V words for each of those stages.
+	size_t offset = 0;
+
+	auto readUint32 = [&](uint32 &value) -> bool
+	{
+		if (offset + sizeof(uint32) > data.size())
+			return false;
+		memcpy(&value, data.data() + offset, sizeof(uint32));
+		offset += sizeof(uint32);
+		return true;
+	};
+
+	for (uint64 i = 0; i < count; i++)
+	{
+		uint32 keysize = 0;
+		if (!readUint32(keysize) || offset + keysize > data.size())
+			break;
+
+		std::string key((const char *) data.data() + offset, keysize);
+		offset += keysize;
+
+		uint32 stagemask = 0;
+		if (!readUint32(stagemask))
+			break;
+
+		std::vector<std::vector<uint32>> stages(SHADERSTAGE_MAX_ENUM);
+		bool valid = true;
+
+		for (int stage = 0; stage < SHADERSTAGE_MAX_ENUM && valid; stage++)
+		{
+			if ((stagemask & (1u << stage)) == 0)
+				continue;
+
+			uint32 wordcount = 0;
+			if (!readUint32(wordcount) || offset + (size_t) wordcount * sizeof(uint32) > data.size())
+			{
+				valid = false;
+				break;
+			}
+
+			stages[stage].resize(wordcount);
+			memcpy(stages[stage].data(), data.data() + offset, wordcount * sizeof(uint32));
+			offset += wordcount * sizeof(uint32);
+		}
+
+		if (!valid)
+			break;
+
+		spirvCache[key] = std::move(stages);
+	}
+}
+
+void Graphics::savePersistentCaches()
+{
+	if (pipelineCache != VK_NULL_HANDLE)
+	{
+		size_t size = 0;
+		if (vkGetPipelineCacheData(device, pipelineCache, &size, nullptr) == VK_SUCCESS && size != savedPipelineCacheSize)
+		{
+			std::vector<uint8> data(size);
+			if (vkGetPipelineCacheData(device, pipelineCache, &size, data.data()) == VK_SUCCESS)
+			{
+				writePersistentCacheFile(PIPELINE_CACHE_FILENAME, data.data(), size, size);
+				savedPipelineCacheSize = size;
+			}
+		}
+	}
+
+	if (spirvCacheModified)
+	{
+		std::vector<uint8> data;
+
+		auto writeUint32 = [&](uint32 value)
+		{
+			const uint8 *bytes = (const uint8 *) &value;
+			data.insert(data.end(), bytes, bytes + sizeof(uint32));
+		};
+
+		for (const auto &entry : spirvCache)
+		{
+			writeUint32((uint32) entry.first.size());
+			data.insert(data.end(), entry.first.begin(), entry.first.end());
+
+			uint32 stagemask = 0;
+			for (int stage = 0; stage < SHADERSTAGE_MAX_ENUM; stage++)
+			{
+				if (!entry.second[stage].empty())
+					stagemask |= 1u << stage;
+			}
+
+			writeUint32(stagemask);
+
+			for (int stage = 0; stage < SHADERSTAGE_MAX_ENUM; stage++)
+			{
+				const auto &words = entry.second[stage];
+				if (words.empty())
+					continue;
+
+				writeUint32((uint32) words.size());
+				const uint8 *bytes = (const uint8 *) words.data();
+				data.insert(data.end(), bytes, bytes + words.size() * sizeof(uint32));
+			}
+		}
+
+		writePersistentCacheFile(SPIRV_CACHE_FILENAME, data.data(), data.size(), spirvCache.size());
+		spirvCacheModified = false;
+	}
+}
+
+bool Graphics::getCachedSpirv(const std::string &key, std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM]) const
+{
+	auto it = spirvCache.find(key);
+	if (it == spirvCache.end())
+		return false;
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+		spirv[i] = it->second[i];
+
+	return true;
+}
+
+void Graphics::addCachedSpirv(const std::string &key, const std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM])
+{
+	std::vector<std::vector<uint32>> stages(spirv, spirv + SHADERSTAGE_MAX_ENUM);
+	spirvCache[key] = std::move(stages);
+	spirvCacheModified = true;
+}
+
+void Graphics::createTimestampQueryPools()
+{
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	uint32_t queueFamilyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+
+	std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+	QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
+	uint32 validBits = queueFamilies.at(indices.graphicsFamily.value).timestampValidBits;
+
+	// Frame timing falls back to CPU times only if timestamps aren't usable.
+	if (validBits == 0 || properties.limits.timestampPeriod <= 0.0f)
+		return;
+
+	timestampPeriod = properties.limits.timestampPeriod;
+	timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+	VkQueryPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	poolInfo.queryCount = MAX_TIMESTAMP_QUERIES_PER_FRAME;
+
+	timestampQueryPools.resize(MAX_FRAMES_IN_FLIGHT, VK_NULL_HANDLE);
+	timestampQueryCounts.resize(MAX_FRAMES_IN_FLIGHT, 0);
+
+	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		if (vkCreateQueryPool(device, &poolInfo, nullptr, &timestampQueryPools[i]) != VK_SUCCESS)
+			throw love::Exception("failed to create timestamp query pool");
+	}
+}
+
+bool Graphics::readTimestampQueries(size_t frame, bool wait, std::vector<double> &seconds)
+{
+	uint32 count = timestampQueryCounts[frame];
+	seconds.resize(count);
+
+	if (count == 0)
+		return true;
+
+	std::vector<uint64> ticks(count);
+
+	VkQueryResultFlags flags = VK_QUERY_RESULT_64_BIT;
+	if (wait)
+		flags |= VK_QUERY_RESULT_WAIT_BIT;
+
+	VkResult result = vkGetQueryPoolResults(device, timestampQueryPools[frame], 0, count, sizeof(uint64) * count, ticks.data(), sizeof(uint64), flags);
+	if (result != VK_SUCCESS)
+	{
+		seconds.clear();
+		return false;
+	}
+
+	for (uint32 i = 0; i < count; i++)
+		seconds[i] = (double) (ticks[i] & timestampMask) * timestampPeriod / 1000000000.0;
+
+	return true;
+}
+
+int Graphics::writeTimestampQuery()
+{
+	if (!timestampQueriesRecording)
+		return -1;
+
+	uint32 &count = timestampQueryCounts[currentFrame];
+	if (count >= MAX_TIMESTAMP_QUERIES_PER_FRAME)
+		return -1;
+
+	vkCmdWriteTimestamp(commandBuffers.at(currentFrame), VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampQueryPools[currentFrame], count);
+	return (int) count++;
+}
+
+void Graphics::submitTimestampQueries()
+{
+	if (timestampQueryPools.empty())
+		return;
+
+	pendingTimestampFrames.push_back(currentFrame);
+	timestampQueriesRecording = false;
+}
+
+Graphics::TimestampQueryStatus Graphics::getTimestampQueryResults(std::vector<double> &seconds)
+{
+	if (!resolvedTimestamps.empty())
+	{
+		seconds = std::move(resolvedTimestamps.front());
+		resolvedTimestamps.pop_front();
+		return TIMESTAMP_QUERIES_READY;
+	}
+
+	if (pendingTimestampFrames.empty())
+		return TIMESTAMP_QUERIES_UNAVAILABLE;
+
+	if (!readTimestampQueries(pendingTimestampFrames.front(), false, seconds))
+		return TIMESTAMP_QUERIES_PENDING;
+
+	pendingTimestampFrames.pop_front();
+	return TIMESTAMP_QUERIES_READY;
+}
+
 void Graphics::initVMA()
 {
 	VmaAllocatorCreateInfo allocatorCreateInfo = {};
@@ -3162,6 +3635,12 @@ void Graphics::cleanup()
 			cleanUpFn();
 	cleanUpFunctions.clear();
 
+	if (stagingRingBuffer != VK_NULL_HANDLE)
+		vmaDestroyBuffer(vmaAllocator, stagingRingBuffer, stagingRingAllocation);
+	stagingRingBuffer = VK_NULL_HANDLE;
+	stagingRingAllocation = VK_NULL_HANDLE;
+	stagingRingData = nullptr;
+
 	vmaDestroyAllocator(vmaAllocator);
 
 	for (const auto &s : renderFinishedSemaphores)
@@ -3192,6 +3671,15 @@ void Graphics::cleanup()
 		vkDestroyFramebuffer(device, entry.second, nullptr);
 	framebuffers.clear();
 
+	for (VkQueryPool pool : timestampQueryPools)
+		vkDestroyQueryPool(device, pool, nullptr);
+	timestampQueryPools.clear();
+	timestampQueryCounts.clear();
+	pendingTimestampFrames.clear();
+	resolvedTimestamps.clear();
+	timestampQueriesRecording = false;
+	resetFrameTimings();
+
 	vkDestroyCommandPool(device, commandPool, nullptr);
 	vkDestroyPipelineCache(device, pipelineCache, nullptr);
 	vkDestroyDevice(device, nullptr);
@@ -38,6 +38,7 @@
 #include <functional>
 #include <set>
 #include <tuple>
+#include <deque>
 
 namespace love
 {
@@ -278,19 +279,35 @@ class Graphics final : public love::graphics::Graphics
 	int getVsync() const;
 	void mapLocalUniformData(void *data, size_t size, VkDescriptorBufferInfo &bufferInfo);
 
+	// Sub-allocates from the persistent staging ring used for uploads. Each
+	// frame in flight has its own region, which is reused once that frame's
+	// fence has been signaled. Returns false if the data doesn't fit, in which
+	// case a dedicated staging buffer should be used instead.
+	bool allocateStagingMemory(VkDeviceSize size, VkDeviceSize alignment, VkBuffer &buffer, VkDeviceSize &offset, void *&data);
+	void flushStagingMemory(VkDeviceSize offset, VkDeviceSize size);
+
 	VkPipeline createGraphicsPipeline(Shader *shader, const GraphicsPipelineConfigurationCore &configuration, const GraphicsPipelineConfigurationNoDynamicState *noDynamicStateConfiguration);
 
+	// SPIR-V compiled from a set of linked shader stages, keyed by a hash of
+	// their source. Saved to the save directory along with the pipeline cache.
+	bool getCachedSpirv(const std::string &key, std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM]) const;
+	void addCachedSpirv(const std::string &key, const std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM]);
+
 	uint32 getDeviceApiVersion() const { return deviceApiVersion; }
 
 protected:
 	graphics::ShaderStage *newShaderStageInternal(ShaderStageType stage, const std::string &cachekey, const std::string &source, bool gles) override;
 	graphics::Shader *newShaderInternal(StrongRef<love::graphics::ShaderStage> stages[SHADERSTAGE_MAX_ENUM], const Shader::CompileOptions &options) override;
+	AsyncShader::Precompiler getShaderPrecompiler(const std::string glsl[SHADERSTAGE_MAX_ENUM]) override;
 	graphics::StreamBuffer *newStreamBuffer(BufferUsage type, size_t size) override;
 	bool dispatch(love::graphics::Shader *shader, int x, int y, int z) override;
 	bool dispatch(love::graphics::Shader *shader, love::graphics::Buffer *indirectargs, size_t argsoffset) override;
 	void initCapabilities() override;
 	void getAPIStats(int &shaderswitches) const override;
 	void setRenderTargetsInternal(const RenderTargets &rts, int pixelw, int pixelh, bool hasSRGBtexture) override;
+	int writeTimestampQuery() override;
+	void submitTimestampQueries() override;
+	TimestampQueryStatus getTimestampQueryResults(std::vector<double> &seconds) override;
 
 private:
 	bool checkValidationSupport();
@@ -299,6 +316,12 @@ class Graphics final : public love::graphics::Graphics
 	QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
 	void createLogicalDevice();
 	void createPipelineCache();
+	void loadSpirvCache();
+	void savePersistentCaches();
+	bool readPersistentCacheFile(const char *filename, std::vector<uint8> &data, uint64 &count) const;
+	void writePersistentCacheFile(const char *filename, const void *data, size_t size, uint64 count) const;
+	void createTimestampQueryPools();
+	bool readTimestampQueries(size_t frame, bool wait, std::vector<double> &seconds);
 	void initVMA();
 	void createSurface();
 	bool checkDeviceExtensionSupport(VkPhysicalDevice device);
@@ -373,6 +396,9 @@ class Graphics final : public love::graphics::Graphics
 	VkImageView depthImageView = VK_NULL_HANDLE;
 	VmaAllocation depthImageAllocation = VK_NULL_HANDLE;
 	VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+	size_t savedPipelineCacheSize = 0;
+	std::unordered_map<std::string, std::vector<std::vector<uint32>>> spirvCache;
+	bool spirvCacheModified = false;
 	std::unordered_map<RenderPassConfiguration, VkRenderPass, RenderPassConfigurationHasher> renderPasses;
 	std::unordered_map<FramebufferConfiguration, VkFramebuffer, FramebufferConfigurationHasher> framebuffers;
 	std::unordered_map<VkFramebuffer, bool> framebufferUsages;
@@ -400,6 +426,22 @@ class Graphics final : public love::graphics::Graphics
 	std::vector<std::vector<std::function<void()>>> readbackCallbacks;
 	std::set<StrongRef<Shader>> usedShadersInFrame;
 	RenderpassState renderPassState;
+	// One timestamp query pool per frame in flight, for frame timing.
+	std::vector<VkQueryPool> timestampQueryPools;
+	std::vector<uint32> timestampQueryCounts;
+	std::deque<size_t> pendingTimestampFrames;
+	std::deque<std::vector<double>> resolvedTimestamps;
+	double timestampPeriod = 0.0;
+	uint64 timestampMask = 0;
+	bool timestampQueriesRecording = false;
+	static const uint32 MAX_TIMESTAMP_QUERIES_PER_FRAME = 1024;
+	// Staging ring for texture uploads, created on first use.
+	VkBuffer stagingRingBuffer = VK_NULL_HANDLE;
+	VmaAllocation stagingRingAllocation = VK_NULL_HANDLE;
+	uint8 *stagingRingData = nullptr;
+	bool stagingRingCoherent = false;
+	VkDeviceSize stagingRingFrameOffset = 0;
+	static const VkDeviceSize STAGING_RING_FRAME_SIZE = 16 * 1024 * 1024;
 };
 
 } // vulkan
@@ -22,6 +22,7 @@
 #include "Shader.h"
 #include "Graphics.h"
 #include "common/Range.h"
+#include "data/DataModule.h"
 
 #include "libraries/glslang/glslang/Public/ShaderLang.h"
 #include "libraries/glslang/glslang/Public/ResourceLimits.h"
@@ -456,33 +457,47 @@ void Shader::buildLocalUniforms(spirv_cross::Compiler &comp, const spirv_cross::
 	}
 }
 
-void Shader::compileShaders()
+std::string Shader::getSpirvCacheKey(const std::string glsl[SHADERSTAGE_MAX_ENUM], bool spirv14)
+{
+	// Compiled SPIR-V is cached (on disk as well) by a hash of the source of
+	// every stage and the SPIR-V version being targeted.
+	std::string cachekeysource = spirv14 ? "spv1.4" : "spv1.0";
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		if (glsl[i].empty())
+			continue;
+
+		cachekeysource += '\0';
+		cachekeysource += (char) ('0' + i);
+		cachekeysource += glsl[i];
+	}
+
+	data::HashFunction::Value hashvalue;
+	data::hash(data::HashFunction::FUNCTION_SHA1, cachekeysource.c_str(), cachekeysource.size(), hashvalue);
+	return std::string(hashvalue.data, hashvalue.size);
+}
+
+void Shader::compileSpirv(const std::string glsl[SHADERSTAGE_MAX_ENUM], bool spirv14, std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM])
 {
 	using namespace glslang;
-	using namespace spirv_cross;
 
 	std::vector<std::unique_ptr<TShader>> glslangShaders;
 
 	auto program = std::make_unique<TProgram>();
 
-	const auto &enabledExtensions = vgfx->getEnabledOptionalDeviceExtensions();
-
 	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
 	{
-		if (!stages[i])
+		if (glsl[i].empty())
 			continue;
 
 		auto stage = (ShaderStageType)i;
-
-		if (stage == SHADERSTAGE_COMPUTE)
-			isCompute = true;
-
 		auto glslangShaderStage = getGlslShaderType(stage);
 		auto tshader = std::make_unique<TShader>(glslangShaderStage);
 
 		tshader->setEnvInput(EShSourceGlsl, glslangShaderStage, EShClientVulkan, 450);
 		tshader->setEnvClient(EShClientVulkan, EShTargetVulkan_1_2);
-		if (enabledExtensions.spirv14)
+		if (spirv14)
 			tshader->setEnvTarget(EshTargetSpv, EShTargetSpv_1_4);
 		else
 			tshader->setEnvTarget(EshTargetSpv, EShTargetSpv_1_0);
@@ -492,9 +507,8 @@ void Shader::compileShaders()
 		tshader->setGlobalUniformBinding(0);
 		tshader->setGlobalUniformSet(0);
 
-		auto &glsl = stages[i]->getSource();
-		const char *csrc = glsl.c_str();
-		const int sourceLength = static_cast<int>(glsl.length());
+		const char *csrc = glsl[i].c_str();
+		const int sourceLength = static_cast<int>(glsl[i].length());
 		tshader->setStringsWithLengths(&csrc, &sourceLength, 1);
 
 		int defaultVersion = 450;
@@ -524,14 +538,9 @@ void Shader::compileShaders()
 	if (!program->mapIO())
 		throw love::Exception("mapIO failed");
 
-	BindingMapper bindingMapper(spv::DecorationBinding);
-	BindingMapper ioLocationMapper(spv::DecorationLocation);
-	BindingMapper vertexInputLocationMapper(spv::DecorationLocation);
-
 	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
 	{
-		auto shaderStage = (ShaderStageType)i;
-		auto glslangStage = getGlslShaderType(shaderStage);
+		auto glslangStage = getGlslShaderType((ShaderStageType)i);
 		auto intermediate = program->getIntermediate(glslangStage);
 
 		if (intermediate == nullptr)
@@ -541,9 +550,51 @@ void Shader::compileShaders()
 		glslang::SpvOptions opt;
 		opt.validate = true;
 
-		std::vector<uint32> spirv;
+		GlslangToSpv(*intermediate, spirv[i], &logger, &opt);
+	}
+}
+
+void Shader::compileShaders()
+{
+	using namespace spirv_cross;
+
+	bool spirv14 = vgfx->getEnabledOptionalDeviceExtensions().spirv14;
+
+	std::string glsl[SHADERSTAGE_MAX_ENUM];
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		if (!stages[i])
+			continue;
+
+		if ((ShaderStageType) i == SHADERSTAGE_COMPUTE)
+			isCompute = true;
+
+		glsl[i] = stages[i]->getSource();
+	}
+
+	std::string cachekey = getSpirvCacheKey(glsl, spirv14);
+
+	std::vector<uint32> stagespirv[SHADERSTAGE_MAX_ENUM];
+
+	if (!vgfx->getCachedSpirv(cachekey, stagespirv))
+	{
+		compileSpirv(glsl, spirv14, stagespirv);
+		vgfx->addCachedSpirv(cachekey, stagespirv);
+	}
+
+	BindingMapper bindingMapper(spv::DecorationBinding);
+	BindingMapper ioLocationMapper(spv::DecorationLocation);
+	BindingMapper vertexInputLocationMapper(spv::DecorationLocation);
+
+	for (int i = 0; i < SHADERSTAGE_MAX_ENUM; i++)
+	{
+		auto shaderStage = (ShaderStageType)i;
+
+		if (stagespirv[i].empty())
+			continue;
 
-		GlslangToSpv(*intermediate, spirv, &logger, &opt);
+		std::vector<uint32> &spirv = stagespirv[i];
 
 		auto compiler = std::make_unique<spirv_cross::CompilerGLSL>(spirv);
 		auto &comp = *compiler;
@@ -173,6 +173,11 @@ class Shader final
 	const std::vector<TextureInfo> &getActiveTextureInfo() const { return allTextureInfo; }
 	const std::vector<BufferInfo> &getActiveStorageBufferInfo() const { return storageBufferInfo; }
 
+	// Neither of these touch any Graphics state, so they're safe to call from
+	// other threads. Empty strings in the glsl array are unused stages.
+	static std::string getSpirvCacheKey(const std::string glsl[SHADERSTAGE_MAX_ENUM], bool spirv14);
+	static void compileSpirv(const std::string glsl[SHADERSTAGE_MAX_ENUM], bool spirv14, std::vector<uint32> spirv[SHADERSTAGE_MAX_ENUM]);
+
 private:
 	void compileShaders();
 	void createDescriptorSetLayout();
@@ -24,6 +24,7 @@
 #include "Buffer.h"
 
 #include <limits>
+#include <numeric>
 
 namespace love
 {
@@ -38,7 +39,8 @@ Texture::Texture(love::graphics::Graphics *gfx, const Settings &settings, const
 	, slices(settings.type)
 	, imageAspect(0)
 {
-	if (data)
+	// Async textures receive their data through queued uploads instead.
+	if (data && !settings.async)
 		slices = *data;
 
 	loadVolatile();
@@ -543,25 +545,41 @@ void Texture::generateMipmapsInternal()
 
 void Texture::uploadByteData(const void *data, size_t size, int level, int slice, const Rect &r)
 {
-	VkBuffer stagingBuffer;
-	VmaAllocation vmaAllocation;
+	VkBuffer stagingBuffer = VK_NULL_HANDLE;
+	VmaAllocation vmaAllocation = VK_NULL_HANDLE;
+	VkDeviceSize stagingOffset = 0;
+	void *stagingData = nullptr;
 
-	VkBufferCreateInfo bufferCreateInfo{};
-	bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-	bufferCreateInfo.size = size;
-	bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	// Buffer offsets for copies to images must be a multiple of both the texel
+	// block size and 4.
+	VkDeviceSize alignment = std::lcm((VkDeviceSize) getPixelFormatInfo(format).blockSize, (VkDeviceSize) 4);
 
-	VmaAllocationCreateInfo allocCreateInfo = {};
-	allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
-	allocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+	if (vgfx->allocateStagingMemory(size, alignment, stagingBuffer, stagingOffset, stagingData))
+	{
+		memcpy(stagingData, data, size);
+		vgfx->flushStagingMemory(stagingOffset, size);
+	}
+	else
+	{
+		// Too big for the staging ring (or it's full for this frame), so use a
+		// dedicated staging buffer.
+		VkBufferCreateInfo bufferCreateInfo{};
+		bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bufferCreateInfo.size = size;
+		bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 
-	VmaAllocationInfo allocInfo;
-	vmaCreateBuffer(allocator, &bufferCreateInfo, &allocCreateInfo, &stagingBuffer, &vmaAllocation, &allocInfo);
+		VmaAllocationCreateInfo allocCreateInfo = {};
+		allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+		allocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
 
-	memcpy(allocInfo.pMappedData, data, size);
+		VmaAllocationInfo allocInfo;
+		vmaCreateBuffer(allocator, &bufferCreateInfo, &allocCreateInfo, &stagingBuffer, &vmaAllocation, &allocInfo);
+
+		memcpy(allocInfo.pMappedData, data, size);
+	}
 
 	VkBufferImageCopy region{};
-	region.bufferOffset = 0;
+	region.bufferOffset = stagingOffset;
 	region.bufferRowLength = 0;
 	region.bufferImageHeight = 0;
 
@@ -616,9 +634,12 @@ void Texture::uploadByteData(const void *data, size_t size, int level, int slice
 			&region
 		);
 
-	vgfx->queueCleanUp([allocator = allocator, stagingBuffer, vmaAllocation]() {
-		vmaDestroyBuffer(allocator, stagingBuffer, vmaAllocation);
-	});
+	if (vmaAllocation != VK_NULL_HANDLE)
+	{
+		vgfx->queueCleanUp([allocator = allocator, stagingBuffer, vmaAllocation]() {
+			vmaDestroyBuffer(allocator, stagingBuffer, vmaAllocation);
+		});
+	}
 }
 
 void Texture::copyFromBuffer(graphics::Buffer *source, size_t sourceoffset, int sourcewidth, size_t size, int slice, int mipmap, const Rect &rect)
@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+
+// LOVE
+#include "wrap_AsyncShader.h"
+
+namespace love
+{
+namespace graphics
+{
+
+AsyncShader *luax_checkasyncshader(lua_State *L, int idx)
+{
+	return luax_checktype<AsyncShader>(L, idx);
+}
+
+static int pushShaderOrError(lua_State *L, AsyncShader *s)
+{
+	if (s->hasError())
+	{
+		luax_getfunction(L, "graphics", "_transformGLSLErrorMessages");
+		lua_pushstring(L, s->getError().c_str());
+
+		// Function pushes the new error string onto the stack.
+		lua_pcall(L, 1, 1, 0);
+		return lua_error(L);
+	}
+
+	luax_pushtype(L, s->getShader());
+	return 1;
+}
+
+int w_AsyncShader_isReady(lua_State *L)
+{
+	AsyncShader *s = luax_checkasyncshader(L, 1);
+	s->update();
+	luax_pushboolean(L, s->isComplete());
+	return 1;
+}
+
+int w_AsyncShader_wait(lua_State *L)
+{
+	AsyncShader *s = luax_checkasyncshader(L, 1);
+	s->wait();
+	return pushShaderOrError(L, s);
+}
+
+int w_AsyncShader_getShader(lua_State *L)
+{
+	AsyncShader *s = luax_checkasyncshader(L, 1);
+	s->update();
+	if (!s->isComplete())
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+	return pushShaderOrError(L, s);
+}
+
+int w_AsyncShader_getFallback(lua_State *L)
+{
+	AsyncShader *s = luax_checkasyncshader(L, 1);
+	luax_pushtype(L, s->getFallback());
+	return 1;
+}
+
+int w_AsyncShader_getError(lua_State *L)
+{
+	AsyncShader *s = luax_checkasyncshader(L, 1);
+	s->update();
+	if (s->hasError())
+		luax_pushstring(L, s->getError());
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+static const luaL_Reg w_AsyncShader_functions[] =
+{
+	{ "isReady", w_AsyncShader_isReady },
+	{ "wait", w_AsyncShader_wait },
+	{ "getShader", w_AsyncShader_getShader },
+	{ "getFallback", w_AsyncShader_getFallback },
+	{ "getError", w_AsyncShader_getError },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_asyncshader(lua_State *L)
+{
+	return luax_register_type(L, &AsyncShader::type, w_AsyncShader_functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -264,6 +264,35 @@ int w_Font_getDPIScale(lua_State *L)
 	return 1;
 }
 
+int w_Font_isSDF(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	luax_pushboolean(L, t->isSDF());
+	return 1;
+}
+
+int w_Font_getAtlasStats(lua_State *L)
+{
+	Font *t = luax_checkfont(L, 1);
+	Font::AtlasStats stats = t->getAtlasStats();
+
+	lua_createtable(L, 0, 4);
+
+	lua_pushinteger(L, stats.textures);
+	lua_setfield(L, -2, "textures");
+
+	lua_pushinteger(L, stats.glyphs);
+	lua_setfield(L, -2, "glyphs");
+
+	lua_pushnumber(L, stats.totalArea > 0 ? (double) stats.usedArea / (double) stats.totalArea : 0.0);
+	lua_setfield(L, -2, "occupancy");
+
+	lua_pushnumber(L, (lua_Number) stats.evictions);
+	lua_setfield(L, -2, "evictions");
+
+	return 1;
+}
+
 static const luaL_Reg w_Font_functions[] =
 {
 	{ "getHeight", w_Font_getHeight },
@@ -280,6 +309,8 @@ static const luaL_Reg w_Font_functions[] =
 	{ "getKerning", w_Font_getKerning },
 	{ "setFallbacks", w_Font_setFallbacks },
 	{ "getDPIScale", w_Font_getDPIScale },
+	{ "isSDF", w_Font_isSDF },
+	{ "getAtlasStats", w_Font_getAtlasStats },
 	{ 0, 0 }
 };
 
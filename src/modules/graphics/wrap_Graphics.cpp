@@ -742,7 +742,12 @@ static int w__pushNewTexture(lua_State *L, Texture::Slices *slices, const Textur
 {
 	StrongRef<Texture> i;
 	luax_catchexcept(L,
-		[&]() { i.set(instance()->newTexture(settings, slices), Acquire::NORETAIN); },
+		[&]()
+		{
+			i.set(instance()->newTexture(settings, slices), Acquire::NORETAIN);
+			if (settings.async && slices != nullptr)
+				i->replaceSlicesAsync(*slices);
+		},
 		[&](bool) { if (slices) slices->clear(); }
 	);
 
@@ -855,6 +860,8 @@ static void luax_checktexturesettings(lua_State *L, int idx, bool opt, bool chec
 		s.readable.set(luax_checkboolean(L, -1));
 	lua_pop(L, 1);
 
+	s.async = luax_boolflag(L, idx, Texture::getConstant(Texture::SETTING_ASYNC), s.async);
+
 	lua_getfield(L, idx, Texture::getConstant(Texture::SETTING_DPI_SCALE));
 	if (lua_isnumber(L, -1))
 	{
@@ -1435,16 +1442,18 @@ int w_newSpriteBatch(lua_State *L)
 	Texture *texture = luax_checktexture(L, 1);
 	int size = (int) luaL_optinteger(L, 2, 1000);
 	BufferDataUsage usage = BUFFERDATAUSAGE_DYNAMIC;
-	if (lua_gettop(L) > 2)
+	if (!lua_isnoneornil(L, 3))
 	{
 		const char *usagestr = luaL_checkstring(L, 3);
 		if (!getConstant(usagestr, usage))
 			return luax_enumerror(L, "usage hint", getConstants(usage), usagestr);
 	}
 
+	bool instanced = luax_optboolean(L, 4, false);
+
 	SpriteBatch *t = nullptr;
 	luax_catchexcept(L,
-		[&](){ t = instance()->newSpriteBatch(texture, size, usage); }
+		[&](){ t = instance()->newSpriteBatch(texture, size, usage, instanced); }
 	);
 
 	luax_pushtype(L, t);
@@ -1471,6 +1480,26 @@ int w_newParticleSystem(lua_State *L)
 	return 1;
 }
 
+int w_updateParticleSystems(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	float dt = (float) luaL_checknumber(L, 2);
+
+	std::vector<ParticleSystem *> systems;
+	int count = (int) luax_objlen(L, 1);
+	systems.reserve(count);
+
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 1, i);
+		systems.push_back(luax_checkparticlesystem(L, -1));
+		lua_pop(L, 1);
+	}
+
+	luax_catchexcept(L, [&](){ instance()->updateParticleSystems(systems, dt); });
+	return 0;
+}
+
 static int w_getShaderSource(lua_State *L, int startidx, std::vector<std::string> &stages, Shader::CompileOptions &options)
 {
 	using namespace love::filesystem;
@@ -1623,6 +1652,32 @@ int w_newShader(lua_State *L)
 	return 1;
 }
 
+int w_newShaderAsync(lua_State *L)
+{
+	std::vector<std::string> stages;
+	Shader::CompileOptions options;
+	w_getShaderSource(L, 1, stages, options);
+
+	// File arguments have been replaced by their contents at this point.
+	int optionsidx = lua_isstring(L, 2) ? 3 : 2;
+
+	Shader *fallback = nullptr;
+	if (lua_istable(L, optionsidx))
+	{
+		lua_getfield(L, optionsidx, "fallback");
+		if (!lua_isnoneornil(L, -1))
+			fallback = luax_checkshader(L, -1);
+		lua_pop(L, 1);
+	}
+
+	AsyncShader *shader = nullptr;
+	luax_catchexcept(L, [&]() { shader = instance()->newShaderAsync(stages, options, fallback); });
+
+	luax_pushtype(L, shader);
+	shader->release();
+	return 1;
+}
+
 int w_newComputeShader(lua_State* L)
 {
 	std::vector<std::string> stages;
@@ -2458,6 +2513,18 @@ int w_readbackTextureAsync(lua_State *L)
 	return 1;
 }
 
+int w_newReadbackRing(lua_State *L)
+{
+	int size = (int) luaL_checkinteger(L, 1);
+
+	ReadbackRing *r = nullptr;
+	luax_catchexcept(L, [&]() { r = instance()->newReadbackRing(size); });
+
+	luax_pushtype(L, r);
+	r->release();
+	return 1;
+}
+
 int w_setColor(lua_State *L)
 {
 	Colorf c;
@@ -2939,6 +3006,54 @@ int w_isWireframe(lua_State *L)
 	return 1;
 }
 
+int w_setMultiTextureBatching(lua_State *L)
+{
+	instance()->setMultiTextureBatching(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isMultiTextureBatching(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isMultiTextureBatching());
+	return 1;
+}
+
+int w_beginBatchScope(lua_State *L)
+{
+	Graphics::BatchScopeMode mode = Graphics::BATCHSCOPE_SORTED;
+	const char *mname = lua_isnoneornil(L, 1) ? nullptr : luaL_checkstring(L, 1);
+	if (mname && !Graphics::getConstant(mname, mode))
+		return luax_enumerror(L, "batch scope mode", Graphics::getConstants(mode), mname);
+
+	luax_catchexcept(L, [&](){ instance()->beginBatchScope(mode); });
+	return 0;
+}
+
+int w_endBatchScope(lua_State *L)
+{
+	luax_catchexcept(L, [&](){ instance()->endBatchScope(); });
+	return 0;
+}
+
+int w_isBatchScopeActive(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isBatchScopeActive());
+	return 1;
+}
+
+int w_setBatchLayer(lua_State *L)
+{
+	int layer = (int) luaL_checkinteger(L, 1);
+	luax_catchexcept(L, [&](){ instance()->setBatchLayer(layer); });
+	return 0;
+}
+
+int w_getBatchLayer(lua_State *L)
+{
+	lua_pushinteger(L, instance()->getBatchLayer());
+	return 1;
+}
+
 int w_setShader(lua_State *L)
 {
 	if (lua_isnoneornil(L,1))
@@ -2947,6 +3062,20 @@ int w_setShader(lua_State *L)
 		return 0;
 	}
 
+	if (luax_istype(L, 1, AsyncShader::type))
+	{
+		// Uses the fallback (or the default shader) until compilation is done.
+		AsyncShader *async = luax_checkasyncshader(L, 1);
+		async->update();
+
+		Shader *shader = async->getActiveShader();
+		if (shader != nullptr)
+			instance()->setShader(shader);
+		else
+			instance()->setShader();
+		return 0;
+	}
+
 	Shader *shader = luax_checkshader(L, 1);
 	instance()->setShader(shader);
 	return 0;
@@ -3183,6 +3312,9 @@ int w_getStats(lua_State *L)
 	lua_pushinteger(L, stats.drawCallsBatched);
 	lua_setfield(L, -2, "drawcallsbatched");
 
+	lua_pushinteger(L, stats.drawCallsBatchedUint32);
+	lua_setfield(L, -2, "drawcallsbatcheduint32");
+
 	lua_pushinteger(L, stats.renderTargetSwitches);
 	lua_setfield(L, -2, "canvasswitches");
 
@@ -3207,6 +3339,72 @@ int w_getStats(lua_State *L)
 	return 1;
 }
 
+int w_setFrameTimingEnabled(lua_State *L)
+{
+	instance()->setFrameTimingEnabled(luax_checkboolean(L, 1));
+	return 0;
+}
+
+int w_isFrameTimingEnabled(lua_State *L)
+{
+	luax_pushboolean(L, instance()->isFrameTimingEnabled());
+	return 1;
+}
+
+int w_pushTimingScope(lua_State *L)
+{
+	const char *name = luaL_checkstring(L, 1);
+	luax_catchexcept(L, [&]() { instance()->pushTimingScope(name); });
+	return 0;
+}
+
+int w_popTimingScope(lua_State *L)
+{
+	luax_catchexcept(L, [&]() { instance()->popTimingScope(); });
+	return 0;
+}
+
+static void pushTimingScopeTable(lua_State *L, const Graphics::TimingScope &scope)
+{
+	lua_createtable(L, 0, 5);
+
+	luax_pushstring(L, scope.name);
+	lua_setfield(L, -2, "name");
+
+	lua_pushnumber(L, scope.cpuTime);
+	lua_setfield(L, -2, "cputime");
+
+	if (scope.gpuTime >= 0.0)
+	{
+		lua_pushnumber(L, scope.gpuTime);
+		lua_setfield(L, -2, "gputime");
+	}
+
+	lua_pushinteger(L, scope.calls);
+	lua_setfield(L, -2, "calls");
+
+	lua_createtable(L, (int) scope.children.size(), 0);
+	for (size_t i = 0; i < scope.children.size(); i++)
+	{
+		pushTimingScopeTable(L, scope.children[i]);
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+	lua_setfield(L, -2, "children");
+}
+
+int w_getFrameTimings(lua_State *L)
+{
+	Graphics::TimingScope timings;
+	if (!instance()->getFrameTimings(timings))
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	pushTimingScopeTable(L, timings);
+	return 1;
+}
+
 int w_draw(lua_State *L)
 {
 	Drawable *drawable = nullptr;
@@ -4027,7 +4225,9 @@ static const luaL_Reg functions[] =
 	{ "newImageFont", w_newImageFont },
 	{ "newSpriteBatch", w_newSpriteBatch },
 	{ "newParticleSystem", w_newParticleSystem },
+	{ "updateParticleSystems", w_updateParticleSystems },
 	{ "newShader", w_newShader },
+	{ "newShaderAsync", w_newShaderAsync },
 	{ "newComputeShader", w_newComputeShader },
 	{ "newBuffer", w_newBuffer },
 	{ "newMesh", w_newMesh },
@@ -4038,6 +4238,7 @@ static const luaL_Reg functions[] =
 	{ "readbackBufferAsync", w_readbackBufferAsync },
 	{ "readbackTexture", w_readbackTexture },
 	{ "readbackTextureAsync", w_readbackTextureAsync },
+	{ "newReadbackRing", w_newReadbackRing },
 
 	{ "validateShader", w_validateShader },
 
@@ -4080,6 +4281,14 @@ static const luaL_Reg functions[] =
 	{ "setWireframe", w_setWireframe },
 	{ "isWireframe", w_isWireframe },
 
+	{ "setMultiTextureBatching", w_setMultiTextureBatching },
+	{ "isMultiTextureBatching", w_isMultiTextureBatching },
+	{ "beginBatchScope", w_beginBatchScope },
+	{ "endBatchScope", w_endBatchScope },
+	{ "isBatchScopeActive", w_isBatchScopeActive },
+	{ "setBatchLayer", w_setBatchLayer },
+	{ "getBatchLayer", w_getBatchLayer },
+
 	{ "setShader", w_setShader },
 	{ "getShader", w_getShader },
 
@@ -4089,6 +4298,11 @@ static const luaL_Reg functions[] =
 	{ "getSystemLimits", w_getSystemLimits },
 	{ "getTextureTypes", w_getTextureTypes },
 	{ "getStats", w_getStats },
+	{ "setFrameTimingEnabled", w_setFrameTimingEnabled },
+	{ "isFrameTimingEnabled", w_isFrameTimingEnabled },
+	{ "pushTimingScope", w_pushTimingScope },
+	{ "popTimingScope", w_popTimingScope },
+	{ "getFrameTimings", w_getFrameTimings },
 
 	{ "captureScreenshot", w_captureScreenshot },
 
@@ -4182,9 +4396,11 @@ static const lua_CFunction types[] =
 	luaopen_quad,
 	luaopen_graphicsbuffer,
 	luaopen_graphicsreadback,
+	luaopen_readbackring,
 	luaopen_spritebatch,
 	luaopen_particlesystem,
 	luaopen_shader,
+	luaopen_asyncshader,
 	luaopen_mesh,
 	luaopen_textbatch,
 	luaopen_video,
@@ -33,6 +33,8 @@
 #include "wrap_Video.h"
 #include "wrap_Buffer.h"
 #include "wrap_GraphicsReadback.h"
+#include "wrap_ReadbackRing.h"
+#include "wrap_AsyncShader.h"
 #include "Graphics.h"
 
 namespace love
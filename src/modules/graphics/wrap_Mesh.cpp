@@ -43,6 +43,42 @@ int w_Mesh_setVertices(lua_State *L)
 
 	int vertstart = (int) luaL_optnumber(L, 3, 1) - 1;
 
+	// setVertices(data, startvertex, {{first, count}, ...}) only copies the
+	// given vertex ranges out of the data.
+	if (lua_istable(L, 4))
+	{
+		Data *d = luax_checktype<Data>(L, 2);
+
+		if (vertstart < 0)
+			return luaL_error(L, "Invalid vertex start index: %d", vertstart + 1);
+
+		std::vector<Range> ranges;
+		int rangecount = (int) luax_objlen(L, 4);
+		ranges.reserve(rangecount);
+
+		for (int i = 1; i <= rangecount; i++)
+		{
+			lua_rawgeti(L, 4, i);
+			luaL_checktype(L, -1, LUA_TTABLE);
+			lua_rawgeti(L, -1, 1);
+			lua_rawgeti(L, -2, 2);
+
+			int first = (int) luaL_checkinteger(L, -2) - 1;
+			int count = (int) luaL_checkinteger(L, -1);
+			if (first < 0 || count <= 0)
+				return luaL_error(L, "Invalid vertex range (first vertex %d, count %d).", first + 1, count);
+
+			ranges.push_back(Range((size_t) first, (size_t) count));
+			lua_pop(L, 3);
+		}
+
+		luax_catchexcept(L, [&]() {
+			t->setVertices(d->getData(), d->getSize(), vertstart, ranges);
+			t->flush();
+		});
+		return 0;
+	}
+
 	int vertcount = -1;
 	if (!lua_isnoneornil(L, 4))
 	{
@@ -24,6 +24,7 @@
 
 #include "Texture.h"
 #include "wrap_Texture.h"
+#include "math/wrap_RandomGenerator.h"
 
 // C
 #include <cstring>
@@ -106,6 +107,27 @@ int w_ParticleSystem_getInsertMode(lua_State *L)
 	return 1;
 }
 
+int w_ParticleSystem_setSimulationMode(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	ParticleSystem::SimulationMode mode;
+	const char *str = luaL_checkstring(L, 2);
+	if (!ParticleSystem::getConstant(str, mode))
+		return luax_enumerror(L, "simulation mode", ParticleSystem::getConstants(mode), str);
+	luax_catchexcept(L, [&](){ t->setSimulationMode(mode); });
+	return 0;
+}
+
+int w_ParticleSystem_getSimulationMode(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	const char *str;
+	if (!ParticleSystem::getConstant(t->getSimulationMode(), str))
+		return luaL_error(L, "Unknown simulation mode");
+	lua_pushstring(L, str);
+	return 1;
+}
+
 int w_ParticleSystem_setEmissionRate(lua_State *L)
 {
 	ParticleSystem *t = luax_checkparticlesystem(L, 1);
@@ -597,7 +619,7 @@ int w_ParticleSystem_setQuads(lua_State *L)
 		}
 	}
 
-	t->setQuads(quads);
+	luax_catchexcept(L, [&](){ t->setQuads(quads); });
 	return 0;
 }
 
@@ -662,7 +684,7 @@ int w_ParticleSystem_pause(lua_State *L)
 int w_ParticleSystem_reset(lua_State *L)
 {
 	ParticleSystem *t = luax_checkparticlesystem(L, 1);
-	t->reset();
+	luax_catchexcept(L, [&](){ t->reset(); });
 	return 0;
 }
 
@@ -670,7 +692,7 @@ int w_ParticleSystem_emit(lua_State *L)
 {
 	ParticleSystem *t = luax_checkparticlesystem(L, 1);
 	int num = (int) luaL_checkinteger(L, 2);
-	t->emit(num);
+	luax_catchexcept(L, [&](){ t->emit(num); });
 	return 0;
 }
 
@@ -699,10 +721,26 @@ int w_ParticleSystem_update(lua_State *L)
 {
 	ParticleSystem *t = luax_checkparticlesystem(L, 1);
 	float dt = (float)luaL_checknumber(L, 2);
-	t->update(dt);
+	luax_catchexcept(L, [&](){ t->update(dt); });
+	return 0;
+}
+
+int w_ParticleSystem_setRandomSeed(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	luax_catchexcept(L, [&](){ t->setRandomSeed(math::luax_checkrandomseed(L, 2)); });
 	return 0;
 }
 
+int w_ParticleSystem_getRandomSeed(lua_State *L)
+{
+	ParticleSystem *t = luax_checkparticlesystem(L, 1);
+	math::RandomGenerator::Seed s = t->getRandomSeed();
+	lua_pushnumber(L, (lua_Number) s.b32.low);
+	lua_pushnumber(L, (lua_Number) s.b32.high);
+	return 2;
+}
+
 static const luaL_Reg w_ParticleSystem_functions[] =
 {
 	{ "clone", w_ParticleSystem_clone },
@@ -712,6 +750,8 @@ static const luaL_Reg w_ParticleSystem_functions[] =
 	{ "getBufferSize", w_ParticleSystem_getBufferSize },
 	{ "setInsertMode", w_ParticleSystem_setInsertMode },
 	{ "getInsertMode", w_ParticleSystem_getInsertMode },
+	{ "setSimulationMode", w_ParticleSystem_setSimulationMode },
+	{ "getSimulationMode", w_ParticleSystem_getSimulationMode },
 	{ "setEmissionRate", w_ParticleSystem_setEmissionRate },
 	{ "getEmissionRate", w_ParticleSystem_getEmissionRate },
 	{ "setEmitterLifetime", w_ParticleSystem_setEmitterLifetime },
@@ -765,6 +805,8 @@ static const luaL_Reg w_ParticleSystem_functions[] =
 	{ "isPaused", w_ParticleSystem_isPaused },
 	{ "isStopped", w_ParticleSystem_isStopped },
 	{ "update", w_ParticleSystem_update },
+	{ "setRandomSeed", w_ParticleSystem_setRandomSeed },
+	{ "getRandomSeed", w_ParticleSystem_getRandomSeed },
 
 	{ 0, 0 }
 };
@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+// LOVE
+#include "wrap_ReadbackRing.h"
+#include "wrap_Buffer.h"
+#include "wrap_Texture.h"
+#include "thread/wrap_Channel.h"
+
+namespace love
+{
+namespace graphics
+{
+
+ReadbackRing *luax_checkreadbackring(lua_State *L, int idx)
+{
+	return luax_checktype<ReadbackRing>(L, idx);
+}
+
+int w_ReadbackRing_readbackBuffer(lua_State *L)
+{
+	ReadbackRing *r = luax_checkreadbackring(L, 1);
+	Buffer *b = luax_checkbuffer(L, 2);
+	lua_Integer offset = luaL_optinteger(L, 3, 0);
+	lua_Integer size = luaL_optinteger(L, 4, b->getSize() - offset);
+
+	bool success = false;
+	luax_catchexcept(L, [&]() { success = r->readbackBuffer(b, offset, size); });
+
+	luax_pushboolean(L, success);
+	return 1;
+}
+
+int w_ReadbackRing_readbackTexture(lua_State *L)
+{
+	ReadbackRing *r = luax_checkreadbackring(L, 1);
+	Texture *t = luax_checktexture(L, 2);
+
+	int slice = 0;
+	if (t->getTextureType() != TEXTURE_2D)
+		slice = (int) luaL_checkinteger(L, 3) - 1;
+
+	int mipmap = (int) luaL_optinteger(L, 4, 1) - 1;
+
+	Rect rect = {0, 0, t->getPixelWidth(mipmap), t->getPixelHeight(mipmap)};
+	if (!lua_isnoneornil(L, 5))
+	{
+		rect.x = (int) luaL_checkinteger(L, 5);
+		rect.y = (int) luaL_checkinteger(L, 6);
+		rect.w = (int) luaL_checkinteger(L, 7);
+		rect.h = (int) luaL_checkinteger(L, 8);
+	}
+
+	bool success = false;
+	luax_catchexcept(L, [&]() { success = r->readbackTexture(t, slice, mipmap, rect); });
+
+	luax_pushboolean(L, success);
+	return 1;
+}
+
+int w_ReadbackRing_pop(lua_State *L)
+{
+	ReadbackRing *r = luax_checkreadbackring(L, 1);
+
+	love::Type *type = nullptr;
+	Data *data = nullptr;
+	luax_catchexcept(L, [&]() { data = r->pop(type); });
+
+	if (data != nullptr)
+		luax_pushtype(L, *type, data);
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+int w_ReadbackRing_update(lua_State *L)
+{
+	ReadbackRing *r = luax_checkreadbackring(L, 1);
+	luax_catchexcept(L, [&]() { r->update(); });
+	return 0;
+}
+
+int w_ReadbackRing_setChannel(lua_State *L)
+{
+	ReadbackRing *r = luax_checkreadbackring(L, 1);
+	love::thread::Channel *channel = nullptr;
+	if (!lua_isnoneornil(L, 2))
+		channel = love::thread::luax_checkchannel(L, 2);
+	r->setChannel(channel);
+	return 0;
+}
+
+int w_ReadbackRing_getChannel(lua_State *L)
+{
+	ReadbackRing *r = luax_checkreadbackring(L, 1);
+	luax_pushtype(L, r->getChannel());
+	return 1;
+}
+
+int w_ReadbackRing_getSize(lua_State *L)
+{
+	ReadbackRing *r = luax_checkreadbackring(L, 1);
+	lua_pushinteger(L, r->getSize());
+	return 1;
+}
+
+int w_ReadbackRing_getPendingCount(lua_State *L)
+{
+	ReadbackRing *r = luax_checkreadbackring(L, 1);
+	lua_pushinteger(L, r->getPendingCount());
+	return 1;
+}
+
+int w_ReadbackRing_getDroppedCount(lua_State *L)
+{
+	ReadbackRing *r = luax_checkreadbackring(L, 1);
+	lua_pushinteger(L, r->getDroppedCount());
+	return 1;
+}
+
+static const luaL_Reg w_ReadbackRing_functions[] =
+{
+	{ "readbackBuffer", w_ReadbackRing_readbackBuffer },
+	{ "readbackTexture", w_ReadbackRing_readbackTexture },
+	{ "pop", w_ReadbackRing_pop },
+	{ "update", w_ReadbackRing_update },
+	{ "setChannel", w_ReadbackRing_setChannel },
+	{ "getChannel", w_ReadbackRing_getChannel },
+	{ "getSize", w_ReadbackRing_getSize },
+	{ "getPendingCount", w_ReadbackRing_getPendingCount },
+	{ "getDroppedCount", w_ReadbackRing_getDroppedCount },
+	{ 0, 0 }
+};
+
+extern "C" int luaopen_readbackring(lua_State *L)
+{
+	return luax_register_type(L, &ReadbackRing::type, w_ReadbackRing_functions, nullptr);
+}
+
+} // graphics
+} // love
@@ -122,6 +122,99 @@ int w_SpriteBatch_setLayer(lua_State *L)
 	return 0;
 }
 
+// Reads (transforms [, quads] [, count]) starting at startidx, and calls func
+// with the sprites. Transforms are either a Data of packed SpriteTransforms or
+// a flat table of numbers, 8 per sprite.
+template <typename T>
+static void w_SpriteBatch_checkTransforms(lua_State *L, int startidx, const T &func)
+{
+	std::vector<Quad *> quads;
+
+	if (!lua_isnoneornil(L, startidx + 1))
+	{
+		luaL_checktype(L, startidx + 1, LUA_TTABLE);
+		int quadcount = (int) luax_objlen(L, startidx + 1);
+		quads.reserve(quadcount);
+
+		for (int i = 1; i <= quadcount; i++)
+		{
+			lua_rawgeti(L, startidx + 1, i);
+			quads.push_back(luax_checktype<Quad>(L, -1));
+			lua_pop(L, 1);
+		}
+	}
+
+	const int components = sizeof(SpriteBatch::SpriteTransform) / sizeof(float);
+
+	if (luax_istype(L, startidx, Data::type))
+	{
+		Data *d = luax_totype<Data>(L, startidx, Data::type);
+
+		int maxcount = (int) (d->getSize() / sizeof(SpriteBatch::SpriteTransform));
+		int count = (int) luaL_optinteger(L, startidx + 2, maxcount);
+
+		if (count < 0 || count > maxcount)
+			luaL_error(L, "Invalid sprite count: %d (Data holds %d sprites)", count, maxcount);
+
+		luax_catchexcept(L, [&]() { func((const SpriteBatch::SpriteTransform *) d->getData(), count, quads); });
+		return;
+	}
+
+	luaL_checktype(L, startidx, LUA_TTABLE);
+
+	int len = (int) luax_objlen(L, startidx);
+	if (len % components != 0)
+		luaL_error(L, "Sprite transform table length must be a multiple of %d.", components);
+
+	int maxcount = len / components;
+	int count = (int) luaL_optinteger(L, startidx + 2, maxcount);
+
+	if (count < 0 || count > maxcount)
+		luaL_error(L, "Invalid sprite count: %d (table holds %d sprites)", count, maxcount);
+
+	std::vector<SpriteBatch::SpriteTransform> sprites(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		float *values = &sprites[i].x;
+		for (int c = 0; c < components; c++)
+		{
+			lua_rawgeti(L, startidx, i * components + c + 1);
+			values[c] = (float) luaL_checknumber(L, -1);
+			lua_pop(L, 1);
+		}
+	}
+
+	luax_catchexcept(L, [&]() { func(sprites.data(), count, quads); });
+}
+
+int w_SpriteBatch_addMany(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	int index = 0;
+
+	w_SpriteBatch_checkTransforms(L, 2, [&](const SpriteBatch::SpriteTransform *sprites, int count, const std::vector<Quad *> &quads)
+	{
+		index = t->addMany(sprites, count, quads);
+	});
+
+	lua_pushinteger(L, index + 1);
+	return 1;
+}
+
+int w_SpriteBatch_setMany(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	w_SpriteBatch_checkTransforms(L, 3, [&](const SpriteBatch::SpriteTransform *sprites, int count, const std::vector<Quad *> &quads)
+	{
+		t->setMany(index, sprites, count, quads);
+	});
+
+	return 0;
+}
+
 int w_SpriteBatch_clear(lua_State *L)
 {
 	SpriteBatch *t = luax_checkspritebatch(L, 1);
@@ -207,6 +300,13 @@ int w_SpriteBatch_getBufferSize(lua_State *L)
 	return 1;
 }
 
+int w_SpriteBatch_isInstanced(lua_State *L)
+{
+	SpriteBatch *t = luax_checkspritebatch(L, 1);
+	luax_pushboolean(L, t->isInstanced());
+	return 1;
+}
+
 int w_SpriteBatch_attachAttribute(lua_State *L)
 {
 	SpriteBatch *t = luax_checkspritebatch(L, 1);
@@ -266,6 +366,8 @@ static const luaL_Reg w_SpriteBatch_functions[] =
 	{ "set", w_SpriteBatch_set },
 	{ "addLayer", w_SpriteBatch_addLayer },
 	{ "setLayer", w_SpriteBatch_setLayer },
+	{ "addMany", w_SpriteBatch_addMany },
+	{ "setMany", w_SpriteBatch_setMany },
 	{ "clear", w_SpriteBatch_clear },
 	{ "flush", w_SpriteBatch_flush },
 	{ "setTexture", w_SpriteBatch_setTexture },
@@ -274,6 +376,7 @@ static const luaL_Reg w_SpriteBatch_functions[] =
 	{ "getColor", w_SpriteBatch_getColor },
 	{ "getCount", w_SpriteBatch_getCount },
 	{ "getBufferSize", w_SpriteBatch_getBufferSize },
+	{ "isInstanced", w_SpriteBatch_isInstanced },
 	{ "attachAttribute", w_SpriteBatch_attachAttribute },
 	{ "setDrawRange", w_SpriteBatch_setDrawRange },
 	{ "getDrawRange", w_SpriteBatch_getDrawRange },
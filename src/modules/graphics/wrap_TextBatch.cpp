@@ -138,6 +138,33 @@ int w_TextBatch_addf(lua_State *L)
 	return 1;
 }
 
+int w_TextBatch_setAt(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+
+	std::vector<love::font::ColoredString> text;
+	luax_checkcoloredstring(L, 3, text);
+
+	luax_catchexcept(L, [&](){ t->setAt(index, text); });
+	return 0;
+}
+
+int w_TextBatch_remove(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	int index = (int) luaL_checkinteger(L, 2) - 1;
+	luax_catchexcept(L, [&](){ t->remove(index); });
+	return 0;
+}
+
+int w_TextBatch_getTextCount(lua_State *L)
+{
+	TextBatch *t = luax_checktextbatch(L, 1);
+	lua_pushinteger(L, t->getTextCount());
+	return 1;
+}
+
 int w_TextBatch_clear(lua_State *L)
 {
 	TextBatch *t = luax_checktextbatch(L, 1);
@@ -192,6 +219,9 @@ static const luaL_Reg w_TextBatch_functions[] =
 	{ "setf", w_TextBatch_setf },
 	{ "add", w_TextBatch_add },
 	{ "addf", w_TextBatch_addf },
+	{ "setAt", w_TextBatch_setAt },
+	{ "remove", w_TextBatch_remove },
+	{ "getTextCount", w_TextBatch_getTextCount },
 	{ "clear", w_TextBatch_clear },
 	{ "setFont", w_TextBatch_setFont },
 	{ "getFont", w_TextBatch_getFont },
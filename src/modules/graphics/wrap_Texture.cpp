@@ -372,7 +372,7 @@ int w_Texture_generateMipmaps(lua_State *L)
 	return 0;
 }
 
-int w_Texture_replacePixels(lua_State *L)
+static int w__replacePixels(lua_State *L, bool async)
 {
 	Texture *t = luax_checktexture(L, 1);
 
@@ -414,15 +414,44 @@ int w_Texture_replacePixels(lua_State *L)
 		if (srcmip < 0 || srcmip >= cid->getMipmapCount())
 			return luaL_error(L, "Invalid source mipmap level.");
 
-		luax_catchexcept(L, [&](){ t->replacePixels(cid->getSlice(0, srcmip), slice, dstmip, x, y, reloadmipmaps); });
+		luax_catchexcept(L, [&]()
+		{
+			if (async)
+				t->replacePixelsAsync(cid->getSlice(0, srcmip), slice, dstmip, x, y, reloadmipmaps);
+			else
+				t->replacePixels(cid->getSlice(0, srcmip), slice, dstmip, x, y, reloadmipmaps);
+		});
 	}
 	else
 	{
-		luax_catchexcept(L, [&](){ t->replacePixels(id, slice, dstmip, x, y, reloadmipmaps); });
+		luax_catchexcept(L, [&]()
+		{
+			if (async)
+				t->replacePixelsAsync(id, slice, dstmip, x, y, reloadmipmaps);
+			else
+				t->replacePixels(id, slice, dstmip, x, y, reloadmipmaps);
+		});
 	}
 	return 0;
 }
 
+int w_Texture_replacePixels(lua_State *L)
+{
+	return w__replacePixels(L, false);
+}
+
+int w_Texture_replacePixelsAsync(lua_State *L)
+{
+	return w__replacePixels(L, true);
+}
+
+int w_Texture_hasPendingUploads(lua_State *L)
+{
+	Texture *t = luax_checktexture(L, 1);
+	luax_pushboolean(L, t->hasPendingUploads());
+	return 1;
+}
+
 int w_Texture_newImageData(lua_State *L)
 {
 	luax_markdeprecated(L, 1, "Texture:newImageData", API_METHOD, DEPRECATED_RENAMED, "love.graphics.readbackTexture");
@@ -557,6 +586,8 @@ const luaL_Reg w_Texture_functions[] =
 	{ "setDepthSampleMode", w_Texture_setDepthSampleMode },
 	{ "generateMipmaps", w_Texture_generateMipmaps },
 	{ "replacePixels", w_Texture_replacePixels },
+	{ "replacePixelsAsync", w_Texture_replacePixelsAsync },
+	{ "hasPendingUploads", w_Texture_hasPendingUploads },
 	{ "renderTo", w_Texture_renderTo },
 	{ "getDebugName", w_Texture_getDebugName },
 
@@ -30,6 +30,7 @@ love::Type Sound::type("Sound", &Module::type);
 Sound::Sound(const char *name)
 	: Module(M_SOUND, name)
 {
+	workerPool.set(thread::WorkerPool::acquireShared(), Acquire::NORETAIN);
 }
 
 Sound::~Sound()
@@ -51,5 +52,39 @@ SoundData *Sound::newSoundData(void *data, int samples, int sampleRate, int bitD
 	return new SoundData(data, samples, sampleRate, bitDepth, channels);
 }
 
+std::vector<SoundData *> Sound::newSoundDataBatch(const std::vector<Decoder *> &decoders)
+{
+	std::vector<SoundData *> sounddatas(decoders.size(), nullptr);
+
+	try
+	{
+		workerPool->parallelFor(decoders.size(), 1, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				try
+				{
+					sounddatas[i] = new SoundData(decoders[i]);
+				}
+				catch (love::Exception &e)
+				{
+					throw love::Exception("Could not decode sound %d: %s", (int) i + 1, e.what());
+				}
+			}
+		});
+	}
+	catch (love::Exception &)
+	{
+		for (SoundData *sounddata : sounddatas)
+		{
+			if (sounddata != nullptr)
+				sounddata->release();
+		}
+		throw;
+	}
+
+	return sounddatas;
+}
+
 } // sound
 } // love
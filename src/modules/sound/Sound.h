@@ -24,6 +24,7 @@
 // LOVE
 #include "common/Module.h"
 #include "common/Stream.h"
+#include "thread/WorkerPool.h"
 
 #include "SoundData.h"
 #include "Decoder.h"
@@ -77,6 +78,15 @@ class Sound : public Module
 	 **/
 	SoundData *newSoundData(void *data, int samples, int sampleRate, int bitDepth, int channels);
 
+	/**
+	 * Fully decodes several sounds at once, spread across the shared worker
+	 * threads. Each Decoder must only appear once. Can be called from any
+	 * thread.
+	 * @param decoders The files to decode the data from.
+	 * @return A new SoundData object for each Decoder, in the same order.
+	 **/
+	std::vector<SoundData *> newSoundDataBatch(const std::vector<Decoder *> &decoders);
+
 	/**
 	 * Attempts to find a decoder for the encoded sound data in the
 	 * specified file.
@@ -90,6 +100,12 @@ class Sound : public Module
 
 	Sound(const char *name);
 
+private:
+
+	// Acquired when the module is created, since the shared pool can only be
+	// acquired on the main thread and batches can be decoded on any thread.
+	StrongRef<thread::WorkerPool> workerPool;
+
 }; // Sound
 
 } // sound
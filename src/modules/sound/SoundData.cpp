@@ -21,6 +21,7 @@
 #include "SoundData.h"
 
 // C
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 
@@ -47,6 +48,23 @@ SoundData::SoundData(Decoder *decoder)
 		throw love::Exception("Invalid bit depth: %d", decoder->getBitDepth());
 
 	size_t bufferSize = 524288; // 0x80000
+
+	// Seekable formats know their length up front, so the whole sound can be
+	// allocated at once instead of growing the buffer as it's decoded. Leave
+	// room for one extra decoded chunk, in case the duration is rounded down.
+	double duration = decoder->isSeekable() ? decoder->getDuration() : -1.0;
+	if (duration > 0.0)
+	{
+		double frames = std::ceil(duration * decoder->getSampleRate());
+		double bytes = frames * decoder->getChannelCount() * (decoder->getBitDepth() / 8) + decoder->getSize();
+
+		if (bytes < (double) std::numeric_limits<int>::max())
+		{
+			bufferSize = (size_t) bytes;
+			data = (uint8 *) malloc(bufferSize);
+		}
+	}
+
 	int decoded = decoder->decode();
 
 	while (decoded > 0)
@@ -23,6 +23,10 @@
 #include "filesystem/wrap_Filesystem.h"
 #include "data/DataStream.h"
 
+// C++
+#include <algorithm>
+#include <vector>
+
 // Implementations.
 #include "lullaby/Sound.h"
 
@@ -33,22 +37,19 @@ namespace sound
 
 #define instance() (Module::getInstance<Sound>(Module::M_SOUND))
 
-int w_newDecoder(lua_State *L)
+/**
+ * Gets a retained Stream for the filename, File, FileData, Data or Stream at
+ * the given index.
+ **/
+static love::Stream *luax_getdecoderstream(lua_State *L, int idx, Decoder::StreamSource source)
 {
-	int bufferSize = (int)luaL_optinteger(L, 2, Decoder::DEFAULT_BUFFER_SIZE);
 	love::Stream *stream = nullptr;
 
-	if (love::filesystem::luax_cangetfile(L, 1))
+	if (love::filesystem::luax_cangetfile(L, idx))
 	{
-		Decoder::StreamSource source = Decoder::STREAM_FILE;
-
-		const char* sourcestr = lua_isnoneornil(L, 3) ? nullptr : luaL_checkstring(L, 3);
-		if (sourcestr != nullptr && !Decoder::getConstant(sourcestr, source))
-			return luax_enumerror(L, "stream type", Decoder::getConstants(source), sourcestr);
-
 		if (source == Decoder::STREAM_FILE)
 		{
-			auto file = love::filesystem::luax_getfile(L, 1);
+			auto file = love::filesystem::luax_getfile(L, idx);
 			luax_catchexcept(L, [&]() { file->open(love::filesystem::File::MODE_READ); });
 			stream = file;
 		}
@@ -56,22 +57,39 @@ int w_newDecoder(lua_State *L)
 		{
 			luax_catchexcept(L, [&]()
 			{
-				StrongRef<love::filesystem::FileData> data(love::filesystem::luax_getfiledata(L, 1), Acquire::NORETAIN);
+				StrongRef<love::filesystem::FileData> data(love::filesystem::luax_getfiledata(L, idx), Acquire::NORETAIN);
 				stream = new data::DataStream(data);
 			});
 		}
 
 	}
-	else if (luax_istype(L, 1, Data::type))
+	else if (luax_istype(L, idx, Data::type))
 	{
-		Data *data = luax_checktype<Data>(L, 1);
+		Data *data = luax_checktype<Data>(L, idx);
 		luax_catchexcept(L, [&]() { stream = new data::DataStream(data); });
 	}
 	else
 	{
-		stream = luax_checktype<Stream>(L, 1);
+		stream = luax_checktype<Stream>(L, idx);
 		stream->retain();
-	}	
+	}
+
+	return stream;
+}
+
+int w_newDecoder(lua_State *L)
+{
+	int bufferSize = (int)luaL_optinteger(L, 2, Decoder::DEFAULT_BUFFER_SIZE);
+	Decoder::StreamSource source = Decoder::STREAM_FILE;
+
+	if (love::filesystem::luax_cangetfile(L, 1))
+	{
+		const char* sourcestr = lua_isnoneornil(L, 3) ? nullptr : luaL_checkstring(L, 3);
+		if (sourcestr != nullptr && !Decoder::getConstant(sourcestr, source))
+			return luax_enumerror(L, "stream type", Decoder::getConstants(source), sourcestr);
+	}
+
+	love::Stream *stream = luax_getdecoderstream(L, 1, source);
 
 	Decoder *t = nullptr;
 	luax_catchexcept(L,
@@ -115,11 +133,66 @@ int w_newSoundData(lua_State *L)
 	return 1;
 }
 
+int w_newSoundDataBatch(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TTABLE);
+	int count = (int) luax_objlen(L, 1);
+
+	std::vector<StrongRef<Decoder>> decoders;
+	decoders.reserve(count);
+
+	// Decoders are created here, since they read the file headers. Only the
+	// decoding itself happens on the worker threads.
+	for (int i = 1; i <= count; i++)
+	{
+		lua_rawgeti(L, 1, i);
+
+		if (luax_istype(L, -1, Decoder::type))
+			decoders.emplace_back(luax_checkdecoder(L, -1));
+		else
+		{
+			love::Stream *stream = luax_getdecoderstream(L, -1, Decoder::STREAM_FILE);
+
+			Decoder *t = nullptr;
+			luax_catchexcept(L,
+				[&]() { t = instance()->newDecoder(stream, Decoder::DEFAULT_BUFFER_SIZE); },
+				[&](bool) { stream->release(); }
+			);
+
+			decoders.emplace_back(t, Acquire::NORETAIN);
+		}
+
+		lua_pop(L, 1);
+	}
+
+	std::vector<Decoder *> decoderlist;
+	for (const auto &decoder : decoders)
+	{
+		if (std::find(decoderlist.begin(), decoderlist.end(), decoder.get()) != decoderlist.end())
+			return luaL_error(L, "Each Decoder can only be decoded once per batch.");
+		decoderlist.push_back(decoder.get());
+	}
+
+	std::vector<SoundData *> sounddatas;
+	luax_catchexcept(L, [&]() { sounddatas = instance()->newSoundDataBatch(decoderlist); });
+
+	lua_createtable(L, (int) sounddatas.size(), 0);
+	for (size_t i = 0; i < sounddatas.size(); i++)
+	{
+		luax_pushtype(L, sounddatas[i]);
+		sounddatas[i]->release();
+		lua_rawseti(L, -2, (int) i + 1);
+	}
+
+	return 1;
+}
+
 // List of functions to wrap.
 static const luaL_Reg functions[] =
 {
 	{ "newDecoder",  w_newDecoder },
 	{ "newSoundData",  w_newSoundData },
+	{ "newSoundDataBatch",  w_newSoundDataBatch },
 	{ 0, 0 }
 };
 
@@ -0,0 +1,239 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+
+#include "WorkerPool.h"
+
+// C++
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+
+namespace love
+{
+namespace thread
+{
+
+WorkerPool *WorkerPool::shared = nullptr;
+
+WorkerPool::Worker::Worker(WorkerPool *pool, int index)
+	: pool(pool)
+{
+	threadName = "Worker " + std::to_string(index);
+}
+
+void WorkerPool::Worker::threadFunction()
+{
+	Lock lock(pool->mutex);
+
+	while (true)
+	{
+		if (pool->runNextJob())
+			continue;
+
+		if (pool->quit)
+			return;
+
+		pool->jobAvailable->wait(pool->mutex);
+	}
+}
+
+WorkerPool::WorkerPool(int threadcount)
+	: quit(false)
+{
+	for (int i = 0; i < threadcount; i++)
+	{
+		Worker *worker = new Worker(this, i);
+		if (!worker->start())
+		{
+			worker->release();
+			break;
+		}
+		workers.push_back(worker);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		Lock lock(mutex);
+		quit = true;
+		jobAvailable->broadcast();
+	}
+
+	for (Worker *worker : workers)
+	{
+		worker->wait();
+		worker->release();
+	}
+
+	if (shared == this)
+		shared = nullptr;
+}
+
+int WorkerPool::getThreadCount() const
+{
+	return (int) workers.size();
+}
+
+bool WorkerPool::runNextJob()
+{
+	// The mutex must be held by the caller. It's unlocked while the job runs.
+	if (jobs.empty())
+		return false;
+
+	Job job = std::move(jobs.front());
+	jobs.pop_front();
+
+	mutex->unlock();
+
+	try
+	{
+		job();
+	}
+	catch (...)
+	{
+	}
+
+	mutex->lock();
+	return true;
+}
+
+void WorkerPool::submit(const Job &job)
+{
+	if (workers.empty())
+	{
+		try
+		{
+			job();
+		}
+		catch (...)
+		{
+		}
+		return;
+	}
+
+	Lock lock(mutex);
+	jobs.push_back(job);
+	jobAvailable->signal();
+}
+
+void WorkerPool::parallelFor(size_t count, size_t grainsize, const RangeJob &job)
+{
+	if (count == 0)
+		return;
+
+	grainsize = std::max(grainsize, (size_t) 1);
+	size_t rangecount = (count + grainsize - 1) / grainsize;
+
+	if (workers.empty() || rangecount == 1)
+		return job(0, count);
+
+	struct State
+	{
+		std::atomic<size_t> nextRange;
+		size_t finishedRanges = 0;
+		std::exception_ptr error;
+		MutexRef mutex;
+		ConditionalRef done;
+	};
+
+	// Helpers can start after every range is finished and this function has
+	// returned, so the state they share must outlive it. They never touch the
+	// job once all ranges have been claimed.
+	auto state = std::make_shared<State>();
+	state->nextRange = 0;
+
+	// Any participating thread takes the next unclaimed range until there are
+	// none left, so uneven ranges balance out.
+	auto runRanges = [state, rangecount, grainsize, count, &job]()
+	{
+		size_t finished = 0;
+		std::exception_ptr error;
+
+		while (true)
+		{
+			size_t range = state->nextRange++;
+			if (range >= rangecount)
+				break;
+
+			size_t begin = range * grainsize;
+			size_t end = std::min(begin + grainsize, count);
+
+			// Every claimed range counts as finished even if it throws, or the
+			// calling thread would wait forever.
+			try
+			{
+				if (!error)
+					job(begin, end);
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+
+			finished++;
+		}
+
+		if (finished == 0)
+			return;
+
+		Lock lock(state->mutex);
+		if (error && !state->error)
+			state->error = error;
+		state->finishedRanges += finished;
+		if (state->finishedRanges == rangecount)
+			state->done->broadcast();
+	};
+
+	size_t helpers = std::min(workers.size(), rangecount - 1);
+	for (size_t i = 0; i < helpers; i++)
+		submit(runRanges);
+
+	runRanges();
+
+	{
+		Lock lock(state->mutex);
+		while (state->finishedRanges < rangecount)
+			state->done->wait(state->mutex);
+	}
+
+	if (state->error)
+		std::rethrow_exception(state->error);
+}
+
+WorkerPool *WorkerPool::acquireShared()
+{
+	if (shared == nullptr)
+	{
+		// Leave a core for the main thread.
+		int cores = (int) std::thread::hardware_concurrency();
+		shared = new WorkerPool(std::max(cores - 1, 1));
+	}
+	else
+		shared->retain();
+
+	return shared;
+}
+
+} // thread
+} // love
@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2006-2024 LOVE Development Team
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ **/
+
+
+#ifndef LOVE_THREAD_WORKER_POOL_H
+#define LOVE_THREAD_WORKER_POOL_H
+
+// LOVE
+#include "common/config.h"
+#include "common/Object.h"
+#include "threads.h"
+
+// C++
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace love
+{
+namespace thread
+{
+
+/**
+ * A fixed set of worker threads which run jobs for engine code. The pool is
+ * shared by every module that uses it, and its threads are started when it's
+ * first acquired.
+ **/
+class WorkerPool : public love::Object
+{
+public:
+
+	typedef std::function<void()> Job;
+	typedef std::function<void(size_t begin, size_t end)> RangeJob;
+
+	WorkerPool(int threadcount);
+	virtual ~WorkerPool();
+
+	int getThreadCount() const;
+
+	/**
+	 * Queues a job to run on one of the worker threads. Exceptions thrown by
+	 * the job are discarded.
+	 **/
+	void submit(const Job &job);
+
+	/**
+	 * Splits [0, count) into ranges of at most grainsize items, and runs them
+	 * on the worker threads and the calling thread. Returns once every range
+	 * is done. If any range throws, the first exception is rethrown on the
+	 * calling thread after every range has finished.
+	 **/
+	void parallelFor(size_t count, size_t grainsize, const RangeJob &job);
+
+	/**
+	 * Gets the shared pool, creating it if needed. The caller owns a reference
+	 * to the returned pool and must release it when done. Must be called from
+	 * the main thread.
+	 **/
+	static WorkerPool *acquireShared();
+
+private:
+
+	class Worker : public Threadable
+	{
+	public:
+
+		Worker(WorkerPool *pool, int index);
+		virtual ~Worker() {}
+
+		void threadFunction() override;
+
+	private:
+
+		WorkerPool *pool;
+	};
+
+	bool runNextJob();
+
+	MutexRef mutex;
+	ConditionalRef jobAvailable;
+
+	std::deque<Job> jobs;
+	bool quit;
+
+	std::vector<Worker *> workers;
+
+	static WorkerPool *shared;
+
+}; // WorkerPool
+
+} // thread
+} // love
+
+#endif // LOVE_THREAD_WORKER_POOL_H
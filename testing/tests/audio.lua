@@ -101,6 +101,9 @@ love.test.audio.Source = function(test)
   -- change some get/set props that can apply to stereo
   stereo:setPitch(2)
   test:assertEquals(2, stereo:getPitch(), 'check pitch change')
+  test:assertEquals(0, stereo:getPriority(), 'check default priority')
+  stereo:setPriority(5)
+  test:assertEquals(5, stereo:getPriority(), 'check priority change')
 
   -- create mono source
   local mono = love.audio.newSource('resources/clickmono.ogg', 'stream')
@@ -150,6 +153,21 @@ love.test.audio.Source = function(test)
   mono:setRolloff(1)
   test:assertEquals(1, mono:getRolloff(), 'check rolloff set')
 
+  -- streaming playback decodes on the audio decode threads
+  mono:setLooping(true)
+  mono:play()
+  test:assertTrue(mono:isPlaying(), 'check stream playing')
+  mono:seek(0.01, 'seconds')
+  test:assertRange(mono:tell('seconds'), 0, 0.07, 'check stream seek/tell')
+  mono:stop()
+  test:assertFalse(mono:isPlaying(), 'check stream stopped')
+  local monoclone = mono:clone()
+  test:assertEquals(2927, monoclone:getDuration("samples"), 'check cloned stream duration')
+  monoclone:play()
+  test:assertTrue(monoclone:isPlaying(), 'check cloned stream playing')
+  monoclone:stop()
+  mono:setLooping(false)
+
   -- create queue source
   local queue = love.audio.newQueueableSource(44100, 16, 1, 3)
   local sdata = love.sound.newSoundData(1024, 44100, 16, 1)
@@ -332,6 +350,33 @@ love.test.audio.getRecordingDevices = function(test)
 end
 
 
+-- love.audio.getRefillLatencyHistogram
+love.test.audio.getRefillLatencyHistogram = function(test)
+  love.audio.resetRefillLatencyHistogram()
+  local histogram = love.audio.getRefillLatencyHistogram()
+  test:assertNotNil(histogram)
+  local previous = 0
+  for i, bucket in ipairs(histogram) do
+    test:assertGreaterEqual(previous, bucket[1], 'check bucket ' .. i .. ' limit')
+    test:assertEquals(0, bucket[2], 'check bucket ' .. i .. ' reset')
+    previous = bucket[1]
+  end
+  if #histogram > 0 then
+    test:assertEquals(math.huge, histogram[#histogram][1], 'check last bucket')
+  end
+  -- playing a stream refills its buffers
+  local stream = love.audio.newSource('resources/tone.ogg', 'stream')
+  stream:play()
+  test:waitSeconds(0.5)
+  stream:stop()
+  local refills = 0
+  for _, bucket in ipairs(love.audio.getRefillLatencyHistogram()) do
+    refills = refills + bucket[2]
+  end
+  test:assertGreaterEqual(1, refills, 'check refills recorded')
+end
+
+
 -- love.audio.getVelocity
 love.test.audio.getVelocity = function(test)
   -- check getting values matches what was set
@@ -343,6 +388,43 @@ love.test.audio.getVelocity = function(test)
 end
 
 
+-- love.audio.getVirtualSourceCount
+love.test.audio.getVirtualSourceCount = function(test)
+  love.audio.stop()
+  test:assertEquals(0, love.audio.getVirtualSourceCount(), 'check none virtual')
+  -- play more sources than there are voices
+  local original = love.audio.newSource('resources/click.ogg', 'static')
+  original:setLooping(true)
+  local sources = {}
+  for i=1,80 do
+    sources[i] = original:clone()
+  end
+  sources[80]:setPriority(1)
+  love.audio.play(sources)
+  test:assertEquals(80, love.audio.getActiveSourceCount(), 'check all active')
+  test:assertGreaterEqual(16, love.audio.getVirtualSourceCount(), 'check virtual')
+  for i=1,80 do
+    test:assertTrue(sources[i]:isPlaying(), 'check source ' .. i .. ' playing')
+  end
+  -- sources keep their position while over the voice limit
+  sources[1]:seek(0.1)
+  test:assertRange(sources[1]:tell(), 0.09, 0.2, 'check virtual tell')
+  -- virtual sources get a voice back once other sources stop
+  for i=1,40 do
+    sources[i]:stop()
+  end
+  test:waitSeconds(0.25)
+  test:assertEquals(40, love.audio.getActiveSourceCount(), 'check remaining active')
+  test:assertEquals(0, love.audio.getVirtualSourceCount(), 'check none virtual after stopping')
+  for i=41,80 do
+    test:assertTrue(sources[i]:isPlaying(), 'check source ' .. i .. ' resumed')
+  end
+  love.audio.stop()
+  test:assertEquals(0, love.audio.getVirtualSourceCount(), 'check stopped')
+  test:assertFalse(sources[1]:isPlaying(), 'check source stopped')
+end
+
+
 -- love.audio.getVolume
 love.test.audio.getVolume = function(test)
   -- check getting values matches what was set
@@ -436,6 +518,43 @@ love.test.audio.setEffect = function(test)
 end
 
 
+-- love.audio.setMixBusEnabled
+love.test.audio.setMixBusEnabled = function(test)
+  test:assertFalse(love.audio.isMixBusEnabled(), 'check disabled by default')
+  love.audio.setMixBusEnabled(true)
+  test:assertTrue(love.audio.isMixBusEnabled(), 'check enabled')
+  -- quiet one-shots beyond the voice limit are mixed on the bus
+  local original = love.audio.newSource('resources/click.ogg', 'static')
+  local sources = {}
+  for i=1,80 do
+    sources[i] = original:clone()
+    sources[i]:setVolume(0.1)
+  end
+  love.audio.play(sources)
+  test:assertEquals(80, love.audio.getActiveSourceCount(), 'check all active')
+  love.audio.stop()
+  -- the bus advances the sources it mixes, so they finish
+  local tone = love.audio.newSource('resources/tone.ogg', 'static')
+  local tones = {}
+  for i=1,80 do
+    tones[i] = tone:clone()
+    tones[i]:setVolume(0.1)
+  end
+  love.audio.play(tones)
+  test:waitSeconds(0.25)
+  local virtual, mixed = love.audio.getVirtualSourceCount()
+  test:assertGreaterEqual(1, virtual, 'check virtual tones')
+  test:assertGreaterEqual(1, mixed, 'check tones mixed on the bus')
+  test:assertRange(mixed, 1, virtual, 'check only virtual tones mixed')
+  test:waitSeconds(tone:getDuration() + 0.5)
+  test:assertEquals(0, love.audio.getActiveSourceCount(), 'check mixed tones finished')
+  test:assertEquals(0, love.audio.getVirtualSourceCount(), 'check none virtual after finishing')
+  love.audio.stop()
+  love.audio.setMixBusEnabled(false)
+  test:assertFalse(love.audio.isMixBusEnabled(), 'check disabled')
+end
+
+
 -- love.audio.setMixWithSystem
 love.test.audio.setMixWithSystem = function(test)
   test:assertNotNil(love.audio.setMixWithSystem(true))
@@ -505,6 +624,34 @@ love.test.audio.setPosition = function(test)
 end
 
 
+-- love.audio.setSourceTransforms
+love.test.audio.setSourceTransforms = function(test)
+  local a = love.audio.newSource('resources/clickmono.ogg', 'static')
+  local b = love.audio.newSource('resources/clickmono.ogg', 'static')
+  love.audio.play(a)
+  local packed = love.data.pack('string', 'ffffffffffff',
+    1, 2, 3, 4, 5, 6,
+    -1, -2, -3, 0, 0, 1)
+  love.audio.setSourceTransforms({a, b}, love.data.newByteData(packed))
+  local x, y, z = a:getPosition()
+  test:assertEquals(1, x, 'check a position x')
+  test:assertEquals(2, y, 'check a position y')
+  test:assertEquals(3, z, 'check a position z')
+  x, y, z = a:getVelocity()
+  test:assertEquals(4, x, 'check a velocity x')
+  test:assertEquals(6, z, 'check a velocity z')
+  x, y, z = b:getPosition()
+  test:assertEquals(-1, x, 'check b position x')
+  test:assertEquals(-3, z, 'check b position z')
+  x, y, z = b:getVelocity()
+  test:assertEquals(1, z, 'check b velocity z')
+  -- check the data has to hold a transform for every source
+  local ok = pcall(love.audio.setSourceTransforms, {a, b}, love.data.newByteData(24))
+  test:assertFalse(ok, 'check data too small')
+  love.audio.stop()
+end
+
+
 -- love.audio.setVelocity
 love.test.audio.setVelocity = function(test)
   -- check setting velocity vals are returned
@@ -80,6 +80,11 @@ love.test.font.Rasterizer = function(test)
   test:assertEquals(12, rasterizer:getHeight(), 'check height')
   test:assertEquals(15, rasterizer:getLineHeight(), 'check line height')
 
+  -- check sdf
+  test:assertFalse(rasterizer:isSDF(), 'check not sdf')
+  local sdfrasterizer = love.font.newRasterizer('resources/font.ttf', 16, {sdf = true})
+  test:assertTrue(sdfrasterizer:isSDF(), 'check sdf')
+
 end
 
 
@@ -303,6 +303,14 @@ love.test.graphics.Font = function(test)
   test:assertEquals(8, #wrappedtext, 'check wrapped lines')
   test:assertEquals('LÖVE is an ', wrappedtext[1], 'check wrapped line')
 
+  -- check repeated text gives the same (cached) results
+  local width2, wrappedtext2 = font:getWrap('LÖVE is an *awesome* framework you can use to make 2D games in Lua.', 50)
+  test:assertEquals(width, width2, 'check cached wrap width')
+  test:assertEquals(#wrappedtext, #wrappedtext2, 'check cached wrapped lines')
+  local wrapwidth = font:getWrap('LÖVE is an *awesome* framework you can use to make 2D games in Lua.', 100)
+  test:assertTrue(wrapwidth > width, 'check wrap limit is part of cached key')
+  test:assertEquals(24, font:getWidth('test'), 'check cached width')
+
   -- check drawing font 
   local canvas = love.graphics.newCanvas(16, 16)
   love.graphics.setCanvas(canvas)
@@ -312,6 +320,51 @@ love.test.graphics.Font = function(test)
   local imgdata = love.graphics.readbackTexture(canvas)
   test:compareImg(imgdata)
 
+  -- check sdf fonts
+  test:assertFalse(font:isSDF(), 'check not sdf')
+  local sdffont = love.graphics.newFont('resources/font.ttf', 32, {sdf = true})
+  test:assertTrue(sdffont:isSDF(), 'check sdf')
+  test:assertEquals('linear', sdffont:getFilter(), 'check sdf filter')
+  local ok = pcall(font.setFallbacks, font, sdffont)
+  test:assertFalse(ok, 'check sdf fallback mismatch')
+  love.graphics.setCanvas(canvas)
+    love.graphics.print({{1, 1, 1, 1}, 'Aa'}, sdffont, 0, 0, 0, 0.25, 0.25)
+  love.graphics.setCanvas()
+
+  -- check atlas stats
+  local stats = font:getAtlasStats()
+  test:assertEquals(1, stats.textures, 'check atlas textures')
+  test:assertTrue(stats.glyphs >= 2, 'check atlas glyphs')
+  test:assertTrue(stats.occupancy > 0 and stats.occupancy < 1, 'check atlas occupancy')
+  test:assertEquals(0, stats.evictions, 'check atlas evictions')
+
+  -- check a TextBatch drawn every frame keeps its glyphs while a full atlas
+  -- evicts other glyphs
+  local bigfont = love.graphics.newFont(512)
+  local live = love.graphics.newTextBatch(bigfont, 'Ab')
+  local livecanvas = love.graphics.newCanvas(720, 720)
+  local function drawLive()
+    love.graphics.setCanvas(livecanvas)
+      love.graphics.clear(0, 0, 0, 0)
+      love.graphics.draw(live, 0, 0)
+    love.graphics.setCanvas()
+  end
+  drawLive()
+  local liveimg = love.graphics.readbackTexture(livecanvas):getString()
+  local filler = love.graphics.newTextBatch(bigfont)
+  local codepoint = 0x21
+  while bigfont:getAtlasStats().evictions == 0 and codepoint < 0x530 do
+    for _=1,16 do
+      filler:set(require('utf8').char(codepoint))
+      codepoint = codepoint + 1
+    end
+    drawLive()
+    test:waitFrames(1)
+  end
+  test:assertGreaterEqual(1, bigfont:getAtlasStats().evictions, 'check full atlas evicts glyphs')
+  drawLive()
+  test:assertEquals(liveimg, love.graphics.readbackTexture(livecanvas):getString(), 'check live text batch still draws')
+
   -- check font substitution
   local fontab = love.graphics.newImageFont('resources/font-letters-ab.png', 'AB')
   local fontcd = love.graphics.newImageFont('resources/font-letters-cd.png', 'CD')
@@ -427,6 +480,29 @@ love.test.graphics.Image = function(test)
   test:assertEquals(3, r1+g1+b1, 'check back to white')
   test:compareImg(imgdata)
 
+  -- check async pixel replacement
+  test:assertFalse(image:hasPendingUploads(), 'check no pending uploads')
+  local solid = love.image.newImageData(rimage:getWidth(), rimage:getHeight(), rimage:getFormat())
+  solid:mapPixel(function() return 1, 0, 0, 1 end)
+  image:replacePixels(solid)
+  image:replacePixelsAsync(rimage)
+  test:assertTrue(image:hasPendingUploads(), 'check pending upload')
+  local ok = pcall(image.replacePixelsAsync, image, rimage, nil, 1, 32, 32)
+  test:assertFalse(ok, 'check async upload is validated when queued')
+  -- queued uploads are processed when the frame is presented
+  test:waitFrames(1)
+  test:assertFalse(image:hasPendingUploads(), 'check async upload processed')
+  local uploaded = love.graphics.readbackTexture(image)
+  test:assertEquals(rimage:getString(), uploaded:getString(), 'check async upload pixels')
+
+  -- check async texture creation
+  local asyncimage = love.graphics.newTexture(rimage, {async = true})
+  test:assertObject(asyncimage)
+  test:assertTrue(asyncimage:hasPendingUploads(), 'check async texture upload pending')
+  test:assertEquals(rimage:getWidth(), asyncimage:getPixelWidth(), 'check async texture width')
+  test:waitFrames(1)
+  test:assertFalse(asyncimage:hasPendingUploads(), 'check async texture uploaded')
+
 end
 
 
@@ -527,6 +603,23 @@ love.test.graphics.Mesh = function(test)
   test:assertEquals(4, #vmap2, 'check set map len')
   test:assertEquals(2, vmap2[3], 'check set map val')
 
+  -- check copying scattered vertex ranges from data
+  local mesh3 = love.graphics.newMesh({
+    { name = 'VertexPosition', format = 'floatvec2', location = 0 }
+  }, 8, 'points')
+  local values = {}
+  for i=1,16 do values[i] = i end
+  local posdata = love.data.newByteData(love.data.pack('string', string.rep('f', 16), unpack(values)))
+  mesh3:setVertices(posdata, 1, {{2, 1}, {6, 2}})
+  test:assertEquals(0, mesh3:getVertex(1), 'check untouched vertex')
+  test:assertEquals(3, mesh3:getVertex(2), 'check copied vertex 1')
+  test:assertEquals(11, mesh3:getVertex(6), 'check copied vertex 2')
+  test:assertEquals(14, select(2, mesh3:getVertex(7)), 'check copied vertex 3')
+  test:assertEquals(0, mesh3:getVertex(8), 'check untouched vertex 2')
+  mesh3:flush()
+  local ok = pcall(mesh3.setVertices, mesh3, posdata, 5, {{7, 8}})
+  test:assertFalse(ok, 'check range outside of data')
+
   -- check using custom attributes
   local mesh2 = love.graphics.newMesh({
     { name = 'VertexPosition', format = 'floatvec2', location = 0},
@@ -594,6 +687,79 @@ love.test.graphics.ParticleSystem = function(test)
   psystem:reset()
   test:assertEquals(0, psystem:getCount(), 'check reset')
 
+  -- check dead particles are removed while the rest are kept
+  psystem:setParticleLifetime(1)
+  psystem:emit(5)
+  psystem:setParticleLifetime(3)
+  psystem:emit(5)
+  psystem:update(2)
+  test:assertEquals(5, psystem:getCount(), 'check expired particles removed')
+  psystem:reset()
+
+  -- check random seed
+  psystem:setRandomSeed(42)
+  local low, high = psystem:getRandomSeed()
+  test:assertEquals(42, low, 'check seed low')
+  test:assertEquals(0, high, 'check seed high')
+
+  -- check insert modes control the draw order
+  local white = love.image.newImageData(1, 1)
+  white:setPixel(0, 0, 1, 1, 1, 1)
+  local ordered = love.graphics.newParticleSystem(love.graphics.newImage(white), 10)
+  ordered:setParticleLifetime(10)
+  ordered:setPosition(0.5, 0.5)
+  local drawOrdered = function(mode)
+    ordered:reset()
+    ordered:setInsertMode(mode)
+    ordered:setColors(1, 0, 0, 1)
+    ordered:emit(1)
+    ordered:setColors(0, 1, 0, 1)
+    ordered:emit(1)
+    local ordercanvas = love.graphics.newCanvas(1, 1)
+    love.graphics.setCanvas(ordercanvas)
+      love.graphics.clear(0, 0, 0, 1)
+      love.graphics.draw(ordered)
+    love.graphics.setCanvas()
+    return love.graphics.readbackTexture(ordercanvas):getPixel(0, 0)
+  end
+  local r, g = drawOrdered('top')
+  test:assertEquals(1, g, 'check top inserts newest particle above')
+  r, g = drawOrdered('bottom')
+  test:assertEquals(1, r, 'check bottom inserts newest particle below')
+
+  -- check simulation modes
+  test:assertEquals('cpu', ordered:getSimulationMode(), 'check def simulation mode')
+  if love.graphics.getSupported().glsl4 and love.graphics.getSupported().indirectdraw then
+    local simulated = function(mode)
+      local sim = love.graphics.newParticleSystem(love.graphics.newImage(white), 10)
+      sim:setSimulationMode(mode)
+      sim:setRandomSeed(7)
+      sim:setParticleLifetime(1, 3)
+      sim:setPosition(2.5, 2.5)
+      sim:setColors(1, 0, 1, 1)
+      sim:emit(10)
+      sim:update(1.5)
+      local simcanvas = love.graphics.newCanvas(4, 4)
+      love.graphics.setCanvas(simcanvas)
+        love.graphics.clear(0, 0, 0, 1)
+        love.graphics.draw(sim)
+      love.graphics.setCanvas()
+      return sim:getCount(), love.graphics.readbackTexture(simcanvas)
+    end
+    local cpucount, cpuimg = simulated('cpu')
+    local gpucount, gpuimg = simulated('gpu')
+    test:assertEquals(cpucount, gpucount, 'check gpu particle count')
+    local cr, cg, cb = cpuimg:getPixel(2, 2)
+    local gr, gg, gb = gpuimg:getPixel(2, 2)
+    test:assertRange(gr, cr - 0.01, cr + 0.01, 'check gpu particle color r')
+    test:assertRange(gb, cb - 0.01, cb + 0.01, 'check gpu particle color b')
+    local gpusystem = love.graphics.newParticleSystem(love.graphics.newImage(white), 10)
+    gpusystem:setSimulationMode('gpu')
+    test:assertEquals('gpu', gpusystem:getSimulationMode(), 'check set simulation mode')
+    local ok = pcall(gpusystem.setQuads, gpusystem, love.graphics.newQuad(0, 0, 1, 1, 1, 1))
+    test:assertFalse(ok, 'check quads not allowed in gpu mode')
+  end
+
   -- check setting colors
   local colors1 = {psystem:getColors()}
   test:assertEquals(1, #colors1, 'check 1 color by def')
@@ -1129,6 +1295,60 @@ love.test.graphics.SpriteBatch = function(test)
   local imgdata5 = love.graphics.readbackTexture(canvas)
   test:compareImg(imgdata5)
 
+  -- check bulk adds match individual adds
+  local bulkcanvas = love.graphics.newCanvas(64, 64)
+  local drawBatch = function(batch)
+    love.graphics.setCanvas(bulkcanvas)
+      love.graphics.clear(0, 0, 0, 1)
+      love.graphics.draw(batch, 0, 0)
+    love.graphics.setCanvas()
+    return love.graphics.readbackTexture(bulkcanvas):getString()
+  end
+  local single = love.graphics.newSpriteBatch(texture2, 4)
+  single:add(quad1, 10, 10, 0, 4, 4)
+  single:add(10, 30, 0, 0.25, 0.25, 16, 16)
+  single:add(quad2, 40, 40, 0, 8, 2, 1, 1)
+  local bulk = love.graphics.newSpriteBatch(texture2, 1)
+  local first = bulk:addMany({
+    10, 10, 0, 4, 4, 0, 0, 1,
+    10, 30, 0, 0.25, 0.25, 16, 16, 0
+  }, {quad1})
+  test:assertEquals(1, first, 'check addMany first index')
+  local transform = love.data.newByteData(32)
+  local values = {40, 40, 0, 8, 2, 1, 1, 1}
+  for i=1,8 do
+    transform:setFloat((i-1)*4, values[i])
+  end
+  test:assertEquals(3, bulk:addMany(transform, {quad2}), 'check addMany data index')
+  test:assertEquals(3, bulk:getCount(), 'check addMany count')
+  test:assertEquals(drawBatch(single), drawBatch(bulk), 'check addMany matches add')
+  single:set(2, quad2, 20, 20, 0, 3, 3)
+  bulk:setMany(2, {20, 20, 0, 3, 3, 0, 0, 1}, {quad2})
+  test:assertEquals(drawBatch(single), drawBatch(bulk), 'check setMany matches set')
+  local ok = pcall(bulk.addMany, bulk, {0, 0, 0, 1, 1, 0, 0, 2}, {quad1})
+  test:assertFalse(ok, 'check invalid quad index errors')
+
+  -- check instanced batches draw the same as regular ones
+  local instbatch = love.graphics.newSpriteBatch(texture2, 1, nil, true)
+  test:assertTrue(instbatch:isInstanced(), 'check instanced')
+  test:assertFalse(single:isInstanced(), 'check not instanced by def')
+  instbatch:add(quad1, 10, 10, 0, 4, 4)
+  instbatch:addMany({10, 30, 0, 0.25, 0.25, 16, 16, 0}, {})
+  instbatch:add(quad2, 40, 40, 0, 8, 2, 1, 1)
+  instbatch:set(2, quad2, 20, 20, 0, 3, 3)
+  test:assertEquals(3, instbatch:getCount(), 'check instanced count')
+  test:assertEquals(drawBatch(single), drawBatch(instbatch), 'check instanced matches regular')
+
+  -- shaders which don't place instances can't draw instanced batches
+  local pixelonly = love.graphics.newShader[[
+    vec4 effect(vec4 c, Image t, vec2 tc, vec2 sc) { return Texel(t, tc) * c; }
+  ]]
+  love.graphics.setShader(pixelonly)
+  local drawok = pcall(love.graphics.draw, instbatch)
+  love.graphics.setShader()
+  test:assertFalse(drawok, 'check instanced draw with pixel-only shader errors')
+  test:assertTrue(pcall(love.graphics.draw, single), 'check regular draw still works')
+
 end
 
 
@@ -1156,6 +1376,21 @@ love.test.graphics.Text = function(test)
   plaintext:clear()
   test:assertEquals(0, plaintext:getDimensions(), 'check clearing text')
 
+  -- check updating and removing individual entries
+  local first = plaintext:add('test', 0, 0)
+  local second = plaintext:add('more text', 0, 10)
+  test:assertEquals(2, plaintext:getTextCount(), 'check text count')
+  plaintext:setAt(first, 'much longer test text')
+  test:assertTrue(plaintext:getWidth(first) > 24, 'check setAt width')
+  plaintext:setAt(first, 'test')
+  test:assertEquals(24, plaintext:getWidth(first), 'check setAt shorter text')
+  plaintext:remove(first)
+  test:assertEquals(1, plaintext:getTextCount(), 'check removing text')
+  test:assertEquals(font:getWidth('more text'), plaintext:getWidth(1), 'check remaining text')
+  local ok = pcall(plaintext.setAt, plaintext, second, 'test')
+  test:assertFalse(ok, 'check invalid setAt index')
+  plaintext:clear()
+
   -- check drawing + setting more complex text
   local colortext = love.graphics.newTextBatch(font, {{1, 0, 0, 1}, 'test'})
   test:assertObject(colortext)
@@ -1295,6 +1530,40 @@ love.test.graphics.arc = function(test)
 end
 
 
+-- love.graphics.beginBatchScope
+love.test.graphics.beginBatchScope = function(test)
+  local red = love.image.newImageData(1, 1)
+  red:setPixel(0, 0, 1, 0, 0, 1)
+  local green = love.image.newImageData(1, 1)
+  green:setPixel(0, 0, 0, 1, 0, 1)
+  local images = { love.graphics.newImage(red), love.graphics.newImage(green) }
+  local canvas = love.graphics.newCanvas(8, 1)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.flushBatch()
+    local before = love.graphics.getStats().drawcalls
+    love.graphics.beginBatchScope('sorted')
+    for x=0,7 do
+      love.graphics.draw(images[x % 2 + 1], x, 0)
+    end
+    love.graphics.endBatchScope()
+    local after = love.graphics.getStats().drawcalls
+  love.graphics.setCanvas()
+  test:assertEquals(before + 2, after, 'check interleaved textures are sorted into two draws')
+  local imgdata = love.graphics.readbackTexture(canvas)
+  for x=0,7 do
+    local r, g, b, a = imgdata:getPixel(x, 0)
+    test:assertEquals(x % 2 == 0 and 1 or 0, r, 'check red channel at ' .. x)
+    test:assertEquals(x % 2 == 1 and 1 or 0, g, 'check green channel at ' .. x)
+  end
+  -- scopes can't be nested
+  love.graphics.beginBatchScope()
+  local ok = pcall(love.graphics.beginBatchScope)
+  love.graphics.endBatchScope()
+  test:assertFalse(ok, 'check nested scope errors')
+end
+
+
 -- love.graphics.circle
 love.test.graphics.circle = function(test)
   -- draw some circles
@@ -1420,6 +1689,31 @@ love.test.graphics.ellipse = function(test)
 end
 
 
+-- love.graphics.endBatchScope
+love.test.graphics.endBatchScope = function(test)
+  local ok = pcall(love.graphics.endBatchScope)
+  test:assertFalse(ok, 'check ending without a scope errors')
+  -- lower layers are drawn first, regardless of draw order
+  local canvas = love.graphics.newCanvas(1, 1)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.beginBatchScope()
+    love.graphics.setBatchLayer(1)
+    love.graphics.setColor(0, 0, 1, 1)
+    love.graphics.rectangle('fill', 0, 0, 1, 1)
+    love.graphics.setBatchLayer(0)
+    love.graphics.setColor(1, 0, 0, 1)
+    love.graphics.rectangle('fill', 0, 0, 1, 1)
+    love.graphics.endBatchScope()
+    love.graphics.setColor(1, 1, 1, 1)
+  love.graphics.setCanvas()
+  local r, g, b, a = love.graphics.readbackTexture(canvas):getPixel(0, 0)
+  test:assertEquals(0, r, 'check layer 0 drawn first')
+  test:assertEquals(1, b, 'check layer 1 drawn last')
+  test:assertFalse(love.graphics.isBatchScopeActive(), 'check scope ended')
+end
+
+
 -- love.graphics.flushBatch
 love.test.graphics.flushBatch = function(test)
   love.graphics.flushBatch()
@@ -1553,6 +1847,49 @@ love.test.graphics.rectangle = function(test)
 end
 
 
+-- love.graphics.updateParticleSystems
+love.test.graphics.updateParticleSystems = function(test)
+  local white = love.image.newImageData(1, 1)
+  white:setPixel(0, 0, 1, 1, 1, 1)
+  local image = love.graphics.newImage(white)
+  local systems = {}
+  for i=1,4 do
+    local psystem = love.graphics.newParticleSystem(image, 100)
+    psystem:setParticleLifetime(1, 2)
+    psystem:setEmissionRate(50)
+    psystem:setSpeed(5, 10)
+    psystem:setSpread(math.pi * 2)
+    psystem:setPosition(16, 16)
+    psystem:setRandomSeed(1234)
+    systems[i] = psystem
+  end
+  -- a system updated on its own should match one updated with the others
+  local single = systems[1]:clone()
+  single:setRandomSeed(1234)
+  for i=1,10 do
+    love.graphics.updateParticleSystems(systems, 0.1)
+    single:update(0.1)
+  end
+  test:assertGreaterEqual(1, systems[1]:getCount(), 'check particles emitted')
+  for i=2,4 do
+    test:assertEquals(systems[1]:getCount(), systems[i]:getCount(), 'check same count ' .. i)
+  end
+  local render = function(psystem)
+    local canvas = love.graphics.newCanvas(32, 32)
+    love.graphics.setCanvas(canvas)
+      love.graphics.clear(0, 0, 0, 1)
+      love.graphics.draw(psystem)
+    love.graphics.setCanvas()
+    return love.graphics.readbackTexture(canvas):getString()
+  end
+  test:assertEquals(render(single), render(systems[1]), 'check deterministic result')
+  test:assertEquals(render(systems[1]), render(systems[4]), 'check same seed same result')
+  -- each system can only be listed once
+  local ok = pcall(love.graphics.updateParticleSystems, { systems[1], systems[1] }, 0.1)
+  test:assertFalse(ok, 'check duplicate systems error')
+end
+
+
 --------------------------------------------------------------------------------
 --------------------------------------------------------------------------------
 --------------------------------OBJECT CREATION---------------------------------
@@ -1671,6 +2008,65 @@ love.test.graphics.newQuad = function(test)
 end
 
 
+-- love.graphics.newReadbackRing
+love.test.graphics.newReadbackRing = function(test)
+  local ring = love.graphics.newReadbackRing(2)
+  test:assertObject(ring)
+  test:assertEquals(2, ring:getSize(), 'check size')
+  test:assertEquals(0, ring:getPendingCount(), 'check no pending')
+  test:assertEquals(nil, ring:pop(), 'check nothing completed')
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(1, 0, 0, 1)
+  love.graphics.setCanvas()
+  -- completed readbacks are collected when frames are presented
+  local waitForReadbacks = function()
+    for _=1,10 do
+      if ring:getPendingCount() == 0 then break end
+      test:waitFrames(1)
+    end
+    test:assertEquals(0, ring:getPendingCount(), 'check readbacks completed')
+  end
+  test:assertTrue(ring:readbackTexture(canvas), 'check first readback')
+  test:assertTrue(ring:readbackTexture(canvas, 1, 1, 0, 0, 8, 8), 'check second readback')
+  waitForReadbacks()
+  local first = ring:pop()
+  test:assertObject(first)
+  test:assertEquals(16, first:getWidth(), 'check first readback popped first')
+  local r, g = first:getPixel(0, 0)
+  test:assertEquals(1, r, 'check readback r')
+  test:assertEquals(0, g, 'check readback g')
+  local second = ring:pop()
+  test:assertObject(second)
+  test:assertEquals(8, second:getWidth(), 'check second readback popped second')
+  test:assertEquals(nil, ring:pop(), 'check all popped')
+  -- completed data is delivered to the channel in order instead of pop
+  local channel = love.thread.newChannel()
+  ring:setChannel(channel)
+  test:assertEquals(channel, ring:getChannel(), 'check channel')
+  test:assertTrue(ring:readbackTexture(canvas), 'check first channel readback')
+  test:assertTrue(ring:readbackTexture(canvas, 1, 1, 0, 0, 4, 4), 'check second channel readback')
+  waitForReadbacks()
+  test:assertEquals(nil, ring:pop(), 'check channel data is not popped')
+  test:assertEquals(2, channel:getCount(), 'check channel count')
+  local pushed1 = channel:pop()
+  local pushed2 = channel:pop()
+  test:assertEquals(16, pushed1:getWidth(), 'check first channel readback')
+  test:assertEquals(4, pushed2:getWidth(), 'check second channel readback')
+  -- slots don't reuse data they pushed to the channel
+  test:assertTrue(ring:readbackTexture(canvas), 'check third channel readback')
+  waitForReadbacks()
+  local pushed3 = channel:pop()
+  test:assertObject(pushed3)
+  test:assertNotEquals(pushed1, pushed3, 'check channel data is not reused')
+  test:assertEquals(1, pushed1:getPixel(0, 0), 'check channel data is unchanged')
+  ring:setChannel(nil)
+  test:assertEquals(nil, ring:getChannel(), 'check no channel')
+  local ok = pcall(love.graphics.newReadbackRing, 0)
+  test:assertFalse(ok, 'check invalid size')
+end
+
+
 -- love.graphics.newShader
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.newShader = function(test)
@@ -1689,6 +2085,43 @@ love.test.graphics.newShader = function(test)
 end
 
 
+-- love.graphics.newShaderAsync
+love.test.graphics.newShaderAsync = function(test)
+  local pixelcode = [[
+    vec4 effect(vec4 color, Image tex, vec2 texture_coords, vec2 screen_coords) {
+      return vec4(1.0, 0.0, 0.0, 1.0);
+    }
+  ]]
+  local fallback = love.graphics.newShader(pixelcode)
+  local async = love.graphics.newShaderAsync(pixelcode, {fallback = fallback})
+  test:assertEquals('AsyncShader', async:type(), 'check type')
+  test:assertEquals(fallback, async:getFallback(), 'check fallback')
+  -- draws use the fallback until the shader is ready
+  love.graphics.setShader(async)
+  if not async:isReady() then
+    test:assertEquals(fallback, love.graphics.getShader(), 'check fallback is active')
+    test:assertEquals(nil, async:getShader(), 'check not ready')
+  end
+  love.graphics.setShader()
+  local shader = async:wait()
+  test:assertTrue(async:isReady(), 'check ready')
+  test:assertEquals(shader, async:getShader(), 'check compiled shader')
+  test:assertEquals(nil, async:getError(), 'check no error')
+  love.graphics.setShader(async)
+  test:assertEquals(shader, love.graphics.getShader(), 'check compiled shader is active')
+  love.graphics.setShader()
+  -- compile errors are raised by wait
+  local bad = love.graphics.newShaderAsync([[
+    vec4 effect(vec4 color, Image tex, vec2 texture_coords, vec2 screen_coords) {
+      return undefinedvariable;
+    }
+  ]])
+  local ok = pcall(bad.wait, bad)
+  test:assertFalse(ok, 'check compile error')
+  test:assertNotNil(bad:getError())
+end
+
+
 -- love.graphics.newSpriteBatch
 -- @NOTE this is just basic nil checking, objs have their own test method
 love.test.graphics.newSpriteBatch = function(test)
@@ -1783,6 +2216,12 @@ love.test.graphics.getBackgroundColor = function(test)
 end
 
 
+-- love.graphics.getBatchLayer
+love.test.graphics.getBatchLayer = function(test)
+  test:assertEquals(0, love.graphics.getBatchLayer(), 'check default layer')
+end
+
+
 -- love.graphics.getBlendMode
 love.test.graphics.getBlendMode = function(test)
   -- check default blend mode
@@ -2027,6 +2466,15 @@ love.test.graphics.isActive = function(test)
 end
 
 
+-- love.graphics.isBatchScopeActive
+love.test.graphics.isBatchScopeActive = function(test)
+  test:assertFalse(love.graphics.isBatchScopeActive(), 'check inactive by default')
+  love.graphics.beginBatchScope()
+  test:assertTrue(love.graphics.isBatchScopeActive(), 'check active')
+  love.graphics.endBatchScope()
+end
+
+
 -- love.graphics.isGammaCorrect
 love.test.graphics.isGammaCorrect = function(test)
   -- we know the config so know this is false
@@ -2034,6 +2482,15 @@ love.test.graphics.isGammaCorrect = function(test)
 end
 
 
+-- love.graphics.isMultiTextureBatching
+love.test.graphics.isMultiTextureBatching = function(test)
+  test:assertFalse(love.graphics.isMultiTextureBatching(), 'check disabled by default')
+  love.graphics.setMultiTextureBatching(true)
+  test:assertTrue(love.graphics.isMultiTextureBatching(), 'check enabled')
+  love.graphics.setMultiTextureBatching(false) -- reset
+end
+
+
 -- love.graphics.isWireframe
 love.test.graphics.isWireframe = function(test)
   local name, version, vendor, device = love.graphics.getRendererInfo()
@@ -2083,6 +2540,16 @@ love.test.graphics.setBackgroundColor = function(test)
 end
 
 
+-- love.graphics.setBatchLayer
+love.test.graphics.setBatchLayer = function(test)
+  love.graphics.setBatchLayer(-3)
+  test:assertEquals(-3, love.graphics.getBatchLayer(), 'check layer set')
+  local ok = pcall(love.graphics.setBatchLayer, 100000)
+  test:assertFalse(ok, 'check out of range layer errors')
+  love.graphics.setBatchLayer(0)
+end
+
+
 -- love.graphics.setBlendMode
 love.test.graphics.setBlendMode = function(test)
   -- create fully white canvas, then draw diff. pixels through blendmodes
@@ -2420,6 +2887,36 @@ love.test.graphics.setStencilState = function(test)
 end
 
 
+-- love.graphics.setMultiTextureBatching
+love.test.graphics.setMultiTextureBatching = function(test)
+  local red = love.image.newImageData(1, 1)
+  red:setPixel(0, 0, 1, 0, 0, 1)
+  local green = love.image.newImageData(1, 1)
+  green:setPixel(0, 0, 0, 1, 0, 1)
+  local images = { love.graphics.newImage(red), love.graphics.newImage(green) }
+  local canvas = love.graphics.newCanvas(4, 1)
+  love.graphics.setMultiTextureBatching(true)
+  love.graphics.setCanvas(canvas)
+    love.graphics.clear(0, 0, 0, 1)
+    love.graphics.flushBatch()
+    local before = love.graphics.getStats().drawcalls
+    for x=0,3 do
+      love.graphics.draw(images[x % 2 + 1], x, 0)
+    end
+    love.graphics.flushBatch()
+    local after = love.graphics.getStats().drawcalls
+  love.graphics.setCanvas()
+  love.graphics.setMultiTextureBatching(false)
+  test:assertEquals(before + 1, after, 'check different textures share one draw')
+  local imgdata = love.graphics.readbackTexture(canvas)
+  for x=0,3 do
+    local r, g, b, a = imgdata:getPixel(x, 0)
+    test:assertEquals(x % 2 == 0 and 1 or 0, r, 'check red channel at ' .. x)
+    test:assertEquals(x % 2 == 1 and 1 or 0, g, 'check green channel at ' .. x)
+  end
+end
+
+
 -- love.graphics.setWireframe
 love.test.graphics.setWireframe = function(test)
   local name, version, vendor, device = love.graphics.getRendererInfo()
@@ -2785,17 +3282,67 @@ love.test.graphics.getRendererInfo = function(test)
 end
 
 
+-- love.graphics.getFrameTimings
+-- @NOTE timings are hardware dependent so only the structure is checked
+love.test.graphics.getFrameTimings = function(test)
+  test:assertFalse(love.graphics.isFrameTimingEnabled(), 'check disabled by default')
+  love.graphics.setFrameTimingEnabled(true)
+  test:assertTrue(love.graphics.isFrameTimingEnabled(), 'check enabled')
+  -- record a user scope in every frame, results can lag behind a few frames
+  for f=1,8 do
+    love.graphics.pushTimingScope('testscope')
+      love.graphics.rectangle('fill', 0, 0, 1, 1)
+      love.graphics.flushBatch()
+    love.graphics.popTimingScope()
+    test:waitFrames(1)
+  end
+  local ok = pcall(love.graphics.popTimingScope)
+  test:assertFalse(ok, 'check unmatched pop errors')
+  local timings = love.graphics.getFrameTimings()
+  love.graphics.setFrameTimingEnabled(false)
+  test:assertNotNil(timings)
+  test:assertEquals('frame', timings.name, 'check root scope')
+  test:assertTrue(timings.cputime >= 0, 'check root cpu time')
+  local scope = nil
+  for c=1,#timings.children do
+    if timings.children[c].name == 'testscope' then scope = timings.children[c] end
+  end
+  test:assertNotNil(scope)
+  test:assertEquals(1, scope.calls, 'check scope calls')
+  test:assertTrue(scope.cputime <= timings.cputime, 'check scope within frame')
+  local flushed = false
+  for c=1,#scope.children do
+    if scope.children[c].name == 'flushBatchedDraws' then flushed = true end
+  end
+  test:assertTrue(flushed, 'check nested internal scope')
+end
+
+
 -- love.graphics.getStats
 -- @NOTE cant really predict some of these so just nil check for most
 love.test.graphics.getStats = function(test)
   local stattypes = {
     'drawcalls', 'canvasswitches', 'texturememory', 'shaderswitches',
-    'drawcallsbatched', 'textures', 'fonts'
+    'drawcallsbatched', 'drawcallsbatcheduint32', 'textures', 'fonts'
   }
   local stats = love.graphics.getStats()
   for s=1,#stattypes do
     test:assertNotEquals(nil, stats[stattypes[s] ], 'expected a key for stat: ' .. stattypes[s])
   end
+  -- batches past 65535 vertices should switch to uint32 indices, not flush
+  local canvas = love.graphics.newCanvas(16, 16)
+  love.graphics.setCanvas(canvas)
+    local before = love.graphics.getStats()
+    for r=1,2 do
+      love.graphics.flushBatch()
+      for i=1,17000 do
+        love.graphics.rectangle('fill', 0, 0, 1, 1)
+      end
+    end
+    love.graphics.flushBatch()
+    local after = love.graphics.getStats()
+  love.graphics.setCanvas()
+  test:assertTrue(after.drawcallsbatcheduint32 > before.drawcallsbatcheduint32, 'check large batch used uint32 indices')
 end
 
 
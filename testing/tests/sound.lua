@@ -116,3 +116,19 @@ love.test.sound.newSoundData = function(test)
   test:assertObject(love.sound.newSoundData('resources/click.ogg'))
   test:assertObject(love.sound.newSoundData(math.floor((1/32)*44100), 44100, 16, 1))
 end
+
+
+-- love.sound.newSoundDataBatch
+love.test.sound.newSoundDataBatch = function(test)
+  local decoder = love.sound.newDecoder('resources/clickmono.ogg')
+  local batch = love.sound.newSoundDataBatch({'resources/click.ogg', decoder})
+  test:assertEquals(2, #batch, 'check batch size')
+  for i=1,#batch do
+    test:assertObject(batch[i])
+  end
+  local single = love.sound.newSoundData('resources/click.ogg')
+  test:assertEquals(single:getSampleCount(), batch[1]:getSampleCount(), 'check batch sample count')
+  test:assertEquals(2, batch[1]:getChannelCount(), 'check batch stereo channels')
+  test:assertEquals(1, batch[2]:getChannelCount(), 'check batch mono channels')
+  test:assertEquals(0, #love.sound.newSoundDataBatch({}), 'check empty batch')
+end